@@ -436,6 +436,10 @@ typedef PyObject *(*allocfunc)(PyTypeObject *, Py_ssize_t);
     PY_UINT64_T tp_version_tag;        \
 \
     /* Pyston changes: added these fields */ \
+    /* Number of live instances of exactly this type, and the bytes their \
+       object structs take up; see _Py_INC_LIVE. */ \
+    Py_ssize_t tp_live_count;          \
+    Py_ssize_t tp_live_bytes;          \
 
 
 #ifdef COUNT_ALLOCS
@@ -459,6 +463,7 @@ struct _typeobject {
     void* _hcattrs;
     char _ics[48];
     int _attrs_offset;
+    int _num_inline_attrs;
     char _flags[7]; // These are bools in C++
     void* _tpp_descr_get;
     void* _tpp_hasnext;
@@ -481,6 +486,10 @@ typedef struct _heaptypeobject {
                                       see add_operators() in typeobject.c . */
     PyBufferProcs as_buffer;
     PyObject *ht_name, *ht_slots;
+    // Pyston addition: attribute array presizing state
+    int _attrs_presize;
+    int _attrs_presize_overshoots;
+    int _attrs_presize_window_max;
     /* here are optional user slots, followed by the members. */
 } PyHeapTypeObject;
 
@@ -806,6 +815,20 @@ PyAPI_FUNC(void) dec_count(PyTypeObject *) PYSTON_NOEXCEPT;
 #define _Py_COUNT_ALLOCS_COMMA
 #endif /* COUNT_ALLOCS */
 
+/* Pyston addition: always-on accounting of live objects per type.  An
+ * object is counted from the time it gets its first reference
+ * (_Py_NewReference) until it gets deallocated or forgotten, so objects that
+ * sit in a free list don't count.  The bytes are tp_basicsize plus
+ * tp_itemsize per item; separately allocated buffers (list items, dict
+ * tables, ...) and allocator overhead are not included.
+ */
+#define _Py_LIVE_BYTES(op) (Py_TYPE(op)->tp_basicsize +                 \
+    (Py_TYPE(op)->tp_itemsize ? Py_TYPE(op)->tp_itemsize * Py_SIZE(op) : 0))
+#define _Py_INC_LIVE(op) (Py_TYPE(op)->tp_live_count++,                 \
+                          Py_TYPE(op)->tp_live_bytes += _Py_LIVE_BYTES(op))
+#define _Py_DEC_LIVE(op) (Py_TYPE(op)->tp_live_count--,                 \
+                          Py_TYPE(op)->tp_live_bytes -= _Py_LIVE_BYTES(op))
+
 #ifdef Py_TRACE_REFS
 /* Py_TRACE_REFS is such major surgery that we call external routines. */
 PyAPI_FUNC(void) _Py_NewReference(PyObject *) PYSTON_NOEXCEPT;
@@ -825,22 +848,48 @@ PyAPI_FUNC(void) _Py_PrintReferenceAddressesCapped(FILE *, int) PYSTON_NOEXCEPT;
 #define _Py_NewReference(op) (                          \
     _Py_INC_TPALLOCS(op) _Py_COUNT_ALLOCS_COMMA         \
     _Py_INC_REFTOTAL  _Py_REF_DEBUG_COMMA               \
+    _Py_INC_LIVE(op),                                   \
     Py_REFCNT(op) = 1)
 
-#define _Py_ForgetReference(op) _Py_INC_TPFREES(op)
+#define _Py_ForgetReference(op) (                       \
+    _Py_INC_TPFREES(op) _Py_COUNT_ALLOCS_COMMA          \
+    _Py_DEC_LIVE(op))
 
 #define _Py_Dealloc(op) (                               \
     _Py_INC_TPFREES(op) _Py_COUNT_ALLOCS_COMMA          \
+    _Py_DEC_LIVE(op),                                   \
     (*Py_TYPE(op)->tp_dealloc)((PyObject *)(op)))
 #endif /* !Py_TRACE_REFS */
 
+/* Pyston addition: an out-of-line _Py_Dealloc, for the JITs to call. */
+PyAPI_FUNC(void) _Py_DeallocFunc(PyObject *) PYSTON_NOEXCEPT;
+
+/* Pyston addition: immortal objects.  Objects that live as long as the
+ * runtime and don't hold references to other objects (None, True and False,
+ * the small int cache, immortal interned strings, ...) get a refcount of
+ * _Py_IMMORTAL_REFCNT, and Py_INCREF/Py_DECREF don't write to them.  This
+ * keeps their cache lines clean and their pages shared after a fork.
+ *
+ * Code that doesn't check (extension modules built against older headers,
+ * most JIT-emitted code) still adjusts the refcount of immortal objects.
+ * That's harmless: anything at or above _Py_IMMORTAL_MIN_REFCNT counts as
+ * immortal, which leaves plenty of room for drift in either direction.
+ * _Py_RefTotal is still updated for immortal objects so that it stays
+ * balanced no matter which kind of code did the incref and the decref.
+ */
+#define _Py_IMMORTAL_REFCNT ((Py_ssize_t)1 << 62)
+#define _Py_IMMORTAL_MIN_REFCNT ((Py_ssize_t)1 << 61)
+#define _Py_IsImmortal(op) (((PyObject*)(op))->ob_refcnt >= _Py_IMMORTAL_MIN_REFCNT)
+#define _Py_SetImmortal(op) (Py_REFCNT(op) = _Py_IMMORTAL_REFCNT)
+
 #define Py_INCREF(op) (                         \
     _Py_INC_REFTOTAL  _Py_REF_DEBUG_COMMA       \
-    ((PyObject*)(op))->ob_refcnt++)
+    _Py_IsImmortal(op) ? (void)0 : (void)((PyObject*)(op))->ob_refcnt++)
 
 #define Py_DECREF(op)                                   \
     do {                                                \
         if (_Py_DEC_REFTOTAL  _Py_REF_DEBUG_COMMA       \
+        _Py_IsImmortal(op) ||                           \
         --((PyObject*)(op))->ob_refcnt != 0)            \
             _Py_CHECK_REFCNT(op)                        \
         else                                            \
@@ -100,6 +100,13 @@ PyAPI_FUNC(void *) PyObject_Malloc(size_t) PYSTON_NOEXCEPT;
 PyAPI_FUNC(void *) PyObject_Realloc(void *, size_t) PYSTON_NOEXCEPT;
 PyAPI_FUNC(void) PyObject_Free(void *) PYSTON_NOEXCEPT;
 
+/* Pyston addition: PyObject_Free and PyObject_Realloc hand blocks that came
+   from a per-class slab allocator (runtime/slab.h) back to it.
+   _PySlab_Free returns 0 if p isn't such a block; _PySlab_BlockSize returns
+   its size, or 0. */
+PyAPI_FUNC(int) _PySlab_Free(void *p) PYSTON_NOEXCEPT;
+PyAPI_FUNC(size_t) _PySlab_BlockSize(void *p) PYSTON_NOEXCEPT;
+
 
 /* Macros */
 #ifdef WITH_PYMALLOC
@@ -236,6 +243,21 @@ PyAPI_FUNC(PyVarObject *) _PyObject_NewVar(PyTypeObject *, Py_ssize_t) PYSTON_NO
 /* C equivalent of gc.collect(). */
 PyAPI_FUNC(Py_ssize_t) PyGC_Collect(void) PYSTON_NOEXCEPT;
 
+/* Pyston addition: moves every tracked object into a permanent generation
+   that collections don't look at (gc.freeze()).  If immortalize is nonzero,
+   those objects and everything they refer to are also made immortal, and the
+   number of newly immortal objects is returned; otherwise this returns the
+   size of the permanent generation. */
+PyAPI_FUNC(Py_ssize_t) _PyGC_Freeze(int immortalize) PYSTON_NOEXCEPT;
+
+/* Pyston addition: writes a heap snapshot to path (gc.dump_heap()). */
+PyAPI_FUNC(Py_ssize_t) _PyGC_DumpHeap(const char *path) PYSTON_NOEXCEPT;
+
+/* Pyston addition: like _PyObject_GC_Malloc, but for memory that the caller
+   already allocated, with room for the PyGC_Head at the start.  Returns the
+   object, which is sizeof(PyGC_Head) bytes into mem. */
+PyAPI_FUNC(PyObject *) _PyObject_GC_Init(void *mem) PYSTON_NOEXCEPT;
+
 /* Test if a type has a GC head */
 #define PyType_IS_GC(t) PyType_HasFeature((t), Py_TPFLAGS_HAVE_GC)
 
@@ -256,6 +278,9 @@ typedef union _gc_head {
         union _gc_head *gc_next;
         union _gc_head *gc_prev;
         Py_ssize_t gc_refs;
+        /* Pyston addition: used by incremental collections.  This fits in
+           what used to be padding, so PyGC_Head doesn't get bigger. */
+        Py_ssize_t gc_epoch;
     } gc;
     long double dummy;  /* force worst-case alignment */
 } PyGC_Head;
@@ -275,6 +300,7 @@ extern PyGC_Head * const _PyGC_generation0;
     if (g->gc.gc_refs != _PyGC_REFS_UNTRACKED) \
         Py_FatalError("GC object already tracked"); \
     g->gc.gc_refs = _PyGC_REFS_REACHABLE; \
+    g->gc.gc_epoch = 0; \
     g->gc.gc_next = _PyGC_generation0; \
     g->gc.gc_prev = _PyGC_generation0->gc.gc_prev; \
     g->gc.gc_prev->gc.gc_next = g; \
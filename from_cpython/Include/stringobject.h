@@ -92,6 +92,19 @@ PyAPI_FUNC(void) _Py_ReleaseInternedStrings(void) PYSTON_NOEXCEPT;
 // Pyston addition:
 PyAPI_FUNC(char) PyString_GetItem(PyObject *, Py_ssize_t) PYSTON_NOEXCEPT;
 
+// Pyston addition: vectorized search kernels for byte strings, picked at startup based on what
+// the CPU supports.  The find functions return the offset of the first (last) match or -1;
+// the count functions return at most maxcount.  Defined in src/runtime/str_search.cpp.
+PyAPI_FUNC(Py_ssize_t) _PyString_FindChar(const char *s, Py_ssize_t n, char c) PYSTON_NOEXCEPT;
+PyAPI_FUNC(Py_ssize_t) _PyString_RFindChar(const char *s, Py_ssize_t n, char c) PYSTON_NOEXCEPT;
+PyAPI_FUNC(Py_ssize_t) _PyString_CountChar(const char *s, Py_ssize_t n, char c,
+                                           Py_ssize_t maxcount) PYSTON_NOEXCEPT;
+PyAPI_FUNC(Py_ssize_t) _PyString_FindSubstring(const char *s, Py_ssize_t n,
+                                               const char *p, Py_ssize_t m) PYSTON_NOEXCEPT;
+/* Offset of the first byte that is (is not) whitespace according to Py_ISSPACE, or n. */
+PyAPI_FUNC(Py_ssize_t) _PyString_SpanNonSpace(const char *s, Py_ssize_t n) PYSTON_NOEXCEPT;
+PyAPI_FUNC(Py_ssize_t) _PyString_SpanSpace(const char *s, Py_ssize_t n) PYSTON_NOEXCEPT;
+
 /* Use only if you know it's a string */
 #define PyString_CHECK_INTERNED(op) (((PyStringObject *)(op))->ob_sstate)
 
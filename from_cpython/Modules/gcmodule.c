@@ -21,6 +21,8 @@
 #include "Python.h"
 #include "frameobject.h"        /* for PyFrame_ClearFreeList */
 
+#include <time.h>               /* for clock_gettime */
+
 /* Get an object's GC head */
 #define AS_GC(o) ((PyGC_Head *)(o)-1)
 
@@ -49,6 +51,65 @@ static struct gc_generation generations[NUM_GENERATIONS] = {
 
 PyGC_Head * const _PyGC_generation0 = GEN_HEAD(0);
 
+/* Pyston addition: objects moved here by gc.freeze() are never examined by
+   a collection, so a process forked after the freeze doesn't write to their
+   GC headers (and dirty their pages) when it collects. */
+static PyGC_Head permanent_generation = {{&permanent_generation, &permanent_generation, 0}};
+
+/* gc_epoch of the objects in the permanent generation. */
+#define GC_EPOCH_FROZEN (-1)
+
+/* Pyston addition: incremental collection of the oldest generation.
+
+   When enabled, collections that would have examined the oldest generation
+   are split up into increments ("slices") that run one at a time.  A slice
+   takes the young generations plus some objects from the front of the
+   oldest one, adds (up to a limit) the old objects those reference, and
+   runs the usual collection algorithm on just that set.  The survivors are
+   moved to old_visited, and once nothing is left in the oldest generation,
+   the pass is over and old_visited becomes the oldest generation again.
+
+   The first slice of a pass is triggered like a collection of the oldest
+   generation would have been; after that, slices are paced by allocations:
+   the next one runs once increment_size / INCREMENTAL_PACING GC objects
+   have been allocated since the previous one, so a pass examines old
+   objects faster than the program can promote new ones and always
+   finishes.  In between, the young generations are collected as usual.
+
+   The collection algorithm is sound for any subset of the objects: anything
+   referenced from outside of the subset looks reachable.  So slices need no
+   write barrier or snapshot, and mutations between slices can't cause live
+   objects to be freed.  The price is that a garbage cycle is only found if
+   it ends up entirely within one slice; pulling in the referents of the
+   seed objects takes care of that for all but very large cycles.  Those
+   are left for a full collection, which takes the place of every
+   INCREMENTAL_FULL_INTERVAL'th pass.
+
+   gc_epoch tells which objects have already been added to a slice during
+   the current pass (see visit_increment()).
+*/
+static int incremental = 0;
+static Py_ssize_t incremental_budget_us = 5000; /* target pause per slice */
+static Py_ssize_t increment_size = 20000; /* objects per slice, adapted to the budget */
+static Py_ssize_t incremental_epoch = 1;
+static int incremental_pass_active = 0;
+static Py_ssize_t allocs_since_slice = 0; /* GC objects allocated since the last slice */
+static int passes_since_full = 0; /* incremental passes finished since the last full collection */
+static PyGC_Head old_visited = {{&old_visited, &old_visited, 0}};
+static Py_ssize_t old_visited_count = 0;
+
+#define MIN_INCREMENT_SIZE 1000
+#define INCREMENTAL_PACING 2 /* old objects examined per allocation during a pass */
+#define INCREMENTAL_FULL_INTERVAL 4
+#define MAX_INCREMENT_SIZE 10000000
+
+/* Pyston addition: histograms of collection pause times.  Bucket i counts
+   the pauses that took at least 2**(i-1) and less than 2**i microseconds;
+   the last bucket also counts everything longer.  There is one histogram
+   per generation plus one for incremental slices. */
+#define PAUSE_BUCKETS 24
+static Py_ssize_t pause_histogram[NUM_GENERATIONS + 1][PAUSE_BUCKETS];
+
 static int enabled = 1; /* automatic collection enabled? */
 
 /* true if we are currently running the collector */
@@ -298,6 +359,37 @@ gc_list_size(PyGC_Head *list)
     return n;
 }
 
+/* Put the objects that survived slices of the current incremental pass
+   back into the oldest generation.  This abandons the pass; the next one
+   starts from scratch. */
+static void
+end_incremental_pass(void)
+{
+    gc_list_merge(&old_visited, GEN_HEAD(NUM_GENERATIONS - 1));
+    old_visited_count = 0;
+    incremental_pass_active = 0;
+    incremental_epoch++;
+}
+
+static Py_ssize_t
+monotonic_us(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (Py_ssize_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+static void
+record_pause(int histogram, Py_ssize_t us)
+{
+    int bucket = 0;
+    while (us > 0 && bucket < PAUSE_BUCKETS - 1) {
+        us >>= 1;
+        bucket++;
+    }
+    pause_histogram[histogram][bucket]++;
+}
+
 /* Append objects in a GC list to a Python list.
  * Return 0 if all OK, < 0 if error (out of memory for list).
  */
@@ -899,6 +991,9 @@ _PyGC_FindLeaks(PyObject** also)
     PyGC_Head *young; /* the generation we are examining */
     int generation = NUM_GENERATIONS - 1;
 
+    if (incremental_pass_active)
+        end_incremental_pass();
+
     /* merge younger generations with one we are currently collecting */
     for (i = 0; i < generation; i++) {
         gc_list_merge(GEN_HEAD(i), GEN_HEAD(generation));
@@ -950,20 +1045,20 @@ _PyGC_FindLeaks(PyObject** also)
 }
 #endif
 
+static Py_ssize_t collect_set(int generation, PyGC_Head *young,
+                              PyGC_Head *old, double t1);
+
 /* This is the main function.  Read this to understand how the
  * collection process works. */
 static Py_ssize_t
 collect(int generation)
 {
     int i;
-    Py_ssize_t m = 0; /* # objects collected */
-    Py_ssize_t n = 0; /* # unreachable objects that couldn't be collected */
+    Py_ssize_t n;
     PyGC_Head *young; /* the generation we are examining */
     PyGC_Head *old; /* next older generation */
-    PyGC_Head unreachable; /* non-problematic unreachable trash */
-    PyGC_Head finalizers;  /* objects with, & reachable from, __del__ */
-    PyGC_Head *gc;
     double t1 = 0.0;
+    Py_ssize_t start_us = monotonic_us();
 
     if (delstr == NULL) {
         delstr = PyString_InternFromString("__del__");
@@ -972,6 +1067,13 @@ collect(int generation)
         PyGC_RegisterStaticConstant(delstr);
     }
 
+    /* A full collection supersedes the incremental pass in progress. */
+    if (generation == NUM_GENERATIONS - 1) {
+        if (incremental_pass_active)
+            end_incremental_pass();
+        passes_since_full = 0;
+    }
+
     if (debug & DEBUG_STATS) {
         PySys_WriteStderr("gc: collecting generation %d...\n",
                           generation);
@@ -1001,6 +1103,26 @@ collect(int generation)
     else
         old = young;
 
+    n = collect_set(generation, young, old, t1);
+    record_pause(generation, monotonic_us() - start_us);
+    return n;
+}
+
+/* The part of a collection that works on a set of objects: frees the
+ * objects in young that aren't reachable from outside of it, and moves the
+ * rest to old.  young == old means this is a full collection; a young set
+ * of the oldest generation that's moved somewhere else is a slice of an
+ * incremental collection.
+ */
+static Py_ssize_t
+collect_set(int generation, PyGC_Head *young, PyGC_Head *old, double t1)
+{
+    Py_ssize_t m = 0; /* # objects collected */
+    Py_ssize_t n = 0; /* # unreachable objects that couldn't be collected */
+    PyGC_Head unreachable; /* non-problematic unreachable trash */
+    PyGC_Head finalizers;  /* objects with, & reachable from, __del__ */
+    PyGC_Head *gc;
+
     /* Using ob_refcnt and gc_refs, calculate which objects in the
      * container set are reachable from outside the set (i.e., have a
      * refcount greater than 0 when all the references within the
@@ -1023,6 +1145,10 @@ collect(int generation)
         if (generation == NUM_GENERATIONS - 2) {
             long_lived_pending += gc_list_size(young);
         }
+        else if (generation == NUM_GENERATIONS - 1) {
+            untrack_dicts(young);
+            old_visited_count += gc_list_size(young);
+        }
         gc_list_merge(young, old);
     }
     else {
@@ -1101,7 +1227,7 @@ collect(int generation)
 
     /* Clear free list only during the collection of the highest
      * generation */
-    if (generation == NUM_GENERATIONS-1) {
+    if (generation == NUM_GENERATIONS-1 && young == old) {
         clear_freelists();
     }
 
@@ -1116,6 +1242,127 @@ collect(int generation)
     return n+m;
 }
 
+static int
+visit_increment(PyObject *op, PyGC_Head *increment)
+{
+    if (PyObject_IS_GC(op)) {
+        PyGC_Head *gc = AS_GC(op);
+        /* Only objects of the oldest generation that haven't been added
+         * to a slice yet this pass: the younger generations are already
+         * in the slice, and everything in old_visited or the permanent
+         * generation has an epoch that doesn't qualify. */
+        if (gc->gc.gc_refs == GC_REACHABLE &&
+            gc->gc.gc_epoch != incremental_epoch &&
+            gc->gc.gc_epoch != GC_EPOCH_FROZEN) {
+            gc->gc.gc_epoch = incremental_epoch;
+            gc_list_move(gc, increment);
+        }
+    }
+    return 0;
+}
+
+/* Moves objects of the oldest generation into increment, which already
+ * holds the younger generations.  Objects are taken from the front of the
+ * oldest generation, and after each one come the old objects it references
+ * (breadth first), so that cycles end up in the same slice.  Stops once
+ * increment_size objects have been examined.
+ */
+static void
+fill_increment(PyGC_Head *increment)
+{
+    PyGC_Head *oldest = GEN_HEAD(NUM_GENERATIONS - 1);
+    PyGC_Head *gc;
+    Py_ssize_t n = 0;
+
+    for (gc = increment->gc.gc_next; gc != increment; gc = gc->gc.gc_next)
+        gc->gc.gc_epoch = incremental_epoch;
+
+    gc = increment;
+    while (n < increment_size) {
+        traverseproc traverse;
+        if (gc->gc.gc_next == increment) {
+            PyGC_Head *seed = oldest->gc.gc_next;
+            if (seed == oldest)
+                break;
+            seed->gc.gc_epoch = incremental_epoch;
+            gc_list_move(seed, increment);
+        }
+        gc = gc->gc.gc_next;
+        n++;
+        traverse = Py_TYPE(FROM_GC(gc))->tp_traverse;
+        (void) traverse(FROM_GC(gc),
+                        (visitproc)visit_increment,
+                        increment);
+    }
+}
+
+/* Collects the young generations plus a slice of the oldest one; see the
+ * comment at incremental. */
+static Py_ssize_t
+collect_increment(void)
+{
+    int i;
+    Py_ssize_t n, size, elapsed;
+    PyGC_Head increment;
+    double t1 = 0.0;
+    Py_ssize_t start_us = monotonic_us();
+
+    if (!incremental_pass_active) {
+        incremental_pass_active = 1;
+        old_visited_count = 0;
+    }
+    allocs_since_slice = 0;
+
+    gc_list_init(&increment);
+    for (i = 0; i < NUM_GENERATIONS - 1; i++) {
+        gc_list_merge(GEN_HEAD(i), &increment);
+        generations[i].count = 0;
+    }
+    fill_increment(&increment);
+
+    size = gc_list_size(&increment);
+    if (debug & DEBUG_STATS) {
+        PySys_WriteStderr("gc: collecting a slice of generation %d "
+                          "(%" PY_FORMAT_SIZE_T "d objects, "
+                          "%" PY_FORMAT_SIZE_T "d left)...\n",
+                          NUM_GENERATIONS - 1, size,
+                          gc_list_size(GEN_HEAD(NUM_GENERATIONS - 1)));
+        t1 = get_time();
+    }
+
+    n = collect_set(NUM_GENERATIONS - 1, &increment, &old_visited, t1);
+
+    if (gc_list_is_empty(GEN_HEAD(NUM_GENERATIONS - 1))) {
+        /* That was the last slice of this pass. */
+        long_lived_total = old_visited_count;
+        long_lived_pending = 0;
+        generations[NUM_GENERATIONS - 1].count = 0;
+        end_incremental_pass();
+        passes_since_full++;
+        clear_freelists();
+    }
+
+    /* Aim the next slice at the pause budget, without letting its size
+     * swing too much from one slice to the next. */
+    elapsed = monotonic_us() - start_us;
+    record_pause(NUM_GENERATIONS, elapsed);
+    if (size >= increment_size / 2) {
+        Py_ssize_t target = elapsed > 0 ?
+            (Py_ssize_t)((double)size * incremental_budget_us / elapsed) :
+            increment_size * 2;
+        if (target > increment_size * 2)
+            target = increment_size * 2;
+        if (target < increment_size / 2)
+            target = increment_size / 2;
+        if (target < MIN_INCREMENT_SIZE)
+            target = MIN_INCREMENT_SIZE;
+        if (target > MAX_INCREMENT_SIZE)
+            target = MAX_INCREMENT_SIZE;
+        increment_size = target;
+    }
+    return n;
+}
+
 static Py_ssize_t
 collect_generations(void)
 {
@@ -1127,6 +1374,17 @@ collect_generations(void)
      * generations younger than it will be collected. */
     for (i = NUM_GENERATIONS-1; i >= 0; i--) {
         if (generations[i].count > generations[i].threshold) {
+            /* Once an incremental pass has started, its slices are paced
+               by allocations rather than by the oldest generation's
+               threshold, which stays tripped until the pass is over. */
+            if (incremental_pass_active) {
+                if (allocs_since_slice >= increment_size / INCREMENTAL_PACING) {
+                    n = collect_increment();
+                    break;
+                }
+                if (i == NUM_GENERATIONS - 1)
+                    continue;
+            }
             /* Avoid quadratic performance degradation in number
                of tracked objects. See comments at the beginning
                of this file, and issue #4074.
@@ -1134,7 +1392,13 @@ collect_generations(void)
             if (i == NUM_GENERATIONS - 1
                 && long_lived_pending < long_lived_total / 4)
                 continue;
-            n = collect(i);
+            /* Cycles too big for a slice are only found by a full
+               collection, so every so often do one instead of a pass. */
+            if (incremental && i == NUM_GENERATIONS - 1 &&
+                passes_since_full < INCREMENTAL_FULL_INTERVAL)
+                n = collect_increment();
+            else
+                n = collect(i);
             break;
         }
     }
@@ -1347,6 +1611,10 @@ gc_get_referrers(PyObject *self, PyObject *args)
             return NULL;
         }
     }
+    if (!(gc_referrers_for(args, &old_visited, result))) {
+        Py_DECREF(result);
+        return NULL;
+    }
     return result;
 }
 
@@ -1408,6 +1676,10 @@ gc_get_objects(PyObject *self, PyObject *noargs)
             return NULL;
         }
     }
+    if (append_objects(result, &old_visited)) {
+        Py_DECREF(result);
+        return NULL;
+    }
     return result;
 }
 
@@ -1432,6 +1704,578 @@ gc_is_tracked(PyObject *self, PyObject *obj)
 }
 
 
+/* Same rule as makeImmortal(): instances of heap types reference their
+   class, which has to be able to go away, so they stay mortal. */
+static int
+visit_immortalize(PyObject *op, void *data)
+{
+    if (op != NULL && !_Py_IsImmortal(op) &&
+        !(Py_TYPE(op)->tp_flags & Py_TPFLAGS_HEAPTYPE)) {
+        _Py_SetImmortal(op);
+        (*(Py_ssize_t *)data)++;
+    }
+    return 0;
+}
+
+/* Pyston addition */
+Py_ssize_t
+_PyGC_Freeze(int immortalize)
+{
+    int i;
+    Py_ssize_t n = 0;
+    PyGC_Head *gc;
+
+    if (incremental_pass_active)
+        end_incremental_pass();
+
+    for (i = 0; i < NUM_GENERATIONS; i++) {
+        for (gc = GEN_HEAD(i)->gc.gc_next; gc != GEN_HEAD(i);
+             gc = gc->gc.gc_next) {
+            PyObject *op = FROM_GC(gc);
+            traverseproc traverse = Py_TYPE(op)->tp_traverse;
+            /* Keeps incremental collections from pulling it back out. */
+            gc->gc.gc_epoch = GC_EPOCH_FROZEN;
+            if (!immortalize)
+                continue;
+            /* The objects the collector tracks and everything they
+               directly refer to, which covers the strs, ints and other
+               atomic objects hanging off of them.  Atomic objects that are
+               only reachable through other atomic objects (for instance
+               the limbs of a long) don't hold references, so there's
+               nothing further to follow. */
+            (void) visit_immortalize(op, &n);
+            if (traverse)
+                (void) traverse(op, (visitproc)visit_immortalize, &n);
+        }
+    }
+
+    for (i = 0; i < NUM_GENERATIONS; i++) {
+        gc_list_merge(GEN_HEAD(i), &permanent_generation);
+        generations[i].count = 0;
+    }
+    return immortalize ? n : gc_list_size(&permanent_generation);
+}
+
+PyDoc_STRVAR(gc_freeze__doc__,
+"freeze() -> None\n"
+"\n"
+"Freeze all current tracked objects and ignore them for future collections.\n"
+"\n"
+"This can be used before a fork to make the gc copy-on-write friendly.\n"
+"Note: collection before a fork may free pages for future allocation\n"
+"which can cause copy-on-write.\n");
+
+static PyObject *
+gc_freeze(PyObject *self, PyObject *noargs)
+{
+    (void) _PyGC_Freeze(0);
+    Py_INCREF(Py_None);
+    return Py_None;
+}
+
+PyDoc_STRVAR(gc_unfreeze__doc__,
+"unfreeze() -> None\n"
+"\n"
+"Unfreeze all objects in the permanent generation.\n"
+"\n"
+"Put all objects in the permanent generation back into the oldest\n"
+"generation.\n");
+
+static PyObject *
+gc_unfreeze(PyObject *self, PyObject *noargs)
+{
+    PyGC_Head *gc;
+    for (gc = permanent_generation.gc.gc_next; gc != &permanent_generation;
+         gc = gc->gc.gc_next)
+        gc->gc.gc_epoch = 0;
+    gc_list_merge(&permanent_generation, GEN_HEAD(NUM_GENERATIONS - 1));
+    Py_INCREF(Py_None);
+    return Py_None;
+}
+
+PyDoc_STRVAR(gc_get_freeze_count__doc__,
+"get_freeze_count() -> int\n"
+"\n"
+"Return the number of objects in the permanent generation.\n");
+
+static PyObject *
+gc_get_freeze_count(PyObject *self, PyObject *noargs)
+{
+    return PyInt_FromSsize_t(gc_list_size(&permanent_generation));
+}
+
+PyDoc_STRVAR(gc_set_incremental__doc__,
+"set_incremental(enabled[, pause_budget_us]) -> None\n"
+"\n"
+"Enable or disable incremental collection of the oldest generation.\n"
+"\n"
+"When enabled, the collections of the oldest generation that are\n"
+"triggered by allocations are split into slices, each of which aims to\n"
+"take at most pause_budget_us microseconds.  gc.collect() still does a\n"
+"full collection, which also finds the rare garbage cycles that are too\n"
+"large to fit into a slice.\n");
+
+static PyObject *
+gc_set_incremental(PyObject *self, PyObject *args)
+{
+    int enable;
+    Py_ssize_t budget = incremental_budget_us;
+
+    if (!PyArg_ParseTuple(args, "i|n:set_incremental", &enable, &budget))
+        return NULL;
+    if (budget <= 0) {
+        PyErr_SetString(PyExc_ValueError, "pause budget must be positive");
+        return NULL;
+    }
+    if (!enable && incremental_pass_active)
+        end_incremental_pass();
+    incremental = enable;
+    incremental_budget_us = budget;
+    Py_INCREF(Py_None);
+    return Py_None;
+}
+
+PyDoc_STRVAR(gc_get_incremental__doc__,
+"get_incremental() -> (enabled, pause_budget_us)\n"
+"\n"
+"Return whether incremental collection is enabled, and its pause budget.\n");
+
+static PyObject *
+gc_get_incremental(PyObject *self, PyObject *noargs)
+{
+    return Py_BuildValue("(On)", incremental ? Py_True : Py_False,
+                         incremental_budget_us);
+}
+
+PyDoc_STRVAR(gc_get_pause_histogram__doc__,
+"get_pause_histogram([reset]) -> [gen0, gen1, gen2, slices]\n"
+"\n"
+"Return histograms of how long collections took, one per generation and\n"
+"one for the slices of incremental collections.  Item i of a histogram\n"
+"is the number of pauses that took less than 2**i microseconds (and at\n"
+"least 2**(i-1)); the last item also counts all longer pauses.  If reset\n"
+"is true, the histograms are cleared afterwards.\n");
+
+static PyObject *
+gc_get_pause_histogram(PyObject *self, PyObject *args)
+{
+    int reset = 0;
+    int i, j;
+    PyObject *result;
+
+    if (!PyArg_ParseTuple(args, "|i:get_pause_histogram", &reset))
+        return NULL;
+    result = PyList_New(NUM_GENERATIONS + 1);
+    if (result == NULL)
+        return NULL;
+    for (i = 0; i < NUM_GENERATIONS + 1; i++) {
+        PyObject *hist = PyList_New(PAUSE_BUCKETS);
+        if (hist == NULL) {
+            Py_DECREF(result);
+            return NULL;
+        }
+        for (j = 0; j < PAUSE_BUCKETS; j++) {
+            PyObject *count = PyInt_FromSsize_t(pause_histogram[i][j]);
+            if (count == NULL) {
+                Py_DECREF(hist);
+                Py_DECREF(result);
+                return NULL;
+            }
+            PyList_SET_ITEM(hist, j, count);
+        }
+        PyList_SET_ITEM(result, i, hist);
+    }
+    if (reset)
+        memset(pause_histogram, 0, sizeof(pause_histogram));
+    return result;
+}
+
+/* Pyston addition: heap snapshots.
+ *
+ * gc.dump_heap() writes every object the collector tracks, the objects they
+ * refer to, and a list of roots to a file, for tools/heap_snapshot.py to
+ * compute retained sizes and dominator paths from.  Records are streamed out
+ * as the lists are walked, so the only memory used besides the stdio buffer
+ * is the set of types seen so far, a fixed-size cache of recently written
+ * untracked objects, and the references of the object being written.
+ *
+ * The file starts with the 8 bytes "PYHEAP01", followed by records that each
+ * start with a one-byte tag.  Integers are native-endian; ids are addresses.
+ *
+ *   'T' u64 type id, u32 name length, name
+ *   'R' u8 kind (SNAPSHOT_ROOT_*), u64 object id, u32 name length, name
+ *   'O' u64 object id, u64 type id, u64 size, u32 nrefs, nrefs * u64 ids
+ *   'E' u64 number of 'O' records
+ *
+ * Tracked objects get one 'O' record, when we get to them in their
+ * generation.  Objects that aren't tracked (strs, ints, and containers of
+ * those) get written when something refers to them; the cache skips most
+ * repeats, but an object can still show up more than once, so readers have
+ * to ignore duplicates.
+ */
+
+#define SNAPSHOT_MAGIC "PYHEAP01"
+#define SNAPSHOT_ROOT_MODULE 0
+#define SNAPSHOT_ROOT_FRAME 1
+#define SNAPSHOT_ROOT_THREAD 2
+/* Untracked containers only refer to untracked objects, so this is only a
+   safety net against malformed ones. */
+#define SNAPSHOT_MAX_DEPTH 64
+/* Entries in the direct-mapped cache of untracked objects written recently */
+#define SNAPSHOT_UNTRACKED_CACHE_SIZE 4096
+
+/* Open-addressed set of pointers */
+struct snapshot_set {
+    void **items;
+    Py_ssize_t n, size;
+};
+
+struct heap_snapshot {
+    FILE *fp;
+    /* the types that already got a 'T' record */
+    struct snapshot_set types;
+    /* untracked objects that got an 'O' record recently; a lossy cache */
+    PyObject *untracked[SNAPSHOT_UNTRACKED_CACHE_SIZE];
+    /* references of the objects being written, innermost last */
+    PyObject **refs;
+    Py_ssize_t nrefs, refs_size;
+    Py_ssize_t nobjects;
+    /* scratch list of the frames and locals we created for the roots; it
+       isn't part of the snapshot itself */
+    PyObject *keep;
+    int failed;
+};
+
+static void
+snapshot_write(struct heap_snapshot *s, const void *data, size_t size)
+{
+    if (!s->failed && fwrite(data, 1, size, s->fp) != size)
+        s->failed = 1;
+}
+
+static void
+snapshot_write_u64(struct heap_snapshot *s, PY_UINT64_T v)
+{
+    snapshot_write(s, &v, sizeof(v));
+}
+
+static void
+snapshot_write_str(struct heap_snapshot *s, const char *str)
+{
+    PY_UINT32_T len = (PY_UINT32_T)strlen(str);
+    snapshot_write(s, &len, sizeof(len));
+    snapshot_write(s, str, len);
+}
+
+/* Returns 1 if p was added to the set, 0 if it was in it already, and -1 if
+   we ran out of memory. */
+static int
+snapshot_set_add(struct snapshot_set *set, void *p)
+{
+    Py_ssize_t i;
+
+    if (2 * (set->n + 1) > set->size) {
+        Py_ssize_t old_size = set->size;
+        void **old = set->items;
+        Py_ssize_t new_size = old_size ? 2 * old_size : 256;
+        set->items = (void **)calloc(new_size, sizeof(void *));
+        if (set->items == NULL) {
+            set->items = old;
+            return -1;
+        }
+        set->size = new_size;
+        for (i = 0; i < old_size; i++) {
+            if (old[i]) {
+                Py_ssize_t j = _Py_HashPointer(old[i]) & (new_size - 1);
+                while (set->items[j])
+                    j = (j + 1) & (new_size - 1);
+                set->items[j] = old[i];
+            }
+        }
+        free(old);
+    }
+
+    i = _Py_HashPointer(p) & (set->size - 1);
+    while (set->items[i]) {
+        if (set->items[i] == p)
+            return 0;
+        i = (i + 1) & (set->size - 1);
+    }
+    set->items[i] = p;
+    set->n++;
+    return 1;
+}
+
+static int
+snapshot_add_type(struct heap_snapshot *s, PyTypeObject *tp)
+{
+    int added = snapshot_set_add(&s->types, tp);
+    if (added <= 0)
+        return added;
+
+    snapshot_write(s, "T", 1);
+    snapshot_write_u64(s, (Py_uintptr_t)tp);
+    snapshot_write_str(s, tp->tp_name);
+    return 0;
+}
+
+static int
+visit_snapshot(PyObject *op, struct heap_snapshot *s)
+{
+    if (op == NULL)
+        return 0;
+    if (s->nrefs == s->refs_size) {
+        Py_ssize_t new_size = s->refs_size ? 2 * s->refs_size : 1024;
+        PyObject **refs = (PyObject **)realloc(s->refs, new_size * sizeof(PyObject *));
+        if (refs == NULL)
+            return -1;
+        s->refs = refs;
+        s->refs_size = new_size;
+    }
+    s->refs[s->nrefs++] = op;
+    return 0;
+}
+
+static int
+snapshot_object(struct heap_snapshot *s, PyObject *op, int depth)
+{
+    Py_ssize_t start = s->nrefs, i;
+    PY_UINT32_T n;
+    PY_UINT64_T size = _Py_LIVE_BYTES(op);
+    traverseproc traverse = Py_TYPE(op)->tp_traverse;
+
+    /* Tracked objects are in exactly one of the lists we walk, but anything
+       else can be referred to from any number of places. */
+    if (!(PyObject_IS_GC(op) && IS_TRACKED(op))) {
+        PyObject **slot = &s->untracked[_Py_HashPointer(op) &
+                                        (SNAPSHOT_UNTRACKED_CACHE_SIZE - 1)];
+        if (*slot == op)
+            return 0;
+        *slot = op;
+    }
+
+    if (PyObject_IS_GC(op)) {
+        size += sizeof(PyGC_Head);
+        if (traverse && traverse(op, (visitproc)visit_snapshot, s))
+            return -1;
+    }
+    if (snapshot_add_type(s, Py_TYPE(op)))
+        return -1;
+
+    n = (PY_UINT32_T)(s->nrefs - start);
+    snapshot_write(s, "O", 1);
+    snapshot_write_u64(s, (Py_uintptr_t)op);
+    snapshot_write_u64(s, (Py_uintptr_t)Py_TYPE(op));
+    snapshot_write_u64(s, size);
+    snapshot_write(s, &n, sizeof(n));
+    for (i = start; i < s->nrefs; i++)
+        snapshot_write_u64(s, (Py_uintptr_t)s->refs[i]);
+    s->nobjects++;
+
+    /* Tracked objects get written when we get to them in their generation;
+       everything else has to be written now. */
+    for (i = start; i < s->nrefs && depth < SNAPSHOT_MAX_DEPTH; i++) {
+        PyObject *ref = s->refs[i];
+        if (PyObject_IS_GC(ref) && IS_TRACKED(ref))
+            continue;
+        if (snapshot_object(s, ref, depth + 1))
+            return -1;
+    }
+    s->nrefs = start;
+    return 0;
+}
+
+static int
+snapshot_list(struct heap_snapshot *s, PyGC_Head *list)
+{
+    PyGC_Head *gc;
+    for (gc = list->gc.gc_next; gc != list; gc = gc->gc.gc_next) {
+        PyObject *op = FROM_GC(gc);
+        if (op == s->keep)
+            continue;
+        if (snapshot_object(s, op, 0))
+            return -1;
+    }
+    return 0;
+}
+
+static int
+snapshot_root(struct heap_snapshot *s, int kind, PyObject *op, const char *name)
+{
+    unsigned char k = kind;
+    if (op == NULL || op == Py_None)
+        return 0;
+    snapshot_write(s, "R", 1);
+    snapshot_write(s, &k, 1);
+    snapshot_write_u64(s, (Py_uintptr_t)op);
+    snapshot_write_str(s, name);
+    if (!(PyObject_IS_GC(op) && IS_TRACKED(op)))
+        return snapshot_object(s, op, 0);
+    return 0;
+}
+
+static int
+snapshot_frames(struct heap_snapshot *s)
+{
+    PyObject *frames, *tid, *f;
+    Py_ssize_t pos = 0;
+    char name[256];
+
+    frames = _PyThread_CurrentFrames();
+    if (frames == NULL)
+        return -1;
+    while (PyDict_Next(frames, &pos, &tid, &f)) {
+        Py_INCREF(f);
+        while (f != NULL && f != Py_None) {
+            PyObject *code = PyObject_GetAttrString(f, "f_code");
+            PyObject *co_name = code ? PyObject_GetAttrString(code, "co_name") : NULL;
+            PyObject *locals, *back;
+
+            PyOS_snprintf(name, sizeof(name), "thread %ld: %s line %d",
+                          PyInt_AsLong(tid),
+                          co_name && PyString_Check(co_name) ? PyString_AS_STRING(co_name) : "?",
+                          PyFrame_GetLineNumber((PyFrameObject *)f));
+            Py_XDECREF(co_name);
+            Py_XDECREF(code);
+            PyErr_Clear();
+            if (PyList_Append(s->keep, f) || snapshot_root(s, SNAPSHOT_ROOT_FRAME, f, name))
+                goto error;
+
+            locals = PyObject_GetAttrString(f, "f_locals");
+            if (locals == NULL) {
+                PyErr_Clear();
+            } else {
+                strncat(name, " locals", sizeof(name) - strlen(name) - 1);
+                if (PyList_Append(s->keep, locals) || snapshot_root(s, SNAPSHOT_ROOT_FRAME, locals, name)) {
+                    Py_DECREF(locals);
+                    goto error;
+                }
+                Py_DECREF(locals);
+            }
+
+            back = PyObject_GetAttrString(f, "f_back");
+            if (back == NULL)
+                PyErr_Clear();
+            Py_DECREF(f);
+            f = back;
+        }
+        Py_XDECREF(f);
+    }
+    Py_DECREF(frames);
+    return 0;
+
+error:
+    Py_DECREF(f);
+    Py_DECREF(frames);
+    return -1;
+}
+
+static int
+snapshot_roots(struct heap_snapshot *s)
+{
+    PyObject *modules = PyImport_GetModuleDict();
+    PyObject *key, *value;
+    PyThreadState *ts;
+    Py_ssize_t pos = 0;
+    char name[256];
+
+    while (PyDict_Next(modules, &pos, &key, &value)) {
+        if (snapshot_root(s, SNAPSHOT_ROOT_MODULE, value,
+                          PyString_Check(key) ? PyString_AS_STRING(key) : "?"))
+            return -1;
+    }
+
+    for (ts = PyInterpreterState_ThreadHead(PyThreadState_GET()->interp); ts != NULL;
+         ts = PyThreadState_Next(ts)) {
+#define THREAD_ROOT(field)                                                  \
+        PyOS_snprintf(name, sizeof(name), "thread %ld: " #field, ts->thread_id); \
+        if (snapshot_root(s, SNAPSHOT_ROOT_THREAD, ts->field, name))        \
+            return -1;
+        THREAD_ROOT(dict);
+        THREAD_ROOT(curexc_type);
+        THREAD_ROOT(curexc_value);
+        THREAD_ROOT(curexc_traceback);
+        THREAD_ROOT(async_exc);
+#undef THREAD_ROOT
+    }
+
+    return snapshot_frames(s);
+}
+
+/* Returns the number of object records written, or -1 with an exception
+   set. */
+Py_ssize_t
+_PyGC_DumpHeap(const char *path)
+{
+    struct heap_snapshot s;
+    int i, ok;
+
+    memset(&s, 0, sizeof(s));
+    s.fp = fopen(path, "wb");
+    if (s.fp == NULL) {
+        PyErr_SetFromErrnoWithFilename(PyExc_IOError, (char *)path);
+        return -1;
+    }
+    setvbuf(s.fp, NULL, _IOFBF, 1 << 20);
+    s.keep = PyList_New(0);
+    if (s.keep == NULL) {
+        fclose(s.fp);
+        return -1;
+    }
+
+    snapshot_write(&s, SNAPSHOT_MAGIC, 8);
+    ok = snapshot_roots(&s) == 0;
+
+    /* Nothing below allocates Python objects, so the lists can't change
+       while we walk them. */
+    for (i = 0; ok && i < NUM_GENERATIONS; i++)
+        ok = snapshot_list(&s, GEN_HEAD(i)) == 0;
+    ok = ok && snapshot_list(&s, &old_visited) == 0;
+    ok = ok && snapshot_list(&s, &permanent_generation) == 0;
+
+    snapshot_write(&s, "E", 1);
+    snapshot_write_u64(&s, s.nobjects);
+    if (fclose(s.fp) != 0)
+        s.failed = 1;
+    free(s.types.items);
+    free(s.refs);
+    Py_DECREF(s.keep);
+
+    if (!ok) {
+        if (!PyErr_Occurred())
+            PyErr_NoMemory();
+        return -1;
+    }
+    if (s.failed) {
+        PyErr_SetFromErrnoWithFilename(PyExc_IOError, (char *)path);
+        return -1;
+    }
+    return s.nobjects;
+}
+
+PyDoc_STRVAR(gc_dump_heap__doc__,
+"dump_heap(filename) -> int\n"
+"\n"
+"Write a snapshot of the heap to a file: every object tracked by the\n"
+"collector, the objects they refer to, and the roots (modules, frames and\n"
+"thread states).  tools/heap_snapshot.py can compute retained sizes and\n"
+"dominator paths from it.  Returns the number of object records written.\n");
+
+static PyObject *
+gc_dump_heap(PyObject *self, PyObject *args)
+{
+    char *path;
+    Py_ssize_t n;
+
+    if (!PyArg_ParseTuple(args, "s:dump_heap", &path))
+        return NULL;
+    n = _PyGC_DumpHeap(path);
+    if (n < 0)
+        return NULL;
+    return PyInt_FromSsize_t(n);
+}
+
+
 PyDoc_STRVAR(gc__doc__,
 "This module provides access to the garbage collector for reference cycles.\n"
 "\n"
@@ -1447,7 +2291,14 @@ PyDoc_STRVAR(gc__doc__,
 "get_objects() -- Return a list of all objects tracked by the collector.\n"
 "is_tracked() -- Returns true if a given object is tracked.\n"
 "get_referrers() -- Return the list of objects that refer to an object.\n"
-"get_referents() -- Return the list of objects that an object refers to.\n");
+"get_referents() -- Return the list of objects that an object refers to.\n"
+"freeze() -- Freeze all tracked objects and ignore them for future collections.\n"
+"unfreeze() -- Unfreeze all objects in the permanent generation.\n"
+"get_freeze_count() -- Return the number of objects in the permanent generation.\n"
+"set_incremental() -- Enable or disable incremental collection.\n"
+"get_incremental() -- Return the incremental collection settings.\n"
+"get_pause_histogram() -- Return histograms of collection pause times.\n"
+"dump_heap() -- Write a snapshot of the heap to a file.\n");
 
 static PyMethodDef GcMethods[] = {
     {"enable",             gc_enable,     METH_NOARGS,  gc_enable__doc__},
@@ -1466,6 +2317,17 @@ static PyMethodDef GcMethods[] = {
         gc_get_referrers__doc__},
     {"get_referents",  gc_get_referents, METH_VARARGS,
         gc_get_referents__doc__},
+    {"freeze",         gc_freeze,     METH_NOARGS,  gc_freeze__doc__},
+    {"unfreeze",       gc_unfreeze,   METH_NOARGS,  gc_unfreeze__doc__},
+    {"get_freeze_count", gc_get_freeze_count, METH_NOARGS,
+        gc_get_freeze_count__doc__},
+    {"set_incremental", gc_set_incremental, METH_VARARGS,
+        gc_set_incremental__doc__},
+    {"get_incremental", gc_get_incremental, METH_NOARGS,
+        gc_get_incremental__doc__},
+    {"get_pause_histogram", gc_get_pause_histogram, METH_VARARGS,
+        gc_get_pause_histogram__doc__},
+    {"dump_heap",      gc_dump_heap,  METH_VARARGS, gc_dump_heap__doc__},
     {NULL,      NULL}           /* Sentinel */
 };
 
@@ -1582,7 +2444,6 @@ _PyObject_GC_UnTrack(PyObject *op)
 PyObject *
 _PyObject_GC_Malloc(size_t basicsize)
 {
-    PyObject *op;
     PyGC_Head *g;
     if (basicsize > PY_SSIZE_T_MAX - sizeof(PyGC_Head))
         return PyErr_NoMemory();
@@ -1590,8 +2451,19 @@ _PyObject_GC_Malloc(size_t basicsize)
         sizeof(PyGC_Head) + basicsize);
     if (g == NULL)
         return PyErr_NoMemory();
+    return _PyObject_GC_Init(g);
+}
+
+/* Pyston addition */
+PyObject *
+_PyObject_GC_Init(void *mem)
+{
+    PyObject *op;
+    PyGC_Head *g = (PyGC_Head *)mem;
     g->gc.gc_refs = GC_UNTRACKED;
+    g->gc.gc_epoch = 0;
     generations[0].count++; /* number of allocated GC objects */
+    allocs_since_slice++;
     if (generations[0].count > generations[0].threshold &&
         enabled &&
         generations[0].threshold &&
@@ -1122,6 +1122,8 @@ bytearray_dealloc(PyByteArrayObject *self)
 #define STRINGLIB_ISLINEBREAK(x) ((x == '\n') || (x == '\r'))
 #define STRINGLIB_CHECK_EXACT PyByteArray_CheckExact
 #define STRINGLIB_MUTABLE 1
+// Pyston change: use the vectorized search kernels (see fastsearch.h)
+#define STRINGLIB_BYTES_SEARCH 1
 
 #include "stringlib/fastsearch.h"
 #include "stringlib/count.h"
@@ -984,6 +984,74 @@ reverse_slice(PyObject **lo, PyObject **hi)
  * pieces to this algorithm; read listsort.txt for overviews and details.
  */
 
+/* The maximum number of entries in a MergeState's pending-runs stack.
+ * This is enough to sort arrays of size up to about
+ *     32 * phi ** MAX_MERGE_PENDING
+ * where phi ~= 1.618.  85 is ridiculouslylarge enough, good for an array
+ * with 2**64 elements.
+ */
+#define MAX_MERGE_PENDING 85
+
+/* When we get into galloping mode, we stay there until both runs win less
+ * often than MIN_GALLOP consecutive times.  See listsort.txt for more info.
+ */
+#define MIN_GALLOP 7
+
+/* Avoid malloc for small temp arrays. */
+#define MERGESTATE_TEMP_SIZE 256
+
+/* One MergeState exists on the stack per invocation of mergesort.  It's just
+ * a convenient way to pass state around among the helper functions.
+ */
+struct s_slice {
+    PyObject **base;
+    Py_ssize_t len;
+};
+
+typedef struct s_MergeState MergeState;
+
+struct s_MergeState {
+    /* The user-supplied comparison function. or NULL if none given. */
+    PyObject *compare;
+
+    /* Pyston change: the function used to compare two list items, picked by
+     * listsort() after looking at the types of the keys.  When the keys were
+     * produced by a key function, key_compare unwraps them and then calls
+     * unwrapped_compare; tuple_elem_compare is used on the first elements of
+     * tuple keys.
+     */
+    int (*key_compare)(PyObject *, PyObject *, MergeState *);
+    int (*unwrapped_compare)(PyObject *, PyObject *, MergeState *);
+    int (*tuple_elem_compare)(PyObject *, PyObject *, MergeState *);
+
+    /* This controls when we get *into* galloping mode.  It's initialized
+     * to MIN_GALLOP.  merge_lo and merge_hi tend to nudge it higher for
+     * random data, and lower for highly structured data.
+     */
+    Py_ssize_t min_gallop;
+
+    /* 'a' is temp storage to help with merges.  It contains room for
+     * alloced entries.
+     */
+    PyObject **a;       /* may point to temparray below */
+    Py_ssize_t alloced;
+
+    /* A stack of n pending runs yet to be merged.  Run #i starts at
+     * address base[i] and extends for len[i] elements.  It's always
+     * true (so long as the indices are in bounds) that
+     *
+     *     pending[i].base + pending[i].len == pending[i+1].base
+     *
+     * so we could cut the storage for this, but it's a minor amount,
+     * and keeping all the info explicit simplifies the code.
+     */
+    int n;
+    struct s_slice pending[MAX_MERGE_PENDING];
+
+    /* 'a' points to this when possible, rather than muck with malloc. */
+    PyObject *temparray[MERGESTATE_TEMP_SIZE];
+};
+
 /* Comparison function.  Takes care of calling a user-supplied
  * comparison function (any callable Python object), which must not be
  * NULL (use the ISLT macro if you don't know, or call PyObject_RichCompareBool
@@ -1024,20 +1092,105 @@ islt(PyObject *x, PyObject *y, PyObject *compare)
     return i < 0;
 }
 
-/* If COMPARE is NULL, calls PyObject_RichCompareBool with Py_LT, else calls
- * islt.  This avoids a layer of function call in the usual case, and
- * sorting does many comparisons.
+/* Pyston change: type-specialized comparisons, along the lines of what
+ * CPython 3.7 does.  listsort() checks up front whether all the keys are
+ * exact ints, floats or strs (or non-empty tuples whose first elements are),
+ * and if so compares them directly instead of going through the generic
+ * rich comparison machinery for every pair.
+ *
+ * All of these return -1 on error, 1 if v < w, 0 if v >= w.
+ */
+
+/* Generic fallback when no user comparison function was given. */
+static int
+safe_object_compare(PyObject *v, PyObject *w, MergeState *ms)
+{
+    return PyObject_RichCompareBool(v, w, Py_LT);
+}
+
+/* Calls the user-supplied comparison function. */
+static int
+user_compare(PyObject *v, PyObject *w, MergeState *ms)
+{
+    return islt(v, w, ms->compare);
+}
+
+static int
+unsafe_int_compare(PyObject *v, PyObject *w, MergeState *ms)
+{
+    assert(PyInt_CheckExact(v) && PyInt_CheckExact(w));
+    return PyInt_AS_LONG(v) < PyInt_AS_LONG(w);
+}
+
+static int
+unsafe_float_compare(PyObject *v, PyObject *w, MergeState *ms)
+{
+    assert(PyFloat_CheckExact(v) && PyFloat_CheckExact(w));
+    return PyFloat_AS_DOUBLE(v) < PyFloat_AS_DOUBLE(w);
+}
+
+/* Same ordering as string_richcompare. */
+static int
+unsafe_string_compare(PyObject *v, PyObject *w, MergeState *ms)
+{
+    Py_ssize_t len_v, len_w;
+    int res;
+
+    assert(PyString_CheckExact(v) && PyString_CheckExact(w));
+    len_v = PyString_GET_SIZE(v);
+    len_w = PyString_GET_SIZE(w);
+    res = memcmp(PyString_AS_STRING(v), PyString_AS_STRING(w),
+                 len_v < len_w ? len_v : len_w);
+    return res != 0 ? res < 0 : len_v < len_w;
+}
+
+/* Tuples are compared like tuplerichcompare does: find the first index
+ * where the items differ, and compare those.  Only the first items are
+ * known to be of a specialized type.
+ */
+static int
+unsafe_tuple_compare(PyObject *v, PyObject *w, MergeState *ms)
+{
+    Py_ssize_t i, vlen, wlen;
+    int k;
+
+    assert(PyTuple_CheckExact(v) && PyTuple_CheckExact(w));
+    assert(Py_SIZE(v) > 0 && Py_SIZE(w) > 0);
+
+    vlen = Py_SIZE(v);
+    wlen = Py_SIZE(w);
+    for (i = 0; i < vlen && i < wlen; i++) {
+        k = PyObject_RichCompareBool(PyTuple_GET_ITEM(v, i),
+                                     PyTuple_GET_ITEM(w, i), Py_EQ);
+        if (k < 0)
+            return -1;
+        if (!k)
+            break;
+    }
+
+    if (i >= vlen || i >= wlen)
+        return vlen < wlen;
+
+    if (i == 0)
+        return ms->tuple_elem_compare(PyTuple_GET_ITEM(v, 0),
+                                      PyTuple_GET_ITEM(w, 0), ms);
+    return PyObject_RichCompareBool(PyTuple_GET_ITEM(v, i),
+                                    PyTuple_GET_ITEM(w, i), Py_LT);
+}
+
+/* Compares the keys of two sortwrappers; defined below. */
+static int sortwrapper_compare(PyObject *v, PyObject *w, MergeState *ms);
+
+/* Calls the comparison function listsort() picked for this sort.
  * Returns -1 on error, 1 if x < y, 0 if x >= y.
  */
-#define ISLT(X, Y, COMPARE) ((COMPARE) == NULL ?                        \
-                 PyObject_RichCompareBool(X, Y, Py_LT) :                \
-                 islt(X, Y, COMPARE))
+#define ISLT(X, Y, MS) ((MS)->key_compare(X, Y, MS))
 
 /* Compare X to Y via "<".  Goto "fail" if the comparison raises an
    error.  Else "k" is set to true iff X<Y, and an "if (k)" block is
    started.  It makes more sense in context <wink>.  X and Y are PyObject*s.
 */
-#define IFLT(X, Y) if ((k = ISLT(X, Y, compare)) < 0) goto fail;  \
+#define IFLT(X, Y) if ((k = ISLT(X, Y, ms)) < 0) goto fail;  \
            if (k)
 
 /* binarysort is the best method for sorting small arrays: it does
@@ -1052,8 +1205,7 @@ islt(PyObject *x, PyObject *y, PyObject *compare)
    the input (nothing is lost or duplicated).
 */
 static int
-binarysort(PyObject **lo, PyObject **hi, PyObject **start, PyObject *compare)
-     /* compare -- comparison function object, or NULL for default */
+binarysort(PyObject **lo, PyObject **hi, PyObject **start, MergeState *ms)
 {
     register Py_ssize_t k;
     register PyObject **l, **p, **r;
@@ -1118,7 +1270,7 @@ elements to get out of order).
 Returns -1 in case of error.
 */
 static Py_ssize_t
-count_run(PyObject **lo, PyObject **hi, PyObject *compare, int *descending)
+count_run(PyObject **lo, PyObject **hi, MergeState *ms, int *descending)
 {
     Py_ssize_t k;
     Py_ssize_t n;
@@ -1173,7 +1325,7 @@ key, and the last n-k should follow key.
 Returns -1 on error.  See listsort.txt for info on the method.
 */
 static Py_ssize_t
-gallop_left(PyObject *key, PyObject **a, Py_ssize_t n, Py_ssize_t hint, PyObject *compare)
+gallop_left(PyObject *key, PyObject **a, Py_ssize_t n, Py_ssize_t hint, MergeState *ms)
 {
     Py_ssize_t ofs;
     Py_ssize_t lastofs;
@@ -1264,7 +1416,7 @@ we're sticking to "<" comparisons that it's much harder to follow if
 written as one routine with yet another "left or right?" flag.
 */
 static Py_ssize_t
-gallop_right(PyObject *key, PyObject **a, Py_ssize_t n, Py_ssize_t hint, PyObject *compare)
+gallop_right(PyObject *key, PyObject **a, Py_ssize_t n, Py_ssize_t hint, MergeState *ms)
 {
     Py_ssize_t ofs;
     Py_ssize_t lastofs;
@@ -1340,68 +1492,15 @@ fail:
     return -1;
 }
 
-/* The maximum number of entries in a MergeState's pending-runs stack.
- * This is enough to sort arrays of size up to about
- *     32 * phi ** MAX_MERGE_PENDING
- * where phi ~= 1.618.  85 is ridiculouslylarge enough, good for an array
- * with 2**64 elements.
- */
-#define MAX_MERGE_PENDING 85
-
-/* When we get into galloping mode, we stay there until both runs win less
- * often than MIN_GALLOP consecutive times.  See listsort.txt for more info.
- */
-#define MIN_GALLOP 7
-
-/* Avoid malloc for small temp arrays. */
-#define MERGESTATE_TEMP_SIZE 256
-
-/* One MergeState exists on the stack per invocation of mergesort.  It's just
- * a convenient way to pass state around among the helper functions.
- */
-struct s_slice {
-    PyObject **base;
-    Py_ssize_t len;
-};
-
-typedef struct s_MergeState {
-    /* The user-supplied comparison function. or NULL if none given. */
-    PyObject *compare;
-
-    /* This controls when we get *into* galloping mode.  It's initialized
-     * to MIN_GALLOP.  merge_lo and merge_hi tend to nudge it higher for
-     * random data, and lower for highly structured data.
-     */
-    Py_ssize_t min_gallop;
-
-    /* 'a' is temp storage to help with merges.  It contains room for
-     * alloced entries.
-     */
-    PyObject **a;       /* may point to temparray below */
-    Py_ssize_t alloced;
-
-    /* A stack of n pending runs yet to be merged.  Run #i starts at
-     * address base[i] and extends for len[i] elements.  It's always
-     * true (so long as the indices are in bounds) that
-     *
-     *     pending[i].base + pending[i].len == pending[i+1].base
-     *
-     * so we could cut the storage for this, but it's a minor amount,
-     * and keeping all the info explicit simplifies the code.
-     */
-    int n;
-    struct s_slice pending[MAX_MERGE_PENDING];
-
-    /* 'a' points to this when possible, rather than muck with malloc. */
-    PyObject *temparray[MERGESTATE_TEMP_SIZE];
-} MergeState;
-
 /* Conceptually a MergeState's constructor. */
 static void
 merge_init(MergeState *ms, PyObject *compare)
 {
     assert(ms != NULL);
     ms->compare = compare;
+    ms->key_compare = compare != NULL ? user_compare : safe_object_compare;
+    ms->unwrapped_compare = NULL;
+    ms->tuple_elem_compare = NULL;
     ms->a = ms->temparray;
     ms->alloced = MERGESTATE_TEMP_SIZE;
     ms->n = 0;
@@ -1462,7 +1561,6 @@ merge_lo(MergeState *ms, PyObject **pa, Py_ssize_t na,
                          PyObject **pb, Py_ssize_t nb)
 {
     Py_ssize_t k;
-    PyObject *compare;
     PyObject **dest;
     int result = -1;            /* guilty until proved innocent */
     Py_ssize_t min_gallop;
@@ -1482,7 +1580,6 @@ merge_lo(MergeState *ms, PyObject **pa, Py_ssize_t na,
         goto CopyB;
 
     min_gallop = ms->min_gallop;
-    compare = ms->compare;
     for (;;) {
         Py_ssize_t acount = 0;          /* # of times A won in a row */
         Py_ssize_t bcount = 0;          /* # of times B won in a row */
@@ -1492,7 +1589,7 @@ merge_lo(MergeState *ms, PyObject **pa, Py_ssize_t na,
          */
         for (;;) {
             assert(na > 1 && nb > 0);
-            k = ISLT(*pb, *pa, compare);
+            k = ISLT(*pb, *pa, ms);
             if (k) {
                 if (k < 0)
                     goto Fail;
@@ -1527,7 +1624,7 @@ merge_lo(MergeState *ms, PyObject **pa, Py_ssize_t na,
             assert(na > 1 && nb > 0);
             min_gallop -= min_gallop > 1;
             ms->min_gallop = min_gallop;
-            k = gallop_right(*pb, pa, na, 0, compare);
+            k = gallop_right(*pb, pa, na, 0, ms);
             acount = k;
             if (k) {
                 if (k < 0)
@@ -1550,7 +1647,7 @@ merge_lo(MergeState *ms, PyObject **pa, Py_ssize_t na,
             if (nb == 0)
                 goto Succeed;
 
-            k = gallop_left(*pa, pb, nb, 0, compare);
+            k = gallop_left(*pa, pb, nb, 0, ms);
             bcount = k;
             if (k) {
                 if (k < 0)
@@ -1594,7 +1691,6 @@ static Py_ssize_t
 merge_hi(MergeState *ms, PyObject **pa, Py_ssize_t na, PyObject **pb, Py_ssize_t nb)
 {
     Py_ssize_t k;
-    PyObject *compare;
     PyObject **dest;
     int result = -1;            /* guilty until proved innocent */
     PyObject **basea;
@@ -1619,7 +1715,6 @@ merge_hi(MergeState *ms, PyObject **pa, Py_ssize_t na, PyObject **pb, Py_ssize_t
         goto CopyA;
 
     min_gallop = ms->min_gallop;
-    compare = ms->compare;
     for (;;) {
         Py_ssize_t acount = 0;          /* # of times A won in a row */
         Py_ssize_t bcount = 0;          /* # of times B won in a row */
@@ -1629,7 +1724,7 @@ merge_hi(MergeState *ms, PyObject **pa, Py_ssize_t na, PyObject **pb, Py_ssize_t
          */
         for (;;) {
             assert(na > 0 && nb > 1);
-            k = ISLT(*pb, *pa, compare);
+            k = ISLT(*pb, *pa, ms);
             if (k) {
                 if (k < 0)
                     goto Fail;
@@ -1664,7 +1759,7 @@ merge_hi(MergeState *ms, PyObject **pa, Py_ssize_t na, PyObject **pb, Py_ssize_t
             assert(na > 0 && nb > 1);
             min_gallop -= min_gallop > 1;
             ms->min_gallop = min_gallop;
-            k = gallop_right(*pb, basea, na, na-1, compare);
+            k = gallop_right(*pb, basea, na, na-1, ms);
             if (k < 0)
                 goto Fail;
             k = na - k;
@@ -1682,7 +1777,7 @@ merge_hi(MergeState *ms, PyObject **pa, Py_ssize_t na, PyObject **pb, Py_ssize_t
             if (nb == 1)
                 goto CopyA;
 
-            k = gallop_left(*pa, baseb, nb, nb-1, compare);
+            k = gallop_left(*pa, baseb, nb, nb-1, ms);
             if (k < 0)
                 goto Fail;
             k = nb - k;
@@ -1734,7 +1829,6 @@ merge_at(MergeState *ms, Py_ssize_t i)
     PyObject **pa, **pb;
     Py_ssize_t na, nb;
     Py_ssize_t k;
-    PyObject *compare;
 
     assert(ms != NULL);
     assert(ms->n >= 2);
@@ -1760,8 +1854,7 @@ merge_at(MergeState *ms, Py_ssize_t i)
     /* Where does b start in a?  Elements in a before that can be
      * ignored (already in place).
      */
-    compare = ms->compare;
-    k = gallop_right(*pb, pa, na, 0, compare);
+    k = gallop_right(*pb, pa, na, 0, ms);
     if (k < 0)
         return -1;
     pa += k;
@@ -1772,7 +1865,7 @@ merge_at(MergeState *ms, Py_ssize_t i)
     /* Where does a end in b?  Elements in b after that can be
      * ignored (already in place).
      */
-    nb = gallop_left(pa[na-1], pb, nb, nb-1, compare);
+    nb = gallop_left(pa[na-1], pb, nb, nb-1, ms);
     if (nb <= 0)
         return nb;
 
@@ -1965,6 +2058,166 @@ sortwrapper_getvalue(PyObject *so)
     return value;
 }
 
+static int
+sortwrapper_compare(PyObject *v, PyObject *w, MergeState *ms)
+{
+    return ms->unwrapped_compare(((sortwrapperobject *)v)->key,
+                                 ((sortwrapperobject *)w)->key, ms);
+}
+
+/* Pyston change: scan the keys (the items themselves, or the keys inside
+ * the sortwrappers if 'keyed') and switch ms to a specialized comparison if
+ * they are homogeneous enough.  Must only be called when there is no
+ * user-supplied comparison function.
+ */
+static void
+merge_pick_compare(MergeState *ms, PyObject **items, Py_ssize_t n, int keyed)
+{
+    int (*compare)(PyObject *, PyObject *, MergeState *);
+    PyTypeObject *key_type;
+    PyObject *key;
+    int keys_are_in_tuples;
+    int keys_are_all_same_type = 1;
+    Py_ssize_t i;
+
+    assert(ms->compare == NULL);
+    if (n < 2)
+        return;
+
+#define SORT_KEY(i) (keyed ? ((sortwrapperobject *)items[i])->key : items[i])
+    /* Assume the first key is representative, then check all of them. */
+    key = SORT_KEY(0);
+    keys_are_in_tuples = PyTuple_CheckExact(key) && Py_SIZE(key) > 0;
+    key_type = Py_TYPE(keys_are_in_tuples ? PyTuple_GET_ITEM(key, 0) : key);
+
+    for (i = 0; i < n; i++) {
+        key = SORT_KEY(i);
+        if (keys_are_in_tuples) {
+            if (!PyTuple_CheckExact(key) || Py_SIZE(key) == 0) {
+                keys_are_in_tuples = 0;
+                keys_are_all_same_type = 0;
+                break;
+            }
+            key = PyTuple_GET_ITEM(key, 0);
+        }
+        if (Py_TYPE(key) != key_type) {
+            keys_are_all_same_type = 0;
+            /* For tuples we still need to check that every key is one. */
+            if (!keys_are_in_tuples)
+                break;
+        }
+    }
+#undef SORT_KEY
+
+    if (!keys_are_all_same_type)
+        compare = safe_object_compare;
+    else if (key_type == &PyInt_Type)
+        compare = unsafe_int_compare;
+    else if (key_type == &PyFloat_Type)
+        compare = unsafe_float_compare;
+    else if (key_type == &PyString_Type)
+        compare = unsafe_string_compare;
+    else
+        compare = safe_object_compare;
+
+    if (keys_are_in_tuples) {
+        ms->tuple_elem_compare = compare;
+        compare = unsafe_tuple_compare;
+    }
+
+    /* sortwrappers already compare by key, so only unwrap them if that
+     * buys us something. */
+    if (compare == safe_object_compare)
+        return;
+
+    if (keyed) {
+        ms->unwrapped_compare = compare;
+        ms->key_compare = sortwrapper_compare;
+    } else {
+        ms->key_compare = compare;
+    }
+}
+
+/* Pyston change: below this size merging with unsafe_int_compare is about
+ * as fast as a radix sort. */
+#define RADIX_SORT_MIN_SIZE 1024
+
+/* Pyston change: stable LSD radix sort, for when every key is an exact int.
+ * Bytes that are the same in all the keys are skipped, so lists of small
+ * ints only take a couple of passes.  Returns -1 without touching the items
+ * if the temporary arrays can't be allocated.
+ */
+static int
+radix_sort_ints(PyObject **items, Py_ssize_t n, int keyed)
+{
+    const unsigned long sign_bit = 1UL << (sizeof(long) * 8 - 1);
+    size_t counts[sizeof(long)][256];
+    unsigned long *keys, *keys_tmp, *keys_src, *keys_dst, *tmp_keys;
+    PyObject **items_tmp, **src, **dst, **tmp_items;
+    PyObject *key;
+    unsigned long k;
+    size_t b, c, pos, count;
+    Py_ssize_t i;
+    int sorted = 1;
+
+    keys = (unsigned long *)PyMem_Malloc(n * sizeof(unsigned long));
+    keys_tmp = (unsigned long *)PyMem_Malloc(n * sizeof(unsigned long));
+    items_tmp = (PyObject **)PyMem_Malloc(n * sizeof(PyObject *));
+    if (keys == NULL || keys_tmp == NULL || items_tmp == NULL) {
+        PyMem_Free(keys);
+        PyMem_Free(keys_tmp);
+        PyMem_Free(items_tmp);
+        return -1;
+    }
+
+    /* Flipping the sign bit makes the unsigned order match the signed one. */
+    memset(counts, 0, sizeof(counts));
+    for (i = 0; i < n; i++) {
+        key = keyed ? ((sortwrapperobject *)items[i])->key : items[i];
+        k = (unsigned long)PyInt_AS_LONG(key) ^ sign_bit;
+        keys[i] = k;
+        if (i > 0 && k < keys[i - 1])
+            sorted = 0;
+        for (b = 0; b < sizeof(long); b++)
+            counts[b][(k >> (b * 8)) & 0xff]++;
+    }
+
+    keys_src = keys;
+    keys_dst = keys_tmp;
+    src = items;
+    dst = items_tmp;
+    for (b = 0; !sorted && b < sizeof(long); b++) {
+        if (counts[b][(keys_src[0] >> (b * 8)) & 0xff] == (size_t)n)
+            continue;
+
+        pos = 0;
+        for (c = 0; c < 256; c++) {
+            count = counts[b][c];
+            counts[b][c] = pos;
+            pos += count;
+        }
+        for (i = 0; i < n; i++) {
+            pos = counts[b][(keys_src[i] >> (b * 8)) & 0xff]++;
+            keys_dst[pos] = keys_src[i];
+            dst[pos] = src[i];
+        }
+
+        tmp_keys = keys_src;
+        keys_src = keys_dst;
+        keys_dst = tmp_keys;
+        tmp_items = src;
+        src = dst;
+        dst = tmp_items;
+    }
+    if (src != items)
+        memcpy(items, src, n * sizeof(PyObject *));
+
+    PyMem_Free(keys);
+    PyMem_Free(keys_tmp);
+    PyMem_Free(items_tmp);
+    return 0;
+}
+
 /* Wrapper for user specified cmp functions in combination with a
    specified key function.  Makes sure the cmp function is presented
    with the actual key instead of the sortwrapper */
@@ -2125,11 +2378,21 @@ listsort(PyListObject *self, PyObject *args, PyObject *kwds)
         reverse_slice(saved_ob_item, saved_ob_item + saved_ob_size);
 
     merge_init(&ms, compare);
+    // Pyston change: use a comparison specialized for the key types
+    if (compare == NULL)
+        merge_pick_compare(&ms, saved_ob_item, saved_ob_size, keyfunc != NULL);
 
     nremaining = saved_ob_size;
     if (nremaining < 2)
         goto succeed;
 
+    // Pyston change: large lists of ints don't need comparisons at all
+    if (nremaining >= RADIX_SORT_MIN_SIZE
+        && (ms.key_compare == unsafe_int_compare
+            || (ms.key_compare == sortwrapper_compare && ms.unwrapped_compare == unsafe_int_compare))
+        && radix_sort_ints(saved_ob_item, nremaining, keyfunc != NULL) == 0)
+        goto succeed;
+
     /* March over the array once, left to right, finding natural runs,
      * and extending short natural runs to minrun elements.
      */
@@ -2141,7 +2404,7 @@ listsort(PyListObject *self, PyObject *args, PyObject *kwds)
         Py_ssize_t n;
 
         /* Identify next run. */
-        n = count_run(lo, hi, compare, &descending);
+        n = count_run(lo, hi, &ms, &descending);
         if (n < 0)
             goto fail;
         if (descending)
@@ -2150,7 +2413,7 @@ listsort(PyListObject *self, PyObject *args, PyObject *kwds)
         if (n < minrun) {
             const Py_ssize_t force = nremaining <= minrun ?
                               nremaining : minrun;
-            if (binarysort(lo, lo + force, lo + n, compare) < 0)
+            if (binarysort(lo, lo + force, lo + n, &ms) < 0)
                 goto fail;
             n = force;
         }
@@ -1199,6 +1199,10 @@ PyObject_Free(void *p)
 #ifdef WITH_VALGRIND
 redirect:
 #endif
+    /* Pyston change: blocks from the slab allocators aren't in our arenas
+       either, and have to go back to their slab. */
+    if (_PySlab_Free(p))
+        return;
     /* We didn't allocate this address. */
     free(p);
 }
@@ -1277,6 +1281,17 @@ PyObject_Realloc(void *p, size_t nbytes)
      * a memory fault can occur if we try to copy nbytes bytes starting
      * at p.  Instead we punt:  let C continue to manage this block.
      */
+    /* Pyston change: except for blocks from the slab allocators, which have
+       a fixed size and have to be moved out of their slab. */
+    size = _PySlab_BlockSize(p);
+    if (size) {
+        bp = PyObject_Malloc(nbytes);
+        if (bp != NULL) {
+            memcpy(bp, p, nbytes < size ? nbytes : size);
+            _PySlab_Free(p);
+        }
+        return bp;
+    }
     if (nbytes)
         return realloc(p, nbytes);
     /* C doesn't define the result of realloc(p, 0) (it may or may not
@@ -47,6 +47,31 @@ fastsearch(const STRINGLIB_CHAR* s, Py_ssize_t n,
     if (w < 0 || (mode == FAST_COUNT && maxcount == 0))
         return -1;
 
+#ifdef STRINGLIB_BYTES_SEARCH
+    /* Pyston change: byte strings use the vectorized kernels from
+       src/runtime/str_search.cpp.  Reverse searches for more than one
+       character still take the path below. */
+    if (m == 1) {
+        if (mode == FAST_SEARCH)
+            return _PyString_FindChar(s, n, p[0]);
+        else if (mode == FAST_RSEARCH)
+            return _PyString_RFindChar(s, n, p[0]);
+        else
+            return _PyString_CountChar(s, n, p[0], maxcount);
+    } else if (m > 1 && mode == FAST_SEARCH) {
+        return _PyString_FindSubstring(s, n, p, m);
+    } else if (m > 1 && mode == FAST_COUNT) {
+        i = 0;
+        while ((j = _PyString_FindSubstring(s + i, n - i, p, m)) >= 0) {
+            count++;
+            if (count == maxcount)
+                return maxcount;
+            i += j + m;
+        }
+        return count;
+    }
+#endif
+
     /* look for special cases */
     if (m <= 1) {
         if (m <= 0)
@@ -67,12 +67,20 @@ stringlib_split_whitespace(PyObject* str_obj,
 
     i = j = 0;
     while (maxcount-- > 0) {
+#ifdef STRINGLIB_BYTES_SEARCH
+        /* Pyston change: skip the whitespace and scan the word with the vectorized kernels */
+        i += _PyString_SpanSpace(str + i, str_len - i);
+        if (i == str_len) break;
+        j = i; i++;
+        i += _PyString_SpanNonSpace(str + i, str_len - i);
+#else
         while (i < str_len && STRINGLIB_ISSPACE(str[i]))
             i++;
         if (i == str_len) break;
         j = i; i++;
         while (i < str_len && !STRINGLIB_ISSPACE(str[i]))
             i++;
+#endif
 #ifndef STRINGLIB_MUTABLE
         if (j == 0 && i == str_len && STRINGLIB_CHECK_EXACT(str_obj)) {
             /* No whitespace in str_obj, so just use it as list[0] */
@@ -88,8 +96,12 @@ stringlib_split_whitespace(PyObject* str_obj,
     if (i < str_len) {
         /* Only occurs when maxcount was reached */
         /* Skip any remaining whitespace and copy to end of string */
+#ifdef STRINGLIB_BYTES_SEARCH
+        i += _PyString_SpanSpace(str + i, str_len - i);
+#else
         while (i < str_len && STRINGLIB_ISSPACE(str[i]))
             i++;
+#endif
         if (i != str_len)
             SPLIT_ADD(str, i, str_len);
     }
@@ -115,6 +127,19 @@ stringlib_split_char(PyObject* str_obj,
         return NULL;
 
     i = j = 0;
+#ifdef STRINGLIB_BYTES_SEARCH
+    /* Pyston change: find the separators with the vectorized kernel */
+    while ((j < str_len) && (maxcount-- > 0)) {
+        Py_ssize_t pos = _PyString_FindChar(str + j, str_len - j, ch);
+        if (pos < 0) {
+            j = str_len;
+            break;
+        }
+        j += pos;
+        SPLIT_ADD(str, i, j);
+        i = j = j + 1;
+    }
+#else
     while ((j < str_len) && (maxcount-- > 0)) {
         for(; j < str_len; j++) {
             /* I found that using memchr makes no difference */
@@ -125,6 +150,7 @@ stringlib_split_char(PyObject* str_obj,
             }
         }
     }
+#endif
 #ifndef STRINGLIB_MUTABLE
     if (count == 0 && STRINGLIB_CHECK_EXACT(str_obj)) {
         /* ch not in str_obj, so just use str_obj as list[0] */
@@ -34,4 +34,7 @@ extern PyObject* EmptyString;
 
 #define STRINGLIB_WANT_CONTAINS_OBJ 1
 
+// Pyston change: use the vectorized search kernels (see fastsearch.h)
+#define STRINGLIB_BYTES_SEARCH   1
+
 #endif /* !STRINGLIB_STRINGDEFS_H */
@@ -446,17 +446,8 @@ return_self(PyStringObject *self)
 Py_LOCAL_INLINE(Py_ssize_t)
 countchar(const char *target, Py_ssize_t target_len, char c, Py_ssize_t maxcount)
 {
-    Py_ssize_t count=0;
-    const char *start=target;
-    const char *end=target+target_len;
-
-    while ( (start=findchar(start, end-start, c)) != NULL ) {
-        count++;
-        if (count >= maxcount)
-            break;
-        start += 1;
-    }
-    return count;
+    // Pyston change: use the vectorized kernel
+    return _PyString_CountChar(target, target_len, c, maxcount);
 }
 
 /* Algorithms for different cases of string replacement */
@@ -0,0 +1,66 @@
+# Measures how much of a pre-forked worker's memory stops being shared with its parent, with and
+# without __pyston__.freeze().  The parent imports django and warms up a template like bm_django.py,
+# then forks workers that each render the template a number of times and report their
+# Private_Dirty memory (pages that were copied on write) from /proc/self/smaps.
+#
+# Usage: fork_freeze_rss.py [freeze|nofreeze] [num_workers]
+
+import os
+import sys
+sys.path.append(os.path.join(os.path.dirname(__file__), "../test/integration/django"))
+
+from django.conf import settings
+settings.configure()
+from django.template import Context, Template
+
+DJANGO_TMPL = Template("""<table>
+{% for row in table %}
+<tr>{% for col in row %}<td>{{ col|escape }}</td>{% endfor %}</tr>
+{% endfor %}
+</table>
+""")
+
+def render(count):
+    table = [xrange(50) for _ in xrange(50)]
+    context = Context({"table": table})
+    for _ in xrange(count):
+        DJANGO_TMPL.render(context)
+
+def private_dirty_kb():
+    total = 0
+    with open("/proc/self/smaps") as f:
+        for line in f:
+            if line.startswith("Private_Dirty:"):
+                total += int(line.split()[1])
+    return total
+
+mode = sys.argv[1] if len(sys.argv) > 1 else "freeze"
+num_workers = int(sys.argv[2]) if len(sys.argv) > 2 else 4
+
+# Warm up in the parent so that the code gets compiled and the ICs get filled in before forking;
+# otherwise every worker would do (and privately own) that work itself.
+render(100)
+
+if mode == "freeze":
+    import __pyston__
+    print "froze %d objects" % __pyston__.freeze()
+
+workers = []
+for i in xrange(num_workers):
+    r, w = os.pipe()
+    pid = os.fork()
+    if pid == 0:
+        os.close(r)
+        before = private_dirty_kb()
+        render(50)
+        after = private_dirty_kb()
+        os.write(w, "%d %d\n" % (before, after))
+        os._exit(0)
+    os.close(w)
+    workers.append((pid, r))
+
+for i, (pid, r) in enumerate(workers):
+    before, after = map(int, os.read(r, 100).split())
+    os.close(r)
+    os.waitpid(pid, 0)
+    print "worker %d: %d kB private after fork, %d kB after rendering" % (i, before, after)
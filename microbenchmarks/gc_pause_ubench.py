@@ -0,0 +1,27 @@
+# Allocation-heavy loop on top of a heap with millions of tracked containers, to compare the
+# collector's pause times with and without incremental collection of the oldest generation.
+# Usage: gc_pause_ubench.py [incremental|full]
+import gc
+import sys
+
+if len(sys.argv) < 2 or sys.argv[1] != "full":
+    gc.set_incremental(True)
+
+heap = [[i, {"i": i}] for i in xrange(1000000)]
+
+def f():
+    cycles = 0
+    for i in xrange(3000000):
+        l = [i]
+        if i % 10 == 0:
+            l.append(l)
+            cycles += 1
+    return cycles
+
+f()
+
+names = ["gen0", "gen1", "gen2", "slices"]
+for name, hist in zip(names, gc.get_pause_histogram()):
+    if sum(hist):
+        worst = max(i for i in xrange(len(hist)) if hist[i])
+        print "%s: %d pauses, longest < %d us" % (name, sum(hist), 2 ** worst)
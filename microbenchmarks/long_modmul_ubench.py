@@ -0,0 +1,13 @@
+# Crypto-style arithmetic on 256- to 2048-bit longs, which churns through GMP temporaries of a few sizes.
+def f():
+    total = 0
+    for bits in (256, 1024, 2048):
+        m = (1 << bits) - 159
+        x = (1 << (bits - 3)) + 12345
+        y = 3 ** (bits // 2)
+        for i in xrange(100000 * 256 // bits):
+            x = (x * y + i) % m
+            y = (y + x) >> 1
+        total += x % 1000003
+    print total
+f()
@@ -0,0 +1,14 @@
+# Arithmetic on longs that only just overflow an int: microsecond timestamps, 64-bit ids and hash mixing.
+def f():
+    t = 1500000000000000L
+    mask = 2 ** 64 - 1
+    h = 14695981039346656037L
+    ids = {}
+    for i in xrange(2000000):
+        t += 1000003
+        h = ((h ^ i) * 1099511628211) & mask
+        if i % 16 == 0:
+            ids[h] = t // 1000000
+        t -= t % 7
+    print len(ids), h % 1000, t % 1000
+f()
@@ -0,0 +1,20 @@
+# find/count/replace/in on long and short strings, with hits near the end and misses.
+def f():
+    long_s = ("the quick brown fox jumps over the lazy dog; " * 200) + "needle in a haystack"
+    short_s = "GET /api/v1/items?id=12345 HTTP/1.1"
+    n = 0
+    for i in xrange(20000):
+        n += long_s.find("needle")
+        n += long_s.find("missing!")
+        n += long_s.find(";", 8000)
+        n += long_s.count("fox")
+        n += long_s.count("o")
+        n += "haystack" in long_s
+        n += len(long_s.replace("lazy", "sleepy"))
+        n += len(long_s.replace(";", ","))
+        for j in xrange(20):
+            n += short_s.find("?")
+            n += short_s.find("HTTP")
+            n += "id=" in short_s
+    print n
+f()
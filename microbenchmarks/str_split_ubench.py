@@ -0,0 +1,12 @@
+# Splitting log lines on whitespace and on a separator character.
+def f():
+    line = "2016-05-04 12:34:56,789 INFO  [worker-12] request_id=8f3a2c GET /api/v1/items?id=12345 200 0.0123s"
+    csv = "12345,foo bar,3.14159,,some longer field value,0,1,2,3,4,5"
+    n = 0
+    for i in xrange(400000):
+        n += len(line.split())
+        n += len(line.split(" "))
+        n += len(csv.split(","))
+        n += len(line.split(None, 3))
+    print n
+f()
@@ -284,7 +284,8 @@ private:
         CompilerType* func = t->getattrType(attr, false);
 
         if (VERBOSITY() >= 2 && func == UNDEF) {
-            printf("Think %s.%s is undefined, at %d\n", t->debugName().c_str(), attr.c_str(), node->lineno);
+            printf("Think %s.%s is undefined, at %d\n", t->debugName().c_str(), attr.c_str(),
+                   block->cfg->getLineno(node));
             print_bst(node, code_constants);
             printf("\n");
         }
@@ -298,7 +299,8 @@ private:
         CompilerType* func = t->getattrType(attr, true);
 
         if (VERBOSITY() >= 2 && func == UNDEF) {
-            printf("Think %s.%s is undefined, at %d\n", t->debugName().c_str(), attr.c_str(), node->lineno);
+            printf("Think %s.%s is undefined, at %d\n", t->debugName().c_str(), attr.c_str(),
+                   block->cfg->getLineno(node));
             print_bst(node, code_constants);
             printf("\n");
         }
@@ -402,7 +404,8 @@ private:
         }
 
         if (VERBOSITY() >= 2 && rtn == UNDEF) {
-            printf("Think %s.%s is undefined, at %d\n", t->debugName().c_str(), attr.c_str(), node->lineno);
+            printf("Think %s.%s is undefined, at %d\n", t->debugName().c_str(), attr.c_str(),
+                   block->cfg->getLineno(node));
             print_bst(node, code_constants);
             printf("\n");
         }
@@ -275,6 +275,26 @@ void Rewriter::assertArgsInPlace() {
     }
 }
 
+static StatCounter rewriter_peephole_guards_merged("rewriter_peephole_guards_merged");
+static StatCounter rewriter_peephole_loads_reused("rewriter_peephole_loads_reused");
+static StatCounter rewriter_peephole_dead_loads("rewriter_peephole_dead_loads");
+static StatCounter rewriter_peephole_movs_folded("rewriter_peephole_movs_folded");
+
+bool RewriterVar::isRedundantGuard(uint64_t val, bool negate) {
+    if (!ENABLE_REWRITER_PEEPHOLE)
+        return false;
+
+    for (auto&& g : guards) {
+        // Exact duplicate:
+        if (g.first == val && g.second == negate)
+            return true;
+        // We already checked that the var is equal to some other value, so it can't be equal to val:
+        if (negate && !g.second && g.first != val)
+            return true;
+    }
+    return false;
+}
+
 void RewriterVar::addGuard(uint64_t val) {
     STAT_TIMER(t0, "us_timer_rewriter", 10);
 
@@ -283,6 +303,12 @@ void RewriterVar::addGuard(uint64_t val) {
         return;
     }
 
+    if (isRedundantGuard(val, false)) {
+        rewriter_peephole_guards_merged.log();
+        return;
+    }
+    guards.push_back(std::make_pair(val, false));
+
     RewriterVar* val_var = rewriter->loadConst(val);
     rewriter->addAction([=]() { rewriter->_addGuard(this, val_var); }, { this, val_var }, ActionType::GUARD);
 }
@@ -340,12 +366,30 @@ void Rewriter::_addGuard(RewriterVar* var, RewriterVar* val_constant, bool negat
 void RewriterVar::addGuardNotEq(uint64_t val) {
     STAT_TIMER(t0, "us_timer_rewriter", 10);
 
+    if (isConstant() && ENABLE_REWRITER_PEEPHOLE) {
+        RELEASE_ASSERT(constant_value != val, "added guard which is always false");
+        rewriter_peephole_guards_merged.log();
+        return;
+    }
+
+    if (isRedundantGuard(val, true)) {
+        rewriter_peephole_guards_merged.log();
+        return;
+    }
+    guards.push_back(std::make_pair(val, true));
+
     RewriterVar* val_var = rewriter->loadConst(val);
     rewriter->addAction([=]() { rewriter->_addGuard(this, val_var, true /* negate */); }, { this, val_var },
                         ActionType::GUARD);
 }
 
 void RewriterVar::addGuardNotLt0() {
+    if (guarded_not_lt0 && ENABLE_REWRITER_PEEPHOLE) {
+        rewriter_peephole_guards_merged.log();
+        return;
+    }
+    guarded_not_lt0 = true;
+
     rewriter->addAction([=]() {
         assembler::Register var_reg = this->getInReg();
         rewriter->assembler->test(var_reg, var_reg);
@@ -367,6 +411,16 @@ void RewriterVar::addAttrGuard(int offset, uint64_t val, bool negate) {
     if (!attr_guards.insert(std::make_tuple(offset, val, negate)).second)
         return; // duplicate guard detected
 
+    // If the attribute was already loaded and that value got guarded on, this guard is implied by that one.
+    if (ENABLE_REWRITER_PEEPHOLE) {
+        auto it = getattrs.find(std::make_pair(offset, (int)assembler::MovType::Q));
+        if (it != getattrs.end() && it->second.second == rewriter->mutation_epoch
+            && it->second.first->isRedundantGuard(val, negate)) {
+            rewriter_peephole_guards_merged.log();
+            return;
+        }
+    }
+
     RewriterVar* val_var = rewriter->loadConst(val);
     rewriter->addAction([=]() { rewriter->_addAttrGuard(this, offset, val_var, negate); }, { this, val_var },
                         ActionType::GUARD);
@@ -416,18 +470,22 @@ void Rewriter::_addAttrGuard(RewriterVar* var, int offset, RewriterVar* val_cons
 RewriterVar* RewriterVar::getAttr(int offset, Location dest, assembler::MovType type) {
     STAT_TIMER(t0, "us_timer_rewriter", 10);
 
-    // if no changing action happened we can reuse get attributes
-    if (!rewriter->added_changing_action) {
-        RewriterVar*& result = getattrs[std::make_pair(offset, (int)type)];
-        if (result) {
+    // if no changing action happened (since the last load of this attribute) we can reuse get attributes
+    if (!rewriter->added_changing_action || rewriter->load_cse_across_mutations) {
+        std::pair<RewriterVar*, int>& entry = getattrs[std::make_pair(offset, (int)type)];
+        if (entry.first && entry.second == rewriter->mutation_epoch) {
+            if (rewriter->added_changing_action)
+                rewriter_peephole_loads_reused.log();
             if (dest != Location::any())
-                result->getInReg(dest, true /* allow_constant_in_reg */);
+                entry.first->getInReg(dest, true /* allow_constant_in_reg */);
         } else {
-            result = rewriter->createNewVar();
+            RewriterVar* result = rewriter->createNewVar();
             rewriter->addAction([=]() { rewriter->_getAttr(result, this, offset, dest, type); }, { this },
                                 ActionType::NORMAL);
+            // (recorded after the action got added, since adding it can bump the epoch)
+            entry = std::make_pair(result, rewriter->mutation_epoch);
         }
-        return result;
+        return entry.first;
     }
 
     RewriterVar* result = rewriter->createNewVar();
@@ -439,6 +497,16 @@ void Rewriter::_getAttr(RewriterVar* result, RewriterVar* ptr, int offset, Locat
     if (LOG_IC_ASSEMBLY)
         assembler->comment("_getAttr");
 
+    // Loads don't have side effects, so if nothing ends up using the result we don't need to emit anything.
+    // (An unused owned result still has to be loaded, since releasing it is what emits its decref.)
+    if (ENABLE_REWRITER_PEEPHOLE && result->uses.empty() && result->reftype != RefType::OWNED) {
+        rewriter_peephole_dead_loads.log();
+        ptr->bumpUse();
+        result->releaseIfNoUses();
+        assertConsistent();
+        return;
+    }
+
     // TODO if var is a constant, we will end up emitting something like
     //   mov $0x123, %rax
     //   mov $0x10(%rax), %rdi
@@ -558,6 +626,10 @@ void Rewriter::_incref(RewriterVar* var, int num_refs) {
         assembler->incq(assembler::Immediate(&_Py_RefTotal));
 #endif
 
+    // Objects don't stop being immortal, so we can skip the refcount write entirely:
+    if (var->isConstant() && _Py_IsImmortal((Box*)var->constant_value))
+        return;
+
     if (var->isConstant() && !Rewriter::isLargeConstant(var->constant_value)) {
         for (int i = 0; i < num_refs; i++) {
             assembler->incq(assembler::Immediate((uint64_t)var->constant_value + offsetof(Box, ob_refcnt)));
@@ -585,6 +657,14 @@ void Rewriter::_decref(RewriterVar* var, llvm::ArrayRef<RewriterVar*> vars_to_bu
     // assembler->trap();
     assembler->decq(assembler::Immediate(&_Py_RefTotal));
 #endif
+
+    if (var->isConstant() && _Py_IsImmortal((Box*)var->constant_value)) {
+        for (auto&& use : vars_to_bump) {
+            use->bumpUseLateIfNecessary();
+        }
+        return;
+    }
+
     _setupCall(true, { var }, {}, assembler::RAX, vars_to_bump);
 
 
@@ -599,14 +679,8 @@ void Rewriter::_decref(RewriterVar* var, llvm::ArrayRef<RewriterVar*> vars_to_bu
     assembler->decq(assembler::Indirect(reg, offsetof(Box, ob_refcnt)));
     {
         assembler::ForwardJump jnz(*assembler, assembler::COND_NOT_ZERO);
-#ifdef Py_TRACE_REFS
-        _callOptimalEncoding(assembler::R11, (void*)_Py_Dealloc);
-#else
-        assembler->movq(assembler::Indirect(reg, offsetof(Box, cls)), assembler::RAX);
-        assembler->callq(assembler::Indirect(assembler::RAX, offsetof(BoxedClass, tp_dealloc)));
-#endif
-        // assembler->mov(assembler::Indirect(assembler::RAX, offsetof(BoxedClass, tp_dealloc)), assembler::R11);
-        // assembler->callq(assembler::R11);
+        // Not inlined, so that the per-type live object counts get updated:
+        _callOptimalEncoding(assembler::R11, (void*)_Py_DeallocFunc);
     }
 
     // Doesn't call bumpUse, since this function is designed to be callable from other emitting functions.
@@ -1795,11 +1869,16 @@ void Rewriter::_add(RewriterVar* result, RewriterVar* a, int64_t b, Location des
 
     result->initializeInReg(newvar_reg);
 
-    assembler->mov(a_reg, newvar_reg);
-
     // TODO we can't rely on this being true, so we need to support the full version
     assert(!isLargeConstant(b));
-    assembler->add(assembler::Immediate(b), newvar_reg);
+    if (ENABLE_REWRITER_PEEPHOLE) {
+        // A single lea is shorter than the mov+add pair, and nothing depends on the flags that add would set.
+        rewriter_peephole_movs_folded.log();
+        assembler->lea(assembler::Indirect(a_reg, b), newvar_reg);
+    } else {
+        assembler->mov(a_reg, newvar_reg);
+        assembler->add(assembler::Immediate(b), newvar_reg);
+    }
 
     a->bumpUse();
 
@@ -2222,6 +2301,8 @@ Rewriter::Rewriter(std::unique_ptr<ICSlotRewrite> rewrite, int num_args, const L
       needs_invalidation_support(needs_invalidation_support),
       current_action_idx(-1),
       added_changing_action(false),
+      mutation_epoch(0),
+      load_cse_across_mutations(ENABLE_REWRITER_PEEPHOLE),
       marked_inside_ic(false),
       done_guarding(false),
       last_guard_action(-1),
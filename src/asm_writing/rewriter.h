@@ -268,8 +268,14 @@ private:
     Location arg_loc;
     std::pair<int /*offset*/, int /*size*/> scratch_allocation;
 
-    llvm::SmallSet<std::tuple<int, uint64_t, bool>, 4> attr_guards;  // used to detect duplicate guards
-    llvm::SmallDenseMap<std::pair<int, int>, RewriterVar*> getattrs; // used to detect duplicate getAttrs
+    llvm::SmallSet<std::tuple<int, uint64_t, bool>, 4> attr_guards; // used to detect duplicate guards
+    llvm::SmallVector<std::pair<uint64_t, bool>, 2> guards;          // used to detect redundant addGuard calls
+    bool guarded_not_lt0 = false;
+    // Returns whether an equivalent (or stronger) guard has already been added to this var.
+    bool isRedundantGuard(uint64_t val, bool negate);
+    // used to detect duplicate getAttrs.  The second element is the Rewriter::mutation_epoch the load was
+    // added in: a load can only be reused as long as no changing action got added in between.
+    llvm::SmallDenseMap<std::pair<int, int>, std::pair<RewriterVar*, int>> getattrs;
 
     // Gets a copy of this variable in a register, spilling/reloading if necessary.
     // TODO have to be careful with the result since the interface doesn't guarantee
@@ -474,10 +480,18 @@ protected:
 
     template <typename F> RewriterAction* addAction(F&& action, llvm::ArrayRef<RewriterVar*> vars, ActionType type) {
         assertPhaseCollecting();
+        bool may_decref = false;
         for (RewriterVar* var : vars) {
             assert(var != NULL);
             var->uses.push_back(actions.size());
+            // This could turn out to be the last use of an owned reference, in which case the var gets decref'd
+            // right after this action.  That can run arbitrary code (__del__, tp_dealloc), so loads from before
+            // this point must not be reused after it.
+            if (var->reftype == RefType::OWNED)
+                may_decref = true;
         }
+        if (type == ActionType::MUTATION || may_decref)
+            mutation_epoch++;
         if (type == ActionType::MUTATION) {
             added_changing_action = true;
         } else if (type == ActionType::GUARD) {
@@ -500,6 +514,12 @@ protected:
     }
 
     bool added_changing_action;
+    // Gets incremented for every changing action and for every action that might decref an owned var; used to
+    // scope the reuse of loaded attributes.
+    int mutation_epoch;
+    // Whether getAttr() results may be reused after a changing action got added (as long as there was no
+    // other changing action between the two loads).  Controlled by ENABLE_REWRITER_PEEPHOLE.
+    bool load_cse_across_mutations;
     bool marked_inside_ic;
     std::vector<void*> gc_references;
     std::vector<std::pair<uint64_t, std::vector<Location>>> decref_infos;
@@ -1217,6 +1217,12 @@ extern "C" void _PyTrash_thread_destroy_chain() noexcept {
     }
 }
 
+// The JITs call this instead of inlining the _Py_Dealloc macro, so that the per-type accounting
+// (and COUNT_ALLOCS / Py_TRACE_REFS bookkeeping) stays in one place.
+extern "C" void _Py_DeallocFunc(PyObject* op) noexcept {
+    _Py_Dealloc(op);
+}
+
 #ifdef Py_TRACE_REFS
 /* Head of circular doubly-linked list of all objects.  These are linked
  * together via the _ob_prev and _ob_next members of a PyObject, which
@@ -1263,6 +1269,7 @@ extern "C" void _Py_NewReference(PyObject* op) noexcept {
     op->ob_refcnt = 1;
     _Py_AddToAllObjects(op, 1);
     _Py_INC_TPALLOCS(op);
+    _Py_INC_LIVE(op);
 }
 
 extern "C" void _Py_ForgetReference(register PyObject* op) noexcept {
@@ -1285,6 +1292,7 @@ extern "C" void _Py_ForgetReference(register PyObject* op) noexcept {
     op->_ob_prev->_ob_next = op->_ob_next;
     op->_ob_next = op->_ob_prev = NULL;
     _Py_INC_TPFREES(op);
+    _Py_DEC_LIVE(op);
 }
 
 extern "C" void _Py_Dealloc(PyObject* op) noexcept {
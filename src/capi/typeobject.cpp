@@ -2277,7 +2277,7 @@ static int extra_ivars(PyTypeObject* type, PyTypeObject* base) noexcept {
 
     // Pyston change:
     if (type->instancesHaveHCAttrs() && !base->instancesHaveHCAttrs())
-        t_size -= sizeof(HCAttrs);
+        t_size -= sizeof(HCAttrs) + type->num_inline_attrs * sizeof(Box*);
 
     return t_size != b_size;
 }
@@ -3160,7 +3160,7 @@ static int equiv_structs(PyTypeObject* a, PyTypeObject* b) noexcept {
     //                   && ((a->tp_flags & Py_TPFLAGS_HAVE_GC) == (b->tp_flags & Py_TPFLAGS_HAVE_GC)));
     return a == b || (a != NULL && b != NULL && a->tp_basicsize == b->tp_basicsize && a->tp_itemsize == b->tp_itemsize
                       && a->tp_dictoffset == b->tp_dictoffset && a->tp_weaklistoffset == b->tp_weaklistoffset
-                      && a->attrs_offset == b->attrs_offset
+                      && a->attrs_offset == b->attrs_offset && a->num_inline_attrs == b->num_inline_attrs
                       && ((a->tp_flags & Py_TPFLAGS_HAVE_GC) == (b->tp_flags & Py_TPFLAGS_HAVE_GC)));
 }
 
@@ -3184,8 +3184,8 @@ static int same_slots_added(PyTypeObject* a, PyTypeObject* b) noexcept {
     if (a->tp_dictoffset == size && b->tp_dictoffset == size)
         size += sizeof(PyObject*);
     // Pyston change: have to check attrs_offset
-    if (a->attrs_offset == size && b->attrs_offset == size)
-        size += sizeof(HCAttrs);
+    if (a->attrs_offset == size && b->attrs_offset == size && a->num_inline_attrs == b->num_inline_attrs)
+        size += sizeof(HCAttrs) + a->num_inline_attrs * sizeof(Box*);
     if (a->tp_weaklistoffset == size && b->tp_weaklistoffset == size)
         size += sizeof(PyObject*);
 
@@ -3646,6 +3646,7 @@ extern "C" int PyType_Ready(PyTypeObject* cls) noexcept {
         // These doesn't get copied in inherit_slots like other slots do.
         if (cls->tp_base->instancesHaveHCAttrs()) {
             cls->attrs_offset = cls->tp_base->attrs_offset;
+            cls->num_inline_attrs = cls->tp_base->num_inline_attrs;
         }
 
         // Example of when this code path could be reached and needs to be:
@@ -795,13 +795,44 @@ Value ASTInterpreter::executeStmt(BST_stmt* node) {
     return v;
 }
 
+// For `name += value` on a local, the CFG emits the augbinop directly followed by the store of its
+// result back into the name.  Returns that store, or NULL if this augbinop is something else.
+static BST_StoreName* getAugAssignLocalStore(BST_AugBinOp* node) {
+    BST_stmt* next;
+    if (node->is_invoke())
+        next = node->get_normal_block()->body();
+    else
+        next = (BST_stmt*)&((unsigned char*)node)[node->size_in_bytes()];
+
+    if (!next || next->type() != BST_TYPE::StoreName)
+        return NULL;
+    BST_StoreName* store = (BST_StoreName*)next;
+    if (store->lookup_type != ScopeInfo::VarScopeType::FAST || store->vreg_value != node->vreg_dst)
+        return NULL;
+    return store;
+}
+
 Value ASTInterpreter::visit_augBinOp(BST_AugBinOp* node) {
     assert(node->op_type != AST_TYPE::Is && node->op_type != AST_TYPE::IsNot && "not tested yet");
 
     Value left = getVReg(node->vreg_left);
-    AUTO_DECREF(left.o);
     Value right = getVReg(node->vreg_right);
     AUTO_DECREF(right.o);
+
+    // `s += piece` on a local str: let augbinopLocal append to the string in place if the variable
+    // holds the only other reference.  The baseline JIT can only do this if it keeps the variable
+    // in the vregs array, and only does it for sites that see a str, so that other types still get
+    // the augbinop IC.
+    if (node->op_type == AST_TYPE::Add && left.o->cls == str_cls) {
+        BST_StoreName* store = getAugAssignLocalStore(node);
+        if (store && (!jit || getLiveness()->isLiveAtEnd(store->vreg, current_block))) {
+            frame_info.num_vregs = std::max(frame_info.num_vregs, store->vreg + 1);
+            RewriterVar* jit_rtn = jit ? jit->emitAugbinopLocal(left, right, node->op_type, store->vreg) : NULL;
+            return Value(augbinopLocal(left.o, right.o, node->op_type, vregs, store->vreg), jit_rtn);
+        }
+    }
+
+    AUTO_DECREF(left.o);
     return doBinOp(node, left, right, node->op_type, BinExpType::AugBinOp);
 }
 
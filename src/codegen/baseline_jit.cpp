@@ -193,6 +193,7 @@ JitFragmentWriter::JitFragmentWriter(BoxedCode* code, CFGBlock* block, std::uniq
       known_non_null_vregs(std::move(known_non_null_vregs)) {
 
     added_changing_action = true;
+    load_cse_across_mutations = false;
 
     if (LOG_BJIT_ASSEMBLY)
         comment("BJIT: JitFragmentWriter() start");
@@ -231,6 +232,15 @@ RewriterVar* JitFragmentWriter::emitAugbinop(BST_stmt* node, RewriterVar* lhs, R
         .first->setType(RefType::OWNED);
 }
 
+RewriterVar* JitFragmentWriter::emitAugbinopLocal(STOLEN(RewriterVar*) lhs, RewriterVar* rhs, int op_type, int vreg) {
+    // augbinopLocal may clear the vreg when it takes over the variable's reference
+    known_non_null_vregs.erase(vreg);
+    RewriterVar* rtn
+        = call(true, (void*)augbinopLocal, lhs, rhs, imm(op_type), vregs_array, imm(vreg))->setType(RefType::OWNED);
+    lhs->refConsumed();
+    return rtn;
+}
+
 RewriterVar* JitFragmentWriter::emitApplySlice(RewriterVar* target, RewriterVar* lower, RewriterVar* upper) {
     if (!lower)
         lower = imm(0ul);
@@ -364,6 +374,15 @@ RewriterVar* JitFragmentWriter::emitCreateTuple(const llvm::ArrayRef<RewriterVar
         r = call(false, (void*)BoxedTuple::create2, values[0], values[1])->setType(RefType::OWNED);
     else if (num == 3)
         r = call(false, (void*)BoxedTuple::create3, values[0], values[1], values[2])->setType(RefType::OWNED);
+    else if (num == 4)
+        r = call(false, (void*)BoxedTuple::create4, values[0], values[1], values[2], values[3])
+                ->setType(RefType::OWNED);
+    else if (num == 5)
+        r = call(false, (void*)BoxedTuple::create5, values[0], values[1], values[2], values[3], values[4])
+                ->setType(RefType::OWNED);
+    else if (num == 6)
+        r = call(false, (void*)BoxedTuple::create6, values[0], values[1], values[2], values[3], values[4],
+                 values[5])->setType(RefType::OWNED);
     else {
         r = emitCallWithAllocatedArgs((void*)createTupleHelper,
                                       { imm(num), allocArgs(values, RewriterVar::SetattrType::REF_USED) },
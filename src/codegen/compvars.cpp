@@ -1889,7 +1889,7 @@ public:
         RELEASE_ASSERT(paramspec.num_args == code->numReceivedArgs(), "");
         RELEASE_ASSERT(args.size() + 1 >= paramspec.num_args - paramspec.num_defaults
                            && args.size() + 1 <= paramspec.num_args,
-                       "%d", info.unw_info.current_stmt->lineno);
+                       "%d", info.unw_info.code->source->cfg->getLineno(info.unw_info.current_stmt));
 
         CompiledFunction* cf = NULL;
         CompiledFunction* best_exception_mismatch = NULL;
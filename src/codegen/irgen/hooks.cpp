@@ -224,7 +224,7 @@ CompiledFunction* compileFunction(BoxedCode* code, FunctionSpecialization* spec,
     return cf;
 }
 
-void compileAndRunModule(AST_Module* m, BoxedModule* bm) {
+void compileAndRunModule(AST_Module* m, std::unique_ptr<ASTAllocator> ast_allocator, BoxedModule* bm) {
     Timer _t("for compileModule()");
 
     const char* fn = PyModule_GetFilename(bm);
@@ -234,6 +234,10 @@ void compileAndRunModule(AST_Module* m, BoxedModule* bm) {
     BoxedCode* code = computeAllCFGs(m, /* globals_from_module */ true, future_flags, autoDecref(boxString(fn)), bm);
     AUTO_DECREF(code);
 
+    // All the functions in the module have their BST now; the AST isn't needed anymore, and shouldn't stay alive
+    // while the module body runs (which, for the main module, is the lifetime of the process).
+    ast_allocator.reset();
+
     static BoxedString* doc_str = getStaticString("__doc__");
     bm->setattr(doc_str, code->_doc, NULL);
 
@@ -15,6 +15,7 @@
 #ifndef PYSTON_CODEGEN_IRGEN_HOOKS_H
 #define PYSTON_CODEGEN_IRGEN_HOOKS_H
 
+#include <memory>
 #include <string>
 
 #include "core/types.h"
@@ -32,8 +33,11 @@ extern "C" CompiledFunction* reoptCompiledFuncInternal(CompiledFunction*);
 extern "C" char* reoptCompiledFunc(CompiledFunction*);
 
 class AST_Module;
+class ASTAllocator;
 class BoxedModule;
-void compileAndRunModule(AST_Module* m, BoxedModule* bm);
+// Takes ownership of the module's AST so that it can be freed once it has been turned into BST, before the module
+// body starts running.
+void compileAndRunModule(AST_Module* m, std::unique_ptr<ASTAllocator> ast_allocator, BoxedModule* bm);
 
 // will we always want to generate unique function names? (ie will this function always be reasonable?)
 CompiledFunction* cfForMachineFunctionName(const std::string&);
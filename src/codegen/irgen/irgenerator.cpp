@@ -784,6 +784,8 @@ private:
     std::unordered_map<CFGBlock*, llvm::BasicBlock*>& entry_blocks;
     CFGBlock* myblock;
     TypeAnalysis* types;
+    // for the debug locations of the statements of myblock
+    LineTable::Cursor line_cursor;
 
     // These are some special values used for passing exception data between blocks;
     // this transfer is not explicitly represented in the CFG which is why it has special
@@ -814,6 +816,7 @@ public:
           entry_blocks(entry_blocks),
           myblock(myblock),
           types(types),
+          line_cursor(myblock->cfg->lines),
           state(RUNNING) {}
 
     virtual CFGBlock* getCFGBlock() override { return myblock; }
@@ -2397,11 +2400,13 @@ private:
         endBlock(DEAD);
     }
 
+    int getLineno(BST_stmt* node) { return line_cursor.getLineno(irstate->getCFG()->bytecode.getOffset(node)); }
+
     void doStmt(BST_stmt* node, const UnwindInfo& unw_info) {
-        // printf("%d stmt: %d\n", node->type, node->lineno);
-        if (node->lineno) {
-            emitter.getBuilder()->SetCurrentDebugLocation(
-                llvm::DebugLoc::get(node->lineno, 0, irstate->getFuncDbgInfo()));
+        int lineno = getLineno(node);
+        // printf("%d stmt: %d\n", node->type, lineno);
+        if (lineno) {
+            emitter.getBuilder()->SetCurrentDebugLocation(llvm::DebugLoc::get(lineno, 0, irstate->getFuncDbgInfo()));
         }
 
         switch (node->type()) {
@@ -2942,7 +2947,7 @@ public:
             assert(state != FINISHED);
 
 #if ENABLE_SAMPLING_PROFILER
-            if (stmt->type != BST_TYPE::Landigpad && stmt->lineno > 0)
+            if (stmt->type != BST_TYPE::Landigpad && getLineno(stmt) > 0)
                 doSafePoint(stmt);
 #endif
             if (stmt->is_invoke()) {
@@ -204,6 +204,24 @@ llvm::Instruction* findInsertionPoint(llvm::BasicBlock* BB, llvm::BasicBlock* fr
 #define REFCOUNT_IDX 0
 #endif
 
+// Returns whether v is a pointer to an immortal object that got embedded into the IR.  Objects don't stop being
+// immortal, so we don't need to emit refcount operations on those.
+static bool isImmortalConstant(llvm::Value* v) {
+    v = v->stripPointerCasts();
+
+    const void* addr = NULL;
+    if (auto ce = llvm::dyn_cast<llvm::ConstantExpr>(v)) {
+        if (ce->getOpcode() == llvm::Instruction::IntToPtr) {
+            if (auto ci = llvm::dyn_cast<llvm::ConstantInt>(ce->getOperand(0)))
+                addr = (const void*)ci->getZExtValue();
+        }
+    } else if (auto gv = llvm::dyn_cast<llvm::GlobalVariable>(v)) {
+        addr = getValueOfRelocatableSym(gv->getName());
+    }
+
+    return addr && _Py_IsImmortal((Box*)addr);
+}
+
 void addIncrefs(llvm::Value* v, bool nullable, int num_refs, llvm::Instruction* incref_pt) {
     if (num_refs > 1) {
         // Not bad but I don't think this should happen:
@@ -218,6 +236,8 @@ void addIncrefs(llvm::Value* v, bool nullable, int num_refs, llvm::Instruction*
 
     assert(num_refs > 0);
 
+    bool immortal = isImmortalConstant(v);
+
     llvm::BasicBlock* cur_block;
     llvm::BasicBlock* continue_block = NULL;
     llvm::BasicBlock* incref_block;
@@ -252,10 +272,12 @@ void addIncrefs(llvm::Value* v, bool nullable, int num_refs, llvm::Instruction*
     builder.CreateStore(new_reftotal, reftotal_gv);
 #endif
 
-    auto refcount_ptr = builder.CreateConstInBoundsGEP2_32(v, 0, REFCOUNT_IDX);
-    auto refcount = builder.CreateLoad(refcount_ptr);
-    auto new_refcount = builder.CreateAdd(refcount, getConstantInt(num_refs, g.i64));
-    builder.CreateStore(new_refcount, refcount_ptr);
+    if (!immortal) {
+        auto refcount_ptr = builder.CreateConstInBoundsGEP2_32(v, 0, REFCOUNT_IDX);
+        auto refcount = builder.CreateLoad(refcount_ptr);
+        auto new_refcount = builder.CreateAdd(refcount, getConstantInt(num_refs, g.i64));
+        builder.CreateStore(new_refcount, refcount_ptr);
+    }
 
     if (nullable)
         builder.CreateBr(continue_block);
@@ -299,6 +321,15 @@ void addDecrefs(llvm::Value* v, bool nullable, int num_refs, llvm::Instruction*
 
     RELEASE_ASSERT(num_refs == 1, "decref patchpoints don't support >1 refs");
 
+    if (isImmortalConstant(v)) {
+#ifdef Py_REF_DEBUG
+        auto reftotal_gv = g.cur_module->getOrInsertGlobal("_Py_RefTotal", g.i64);
+        auto reftotal = builder.CreateLoad(reftotal_gv);
+        builder.CreateStore(builder.CreateSub(reftotal, getConstantInt(num_refs, g.i64)), reftotal_gv);
+#endif
+        return;
+    }
+
     llvm::Function* patchpoint
         = llvm::Intrinsic::getDeclaration(g.cur_module, llvm::Intrinsic::experimental_patchpoint_void);
     int pp_id = nullable ? XDECREF_PP_ID : DECREF_PP_ID;
@@ -345,25 +376,9 @@ void addDecrefs(llvm::Value* v, bool nullable, int num_refs, llvm::Instruction*
 
     builder.SetInsertPoint(dealloc_block);
 
-#ifdef COUNT_ALLOCS
-#error "Don't support COUNT_ALLOCS here yet"
-#endif
-
-#ifdef Py_TRACE_REFS
-    builder.CreateCall(g.funcs._Py_Dealloc, v);
-#else
-    auto cls_ptr = builder.CreateConstInBoundsGEP2_32(v, 0, 1 + REFCOUNT_IDX);
-    auto cls = builder.CreateLoad(cls_ptr);
-    auto dtor_ptr = builder.CreateConstInBoundsGEP2_32(cls, 0, 4);
-
-#ifndef NDEBUG
-    llvm::APInt offset(64, 0, true);
-    assert(llvm::cast<llvm::GetElementPtrInst>(dtor_ptr)->accumulateConstantOffset(*g.tm->getDataLayout(), offset));
-    assert(offset.getZExtValue() == offsetof(BoxedClass, tp_dealloc));
-#endif
-    auto dtor = builder.CreateLoad(dtor_ptr);
-    builder.CreateCall(dtor, v);
-#endif
+    // Goes through _Py_DeallocFunc rather than calling tp_dealloc directly, so that the per-type live
+    // object counts (and COUNT_ALLOCS / Py_TRACE_REFS bookkeeping) get updated.
+    builder.CreateCall(g.funcs._Py_DeallocFunc, v);
 
     builder.CreateBr(continue_block);
 
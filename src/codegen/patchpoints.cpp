@@ -151,20 +151,32 @@ static LiveOutSet extractLiveOuts(StackMap::Record* r, llvm::CallingConv::ID cc)
 
 #if !defined(Py_REF_DEBUG) && !defined(Py_TRACE_REFS)
 
-static char decref_code[] = "\x48\xff\x0f"     // decq (%rdi)
-                            "\x75\x07"         // jne +7
-                            "\x48\x8b\x47\x08" // mov 0x8(%rdi),%rax
-                            "\xff\x50\x30"     // callq *0x30(%rax)
+// The dealloc goes through _Py_DeallocFunc so that the per-type live object counts get updated.
+static char decref_code[] = "\x48\xff\x0f"                             // decq (%rdi)
+                            "\x75\x0c"                                 // jne +12
+                            "\x48\xb8\x00\x00\x00\x00\x00\x00\x00\x00" // movabs $0x00, %rax
+                            "\xff\xd0"                                 // callq *%rax
     ;
 
-static char xdecref_code[] = "\x48\x85\xff"     // test %rdi,%rdi
-                             "\x74\x0c"         // je +12
-                             "\x48\xff\x0f"     // decq (%rdi)
-                             "\x75\x07"         // jne +7
-                             "\x48\x8b\x47\x08" // mov 0x8(%rdi),%rax
-                             "\xff\x50\x30"     // callq *0x30(%rax)
+static char xdecref_code[] = "\x48\x85\xff"                             // test %rdi,%rdi
+                             "\x74\x11"                                 // je +17
+                             "\x48\xff\x0f"                             // decq (%rdi)
+                             "\x75\x0c"                                 // jne +12
+                             "\x48\xb8\x00\x00\x00\x00\x00\x00\x00\x00" // movabs $0x00, %rax
+                             "\xff\xd0"                                 // callq *%rax
     ;
 
+namespace {
+class _Initializer {
+public:
+    _Initializer() {
+        void* p = (void*)&_Py_DeallocFunc;
+        memcpy(decref_code + 7, &p, sizeof(p));
+        memcpy(xdecref_code + 12, &p, sizeof(p));
+    }
+} _i;
+}
+
 #else
 
 static void _decref(Box* b) {
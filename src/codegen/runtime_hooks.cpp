@@ -329,8 +329,6 @@ void initGlobalFuncs(GlobalState& g) {
 
     GET(dump);
 
-#ifdef Py_TRACE_REFS
-    GET(_Py_Dealloc);
-#endif
+    GET(_Py_DeallocFunc);
 }
 }
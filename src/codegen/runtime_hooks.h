@@ -60,9 +60,7 @@ struct GlobalFuncs {
 
     llvm::Value* dump;
 
-#ifdef Py_TRACE_REFS
-    llvm::Value* _Py_Dealloc;
-#endif
+    llvm::Value* _Py_DeallocFunc;
 };
 }
 
@@ -488,9 +488,7 @@ bool frameIsPythonFrame(unw_word_t ip, unw_word_t bp, unw_cursor_t* cursor, Pyth
 static const LineInfo lineInfoForFrameInfo(FrameInfo* frame_info) {
     auto* code = frame_info->code;
     assert(code);
-    BST_stmt* current_stmt = code->source->cfg->getStmtFromOffset(frame_info->stmt_offset);
-
-    return LineInfo(current_stmt->lineno, code->filename, code->name);
+    return LineInfo(code->source->cfg->getLineno(frame_info->stmt_offset), code->filename, code->name);
 }
 
 // A class that converts a C stack trace to a Python stack trace.
@@ -1069,9 +1067,7 @@ std::string getCurrentPythonLine() {
         auto* code = frame_info->code;
         auto source = code->source.get();
 
-        auto current_stmt = source->cfg->getStmtFromOffset(frame_info->stmt_offset);
-
-        stream << code->filename->c_str() << ":" << current_stmt->lineno;
+        stream << code->filename->c_str() << ":" << source->cfg->getLineno(frame_info->stmt_offset);
         return stream.str();
     }
     return "unknown:-1";
@@ -14,6 +14,7 @@
 
 #include "core/ast.h"
 
+#include <algorithm>
 #include <cassert>
 #include <cstdio>
 #include <cstdlib>
@@ -23,6 +24,7 @@
 #include "Python.h"
 
 #include "core/cfg.h"
+#include "core/stats.h"
 #include "runtime/types.h"
 
 namespace pyston {
@@ -37,6 +39,41 @@ AST::AST(AST_TYPE::AST_TYPE type) : type(type), lineno(++next_lineno) {
 
 #endif
 
+void* ASTAllocator::allocateSlow(int size) {
+    int chunk_size = std::max(next_chunk_size, (int)llvm::NextPowerOf2(size + sizeof(Chunk) - 1));
+    if (next_chunk_size < max_chunk_size)
+        next_chunk_size *= 2;
+
+    Chunk* chunk = (Chunk*)malloc(chunk_size);
+    RELEASE_ASSERT(chunk, "");
+    chunk->prev = cur;
+    chunk->size = chunk_size - sizeof(Chunk);
+    chunk->num_bytes_used = size;
+    cur = chunk;
+    num_bytes += size;
+
+    static StatCounter ast_bytes("num_ast_bytes");
+    ast_bytes.log(chunk_size);
+
+    return chunk->data();
+}
+
+ASTAllocator::~ASTAllocator() {
+    while (cur) {
+        // find all AST* nodes and call the virtual destructor
+        for (int current_pos = 0; current_pos < cur->num_bytes_used;) {
+            AST* node = (AST*)&cur->data()[current_pos];
+            int node_size = node->getSize();
+            node->~AST();
+            current_pos += llvm::RoundUpToAlignment(node_size, alignment);
+        }
+
+        Chunk* prev = cur->prev;
+        free(cur);
+        cur = prev;
+    }
+}
+
 llvm::StringRef getOpSymbol(int op_type) {
     switch (op_type) {
         case AST_TYPE::Add:
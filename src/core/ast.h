@@ -165,42 +165,48 @@ class ASTStmtVisitor;
 class AST_keyword;
 class AST_stmt;
 
+// Bump allocator for the nodes of one parse: a module (or exec/eval string) gets a single ASTAllocator, which is
+// destroyed as soon as the CFGs of all of its functions have been computed, since nothing refers to the AST after that.
+// Nodes are carved out of chunks that grow geometrically, so large modules only take a handful of mallocs.
 class ASTAllocator {
 private:
-    template <int slab_size, int alignment = 8> class ASTAllocatorSlab {
-        unsigned char data[slab_size];
+    struct Chunk {
+        Chunk* prev;
+        int size;
         int num_bytes_used;
 
-    public:
-        ASTAllocatorSlab() : num_bytes_used(0) {}
-        ~ASTAllocatorSlab();
-
-        int numBytesFree() const { return slab_size - num_bytes_used; }
-        void* alloc(int num_bytes) {
-            assert(num_bytes_used % alignment == 0);
-            assert(numBytesFree() >= num_bytes);
-            void* ptr = &data[num_bytes_used];
-            num_bytes_used += llvm::RoundUpToAlignment(num_bytes, alignment);
-            return ptr;
-        }
+        unsigned char* data() { return (unsigned char*)(this + 1); }
     };
+    static_assert(sizeof(Chunk) % 8 == 0, "");
 
-    // we subtract the size of the "num_bytes_used" field to generate a power of two allocation which I guess is more
-    // what the allocator is optimized for.
-    static constexpr int slab_size = 4096 - sizeof(int);
-    static_assert(sizeof(ASTAllocatorSlab<slab_size>) == 4096, "");
+    static constexpr int alignment = 8;
+    // sizes of the mallocs, including the chunk header
+    static constexpr int min_chunk_size = 4096;
+    static constexpr int max_chunk_size = 256 * 1024;
 
-    llvm::SmallVector<std::unique_ptr<ASTAllocatorSlab<slab_size>>, 4> slabs;
+    Chunk* cur = nullptr;
+    int next_chunk_size = min_chunk_size;
+    size_t num_bytes = 0;
+
+    void* allocateSlow(int size);
 
 public:
     ASTAllocator() = default;
     ASTAllocator(ASTAllocator&&) = delete;
-
-    void* allocate(int num_bytes) {
-        if (slabs.empty() || slabs.back()->numBytesFree() < num_bytes)
-            slabs.emplace_back(llvm::make_unique<ASTAllocatorSlab<slab_size>>());
-        return slabs.back()->alloc(num_bytes);
+    ~ASTAllocator();
+
+    void* allocate(int size) {
+        size = llvm::RoundUpToAlignment(size, alignment);
+        if (unlikely(!cur || cur->size - cur->num_bytes_used < size))
+            return allocateSlow(size);
+        void* ptr = cur->data() + cur->num_bytes_used;
+        cur->num_bytes_used += size;
+        num_bytes += size;
+        return ptr;
     }
+
+    // Number of bytes handed out so far
+    size_t getSize() const { return num_bytes; }
 };
 
 class AST {
@@ -240,17 +246,6 @@ public:
 };
 Box* getDocString(llvm::ArrayRef<AST_stmt*> body);
 
-template <int slab_size, int alignment> ASTAllocator::ASTAllocatorSlab<slab_size, alignment>::~ASTAllocatorSlab() {
-    // find all AST* nodes and call the virtual destructor
-    for (int current_pos = 0; current_pos < num_bytes_used;) {
-        AST* node = (AST*)&data[current_pos];
-        int node_size = node->getSize();
-        node->~AST();
-        current_pos += llvm::RoundUpToAlignment(node_size, alignment);
-    }
-}
-
-
 #define DEFINE_AST_NODE(name)                                                                                          \
     static const AST_TYPE::AST_TYPE TYPE = AST_TYPE::name;                                                             \
     virtual int getSize() const override { return sizeof(*this); }
@@ -27,16 +27,6 @@
 
 namespace pyston {
 
-#ifdef DEBUG_LINE_NUMBERS
-int BST_stmt::next_lineno = 100000;
-
-BST_stmt::BST_stmt(BST_TYPE::BST_TYPE type) : type(type), lineno(++next_lineno) {
-    // if (lineno == 100644)
-    // raise(SIGTRAP);
-}
-
-#endif
-
 template <class T> static void visitVector(const std::vector<T*>& vec, BSTVisitor* v) {
     for (int i = 0; i < vec.size(); i++) {
         vec[i]->accept(v);
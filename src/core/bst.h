@@ -159,9 +159,7 @@ public:
     // contains the opcode which can have the invoke bit set which signals that this stmt is inside a invoke and that a
     // pointer to the normal CFGBlock and the exception block follow directly after the last field in the instruction.
     unsigned char type_and_flags;
-
-    uint32_t lineno;
-
+    // (line numbers are not stored in the nodes but in the CFG's LineTable, see CFG::getLineno())
 
     BST_TYPE::BST_TYPE type() const { return (BST_TYPE::BST_TYPE)(type_and_flags & (~invoke_flag)); }
 
@@ -196,20 +194,7 @@ public:
     void accept(BSTVisitor* v);
     void accept_stmt(StmtVisitor* v);
 
-
-// #define DEBUG_LINE_NUMBERS 1
-#ifdef DEBUG_LINE_NUMBERS
-private:
-    // Initialize lineno to something unique, so that if we see something ridiculous
-    // appear in the traceback, we can isolate the allocation which created it.
-    static int next_lineno;
-
-public:
-    BST_stmt(BST_TYPE::BST_TYPE type);
-#else
-    BST_stmt(BST_TYPE::BST_TYPE type) : type_and_flags(type), lineno(0) {}
-#endif
-    BST_stmt(BST_TYPE::BST_TYPE type, uint32_t lineno) : type_and_flags(type), lineno(lineno) {}
+    BST_stmt(BST_TYPE::BST_TYPE type) : type_and_flags(type) {}
 } PACKED;
 
 // base class of all nodes which have a single destination vreg
@@ -217,7 +202,6 @@ class BST_stmt_with_dest : public BST_stmt {
 public:
     int vreg_dst = VREG_UNDEFINED;
     BST_stmt_with_dest(BST_TYPE::BST_TYPE type) : BST_stmt(type) {}
-    BST_stmt_with_dest(BST_TYPE::BST_TYPE type, int lineno) : BST_stmt(type, lineno) {}
 } PACKED;
 
 #define BSTNODE(opcode)                                                                                                \
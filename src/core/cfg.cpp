@@ -460,6 +460,10 @@ private:
 
     unsigned int next_var_index = 0;
 
+    // Line numbers of the emitted statements, by bytecode offset; they get turned into cfg->lines once the bytecode
+    // won't move anymore.
+    llvm::DenseMap<int, int> linenos;
+
     friend std::pair<CFG*, CodeConstants> computeCFG(llvm::ArrayRef<AST_stmt*> body, AST_TYPE::AST_TYPE ast_type,
                                                      int lineno, AST_arguments* args, BoxedString* filename,
                                                      SourceInfo* source, const ParamNames& param_names,
@@ -495,6 +499,9 @@ private:
             cfg->placeBlock(block);
     }
 
+    void setLineno(BST_stmt* stmt, int lineno) { linenos[cfg->bytecode.getOffset(stmt)] = lineno; }
+    int getLineno(BST_stmt* stmt) const { return linenos.lookup(cfg->bytecode.getOffset(stmt)); }
+
     // Adds the specified instruction to the current block (invalidating pointers to previous returned
     // instuctions!) and returns a pointer to the newly created node. It automatically creates invokes if neccessary.
     // Because of the invalidation issue it is extremely important that all fields of a node get set/retrieved before a
@@ -618,7 +625,7 @@ private:
 
         BST_Return* node = allocAndPush<BST_Return>();
         unmapExpr(value, &node->vreg_value);
-        node->lineno = value.lineno;
+        setLineno(node, value.lineno);
         curblock = NULL;
     }
 
@@ -658,13 +665,13 @@ private:
 
     TmpValue callNonzero(TmpValue e) {
         BST_Nonzero* call = allocAndPush<BST_Nonzero>();
-        call->lineno = e.lineno;
+        setLineno(call, e.lineno);
         unmapExpr(e, &call->vreg_value);
         return createDstName(call);
     }
 
     TmpValue createDstName(BST_stmt_with_dest* rtn) {
-        TmpValue name(nodeName(), rtn->lineno);
+        TmpValue name(nodeName(), getLineno(rtn));
         unmapExpr(name, &rtn->vreg_dst);
         return name;
     }
@@ -683,7 +690,7 @@ private:
             return makeNone(name->lineno);
 
         auto rtn = allocAndPush<BST_LoadName>();
-        rtn->lineno = name->lineno;
+        setLineno(rtn, name->lineno);
         rtn->index_id = remapInternedString(name->id);
         rtn->lookup_type = name->lookup_type;
         fillScopingInfo(rtn, name->id, scoping);
@@ -746,7 +753,7 @@ private:
     TmpValue _dup(TmpValue val) {
         if (val.isName()) {
             BST_CopyVReg* assign = allocAndPush<BST_CopyVReg>();
-            assign->lineno = val.lineno;
+            setLineno(assign, val.lineno);
 
             auto id = TrackingVRegPtr::createTracking(&assign->vreg_src, cfg->bytecode);
             assert(!id_vreg.count(id));
@@ -761,7 +768,7 @@ private:
         assert(curblock);
 
         auto* list = allocAndPush<BST_List>(0);
-        list->lineno = node->lineno;
+        setLineno(list, node->lineno);
         TmpValue rtn_name = createDstName(list);
         struct BlockInfo {
             CFGBlock* exit_block;
@@ -777,7 +784,7 @@ private:
             TmpValue remapped_iter = remapExpr(c->iter);
             BST_GetIter* iter_call = allocAndPush<BST_GetIter>();
             unmapExpr(remapped_iter, &iter_call->vreg_value);
-            iter_call->lineno = c->target->lineno; // Not sure if this should be c->target or c->iter
+            setLineno(iter_call, c->target->lineno); // Not sure if this should be c->target or c->iter
             TmpValue iter_name(nodeName("lc_iter", i), node->lineno);
             unmapExpr(iter_name, &iter_call->vreg_dst);
 
@@ -790,7 +797,7 @@ private:
             auto dup_iter_name = _dup(iter_name);
             BST_HasNext* test_call = allocAndPush<BST_HasNext>();
             unmapExpr(dup_iter_name, &test_call->vreg_value);
-            test_call->lineno = c->target->lineno;
+            setLineno(test_call, c->target->lineno);
             TmpValue tmp_test_name = createDstName(test_call);
 
             CFGBlock* body_block = cfg->addDeferredBlock();
@@ -801,7 +808,7 @@ private:
             // printf("Body block for comp %d is %d\n", i, body_block->idx);
 
             BST_Branch* br = allocAndPush<BST_Branch>();
-            br->lineno = node->lineno;
+            setLineno(br, node->lineno);
             unmapExpr(tmp_test_name, &br->vreg_test);
             br->iftrue = (CFGBlock*)body_block;
             br->iffalse = (CFGBlock*)exit_block;
@@ -863,7 +870,7 @@ private:
     void pushJump(CFGBlock* target, bool allow_backedge = false, int lineno = 0) {
         BST_Jump* rtn = allocAndPush<BST_Jump>();
         rtn->target = (CFGBlock*)target;
-        rtn->lineno = lineno;
+        setLineno(rtn, lineno);
 
         curblock->connectTo(target, allow_backedge);
         curblock = nullptr;
@@ -874,7 +881,7 @@ private:
         auto expr = callNonzero(test);
         BST_Branch* rtn = allocAndPush<BST_Branch>();
         unmapExpr(expr, &rtn->vreg_test);
-        rtn->lineno = test.lineno;
+        setLineno(rtn, test.lineno);
         return rtn;
     }
 
@@ -894,7 +901,7 @@ private:
     void pushReraise(int lineno, InternedString exc_type_name, InternedString exc_value_name,
                      InternedString exc_traceback_name) {
         auto raise = allocAndPush<BST_Raise>();
-        raise->lineno = lineno;
+        setLineno(raise, lineno);
         unmapExpr(TmpValue(exc_type_name, lineno), &raise->vreg_arg0);
         unmapExpr(TmpValue(exc_value_name, lineno), &raise->vreg_arg1);
         unmapExpr(TmpValue(exc_traceback_name, lineno), &raise->vreg_arg2);
@@ -925,7 +932,7 @@ private:
         rtn->clsonly = clsonly;
         unmapExpr(base, &rtn->vreg_value);
         rtn->index_attr = remapInternedString(attr);
-        rtn->lineno = base.lineno;
+        setLineno(rtn, base.lineno);
         return createDstName(rtn);
     }
 
@@ -958,7 +965,7 @@ private:
         for (int i = 0; i < args.size(); ++i) {
             unmapExpr(args[i], &rtn->elts[i]);
         }
-        rtn->lineno = func.lineno;
+        setLineno(rtn, func.lineno);
         return createDstName(rtn);
     }
 
@@ -981,7 +988,7 @@ private:
             }
             rtn = call;
         }
-        rtn->lineno = target.lineno;
+        setLineno(rtn, target.lineno);
         return createDstName(rtn);
     }
 
@@ -1008,7 +1015,7 @@ private:
                 auto remaped_upper = remapExpr(slice->upper);
 
                 auto* s_target = allocAndPush<BST_StoreSubSlice>();
-                s_target->lineno = val.lineno;
+                setLineno(s_target, val.lineno);
                 unmapExpr(remaped_value, &s_target->vreg_target);
                 unmapExpr(remaped_lower, &s_target->vreg_lower);
                 unmapExpr(remaped_upper, &s_target->vreg_upper);
@@ -1017,7 +1024,7 @@ private:
                 auto remaped_slice = remapSlice(s->slice);
 
                 auto* s_target = allocAndPush<BST_StoreSub>();
-                s_target->lineno = val.lineno;
+                setLineno(s_target, val.lineno);
                 unmapExpr(remaped_value, &s_target->vreg_target);
                 unmapExpr(remaped_slice, &s_target->vreg_slice);
                 unmapExpr(val, &s_target->vreg_value);
@@ -1031,7 +1038,7 @@ private:
             unmapExpr(val, &a_target->vreg_value);
             unmapExpr(remapped_value, &a_target->vreg_target);
             a_target->index_attr = remapInternedString(scoping->mangleName(a->attr));
-            a_target->lineno = a->lineno;
+            setLineno(a_target, a->lineno);
         } else if (target->type == AST_TYPE::Tuple || target->type == AST_TYPE::List) {
             std::vector<AST_expr*>* elts;
             if (target->type == AST_TYPE::Tuple) {
@@ -1046,7 +1053,7 @@ private:
 
             BST_UnpackIntoArray* unpack = allocAndPush<BST_UnpackIntoArray>(elts->size());
             unmapExpr(val, &unpack->vreg_src);
-            unpack->lineno = val.lineno;
+            setLineno(unpack, val.lineno);
 
             llvm::SmallVector<TmpValue, 8> tmp_names;
             for (int i = 0; i < elts->size(); i++) {
@@ -1069,7 +1076,7 @@ private:
         if (id.isCompilerCreatedName()) {
             if (val.isConst()) {
                 BST_CopyVReg* assign = allocAndPush<BST_CopyVReg>();
-                assign->lineno = val.lineno;
+                setLineno(assign, val.lineno);
                 unmapExpr(val, &assign->vreg_src);
                 unmapExpr(dst, &assign->vreg_dst);
                 return;
@@ -1100,7 +1107,7 @@ private:
     TmpValue remapAttribute(AST_Attribute* node) {
         auto remapped_value = remapExpr(node->value);
         BST_LoadAttr* rtn = allocAndPush<BST_LoadAttr>();
-        rtn->lineno = node->lineno;
+        setLineno(rtn, node->lineno);
         rtn->index_attr = remapInternedString(scoping->mangleName(node->attr));
         unmapExpr(remapped_value, &rtn->vreg_value);
         return createDstName(rtn);
@@ -1132,7 +1139,7 @@ private:
         auto remapped_right = remapExpr(node->right);
 
         BST_BinOp* rtn = allocAndPush<BST_BinOp>();
-        rtn->lineno = node->lineno;
+        setLineno(rtn, node->lineno);
         rtn->op_type = remapBinOpType(node->op_type);
         unmapExpr(remapped_left, &rtn->vreg_left);
         unmapExpr(remapped_right, &rtn->vreg_right);
@@ -1154,7 +1161,7 @@ private:
             auto remapped_br_test = callNonzero(val);
             BST_Branch* br = allocAndPush<BST_Branch>();
             unmapExpr(remapped_br_test, &br->vreg_test);
-            br->lineno = val.lineno;
+            setLineno(br, val.lineno);
 
             CFGBlock* was_block = curblock;
             CFGBlock* next_block = cfg->addDeferredBlock();
@@ -1243,7 +1250,7 @@ private:
             rtn_shared = rtn;
         }
 
-        rtn_shared->lineno = node->lineno;
+        setLineno(rtn_shared, node->lineno);
 
         if (node->keywords.size()) {
             llvm::SmallVector<BoxedString*, 8> keywords_names;
@@ -1262,7 +1269,7 @@ private:
         auto remapped_value = remapExpr(node->value);
         BST_LoadAttr* rtn = allocAndPush<BST_LoadAttr>();
         rtn->clsonly = true;
-        rtn->lineno = node->lineno;
+        setLineno(rtn, node->lineno);
         rtn->index_attr = remapInternedString(scoping->mangleName(node->attr));
         unmapExpr(remapped_value, &rtn->vreg_value);
         return createDstName(rtn);
@@ -1278,7 +1285,7 @@ private:
             auto remapped_comp = remapExpr(node->comparators[0]);
 
             BST_Compare* rtn = allocAndPush<BST_Compare>();
-            rtn->lineno = node->lineno;
+            setLineno(rtn, node->lineno);
             rtn->op = node->ops[0];
             unmapExpr(remapped_left, &rtn->vreg_left);
             unmapExpr(remapped_comp, &rtn->vreg_comparator);
@@ -1299,7 +1306,7 @@ private:
                     remapped_comp = _dup(right);
 
                 BST_Compare* val = allocAndPush<BST_Compare>();
-                val->lineno = node->lineno;
+                setLineno(val, node->lineno);
                 unmapExpr(left, &val->vreg_left);
                 unmapExpr(remapped_comp, &val->vreg_comparator);
                 val->op = node->ops[i];
@@ -1339,7 +1346,7 @@ private:
 
     TmpValue remapDict(AST_Dict* node) {
         BST_Dict* rtn = allocAndPush<BST_Dict>();
-        rtn->lineno = node->lineno;
+        setLineno(rtn, node->lineno);
 
         TmpValue dict_name = createDstName(rtn);
 
@@ -1349,7 +1356,7 @@ private:
             auto remapped_slice = remapExpr(node->keys[i]);
 
             BST_StoreSub* store = allocAndPush<BST_StoreSub>();
-            store->lineno = node->values[i]->lineno;
+            setLineno(store, node->values[i]->lineno);
             unmapExpr(remapped_value, &store->vreg_value);
             unmapExpr(remapped_target, &store->vreg_target);
             unmapExpr(remapped_slice, &store->vreg_slice);
@@ -1370,7 +1377,7 @@ private:
         }
 
         auto* rtn = allocAndPush<BST_Tuple>(node->dims.size());
-        rtn->lineno = node->lineno;
+        setLineno(rtn, node->lineno);
         for (int i = 0; i < node->dims.size(); ++i) {
             unmapExpr(remmaped_elts[i], &rtn->elts[i]);
         }
@@ -1436,7 +1443,7 @@ private:
 
         BoxedCode* code = cfgizer->runRecursively(new_body, gen_name, node->lineno, genexp_args, node);
         BST_MakeFunction* mkfunc = allocAndPush<BST_MakeFunction>(0, 0);
-        mkfunc->lineno = node->lineno;
+        setLineno(mkfunc, node->lineno);
         mkfunc->vreg_code_obj = addConst(code);
         TmpValue func_var_name = createDstName(mkfunc);
 
@@ -1495,7 +1502,7 @@ private:
 
         BoxedCode* code = cfgizer->runRecursively(new_body, comp_name, node->lineno, args, node);
         BST_MakeFunction* mkfunc = allocAndPush<BST_MakeFunction>(0, 0);
-        mkfunc->lineno = node->lineno;
+        setLineno(mkfunc, node->lineno);
         mkfunc->vreg_code_obj = addConst(code);
         TmpValue func_var_name = createDstName(mkfunc);
 
@@ -1543,14 +1550,14 @@ private:
         }
 
         auto mkfn = allocAndPush<BST_MakeFunction>(0 /* decorators */, node->args->defaults.size());
-        mkfn->lineno = node->lineno;
+        setLineno(mkfn, node->lineno);
 
         for (int i = 0; i < node->args->defaults.size(); ++i) {
             unmapExpr(remapped_defaults[i], &mkfn->elts[i]);
         }
 
         auto name = getStaticString("<lambda>");
-        auto* code = cfgizer->runRecursively({ stmt }, name, mkfn->lineno, node->args, node);
+        auto* code = cfgizer->runRecursively({ stmt }, name, node->lineno, node->args, node);
         mkfn->vreg_code_obj = addConst(code);
 
         return createDstName(mkfn);
@@ -1562,7 +1569,7 @@ private:
         assert(node->args.size() == 1);
         auto remapped_value = remapExpr(node->args[0]);
         BST_PrintExpr* rtn = allocAndPush<BST_PrintExpr>();
-        rtn->lineno = node->lineno;
+        setLineno(rtn, node->lineno);
         unmapExpr(remapped_value, &rtn->vreg_value);
         return TmpValue();
     }
@@ -1574,7 +1581,7 @@ private:
             remapped_elts.emplace_back(remapExpr(node->elts[i]));
         }
         BST_List* rtn = allocAndPush<BST_List>(node->elts.size());
-        rtn->lineno = node->lineno;
+        setLineno(rtn, node->lineno);
         for (int i = 0; i < node->elts.size(); ++i) {
             unmapExpr(remapped_elts[i], &rtn->elts[i]);
         }
@@ -1584,7 +1591,7 @@ private:
     TmpValue remapRepr(AST_Repr* node) {
         auto remapped_value = remapExpr(node->value);
         BST_Repr* rtn = allocAndPush<BST_Repr>();
-        rtn->lineno = node->lineno;
+        setLineno(rtn, node->lineno);
         unmapExpr(remapped_value, &rtn->vreg_value);
         return createDstName(rtn);
     }
@@ -1596,7 +1603,7 @@ private:
         }
 
         BST_Set* rtn = allocAndPush<BST_Set>(node->elts.size());
-        rtn->lineno = node->lineno;
+        setLineno(rtn, node->lineno);
         for (int i = 0; i < node->elts.size(); ++i) {
             unmapExpr(remapped_elts[i], &rtn->elts[i]);
         }
@@ -1611,7 +1618,7 @@ private:
         auto remapped_step = remapExpr(node->step);
 
         BST_MakeSlice* rtn = allocAndPush<BST_MakeSlice>();
-        rtn->lineno = node->lineno;
+        setLineno(rtn, node->lineno);
         unmapExpr(remapped_lower, &rtn->vreg_lower);
         unmapExpr(remapped_upper, &rtn->vreg_upper);
         unmapExpr(remapped_step, &rtn->vreg_step);
@@ -1693,7 +1700,7 @@ private:
         }
 
         BST_Tuple* rtn = allocAndPush<BST_Tuple>(node->elts.size());
-        rtn->lineno = node->lineno;
+        setLineno(rtn, node->lineno);
         for (int i = 0; i < node->elts.size(); ++i) {
             unmapExpr(remapped_elts[i], &rtn->elts[i]);
         }
@@ -1707,7 +1714,7 @@ private:
         if (!isSlice(node->slice)) {
             auto remapped_slice = remapSlice(node->slice);
             BST_LoadSub* rtn = allocAndPush<BST_LoadSub>();
-            rtn->lineno = node->lineno;
+            setLineno(rtn, node->lineno);
             unmapExpr(remapped_value, &rtn->vreg_value);
             unmapExpr(remapped_slice, &rtn->vreg_slice);
             return createDstName(rtn);
@@ -1716,7 +1723,7 @@ private:
             auto remapped_upper = remapExpr(ast_cast<AST_Slice>(node->slice)->upper);
 
             BST_LoadSubSlice* rtn = allocAndPush<BST_LoadSubSlice>();
-            rtn->lineno = node->lineno;
+            setLineno(rtn, node->lineno);
             assert(node->ctx_type == AST_TYPE::AST_TYPE::Load);
             unmapExpr(remapped_value, &rtn->vreg_value);
             unmapExpr(remapped_lower, &rtn->vreg_lower);
@@ -1728,7 +1735,7 @@ private:
     TmpValue remapUnaryOp(AST_UnaryOp* node) {
         auto remapped_operand = remapExpr(node->operand);
         BST_UnaryOp* rtn = allocAndPush<BST_UnaryOp>();
-        rtn->lineno = node->lineno;
+        setLineno(rtn, node->lineno);
         rtn->op_type = node->op_type;
         unmapExpr(remapped_operand, &rtn->vreg_operand);
         return createDstName(rtn);
@@ -1737,7 +1744,7 @@ private:
     TmpValue remapYield(AST_Yield* node) {
         auto remapped_value = remapExpr(node->value);
         BST_Yield* rtn = allocAndPush<BST_Yield>();
-        rtn->lineno = node->lineno;
+        setLineno(rtn, node->lineno);
         unmapExpr(remapped_value, &rtn->vreg_value);
 
         TmpValue val = createDstName(rtn);
@@ -1897,7 +1904,7 @@ public:
             store = allocAndPush<BST_StoreName>();
         store->index_id = remapInternedString(name);
         unmapExpr(value, &store->vreg_value);
-        store->lineno = value.lineno;
+        setLineno(store, value.lineno);
         fillScopingInfo(store, name, scoping);
     }
 
@@ -1920,7 +1927,7 @@ public:
         TmpValue bases_name = createDstName(bases);
 
         auto mkclass = allocAndPush<BST_MakeClass>(node->decorator_list.size());
-        mkclass->lineno = node->lineno;
+        setLineno(mkclass, node->lineno);
         mkclass->index_name = remapInternedString(node->name);
 
         for (int i = 0; i < node->decorator_list.size(); ++i) {
@@ -1951,7 +1958,7 @@ public:
         }
 
         auto mkfunc = allocAndPush<BST_MakeFunction>(node->decorator_list.size(), node->args->defaults.size());
-        mkfunc->lineno = node->lineno;
+        setLineno(mkfunc, node->lineno);
         mkfunc->index_name = remapInternedString(node->name);
 
         // Decorators are evaluated before the defaults, so this *must* go before remapArguments().
@@ -1988,7 +1995,7 @@ public:
     bool visit_import(AST_Import* node) override {
         for (AST_alias* a : node->names) {
             BST_ImportName* import = allocAndPush<BST_ImportName>();
-            import->lineno = node->lineno;
+            setLineno(import, node->lineno);
 
             // level == 0 means only check sys path for imports, nothing package-relative,
             // level == -1 means check both sys path and relative for imports.
@@ -2024,7 +2031,7 @@ public:
                     }
 
                     auto* store = allocAndPush<BST_LoadAttr>();
-                    store->lineno = import->lineno;
+                    setLineno(store, node->lineno);
                     store->index_attr
                         = remapInternedString(scoping->mangleName(internString(a->name.s().substr(l, r - l))));
                     unmapExpr(tmpname, &store->vreg_value);
@@ -2047,7 +2054,7 @@ public:
         TmpValue tuple_name = createDstName(tuple);
 
         BST_ImportName* import = allocAndPush<BST_ImportName>();
-        import->lineno = node->lineno;
+        setLineno(import, node->lineno);
 
         // level == 0 means only check sys path for imports, nothing package-relative,
         // level == -1 means check both sys path and relative for imports.
@@ -2071,13 +2078,13 @@ public:
             TmpValue remapped_tmp_module_name = is_kill ? tmp_module_name : _dup(tmp_module_name);
             if (a->name.s() == "*") {
                 BST_ImportStar* import_star = allocAndPush<BST_ImportStar>();
-                import_star->lineno = node->lineno;
+                setLineno(import_star, node->lineno);
                 unmapExpr(remapped_tmp_module_name, &import_star->vreg_name);
 
                 createDstName(import_star);
             } else {
                 BST_ImportFrom* import_from = allocAndPush<BST_ImportFrom>();
-                import_from->lineno = node->lineno;
+                setLineno(import_from, node->lineno);
                 unmapExpr(remapped_tmp_module_name, &import_from->vreg_module);
                 import_from->index_id = remapInternedString(a->name);
 
@@ -2118,7 +2125,7 @@ public:
             unmapExpr(remapped_msg, &remapped->vreg_msg);
         else
             remapped->vreg_msg = VREG_UNDEFINED;
-        remapped->lineno = node->lineno;
+        setLineno(remapped, node->lineno);
 
         setInsertPoint(iftrue);
 
@@ -2172,7 +2179,7 @@ public:
                 binop->op_type = remapBinOpType(node->op_type);
                 unmapExpr(remapped_name, &binop->vreg_left);
                 unmapExpr(remapped_value, &binop->vreg_right);
-                binop->lineno = node->lineno;
+                setLineno(binop, node->lineno);
                 TmpValue result_name = createDstName(binop);
                 pushStoreName(n->id, result_name);
 
@@ -2198,7 +2205,7 @@ public:
                     unmapExpr(value_remapped_dup, &s_lhs->vreg_value);
                     unmapExpr(lower_remapped_dup, &s_lhs->vreg_lower);
                     unmapExpr(upper_remapped_dup, &s_lhs->vreg_upper);
-                    s_lhs->lineno = s->lineno;
+                    setLineno(s_lhs, s->lineno);
                     TmpValue name_lhs = createDstName(s_lhs);
 
                     auto remapped_value = remapExpr(node->value);
@@ -2206,11 +2213,11 @@ public:
                     binop->op_type = remapBinOpType(node->op_type);
                     unmapExpr(name_lhs, &binop->vreg_left);
                     unmapExpr(remapped_value, &binop->vreg_right);
-                    binop->lineno = node->lineno;
+                    setLineno(binop, node->lineno);
                     TmpValue node_name = createDstName(binop);
 
                     BST_StoreSubSlice* s_target = allocAndPush<BST_StoreSubSlice>();
-                    s_target->lineno = s->lineno;
+                    setLineno(s_target, s->lineno);
                     unmapExpr(node_name, &s_target->vreg_value);
                     unmapExpr(value_remapped, &s_target->vreg_target);
                     unmapExpr(lower_remapped, &s_target->vreg_lower);
@@ -2223,7 +2230,7 @@ public:
                     BST_LoadSub* s_lhs = allocAndPush<BST_LoadSub>();
                     unmapExpr(value_remapped_dup, &s_lhs->vreg_value);
                     unmapExpr(slice_remapped_dup, &s_lhs->vreg_slice);
-                    s_lhs->lineno = s->lineno;
+                    setLineno(s_lhs, s->lineno);
                     TmpValue name_lhs = createDstName(s_lhs);
 
                     auto remapped_value = remapExpr(node->value);
@@ -2231,11 +2238,11 @@ public:
                     binop->op_type = remapBinOpType(node->op_type);
                     unmapExpr(name_lhs, &binop->vreg_left);
                     unmapExpr(remapped_value, &binop->vreg_right);
-                    binop->lineno = node->lineno;
+                    setLineno(binop, node->lineno);
                     TmpValue node_name = createDstName(binop);
 
                     BST_StoreSub* s_target = allocAndPush<BST_StoreSub>();
-                    s_target->lineno = s->lineno;
+                    setLineno(s_target, s->lineno);
                     unmapExpr(node_name, &s_target->vreg_value);
                     unmapExpr(value_remapped, &s_target->vreg_target);
                     unmapExpr(slice_remapped, &s_target->vreg_slice);
@@ -2253,7 +2260,7 @@ public:
                 unmapExpr(value_remapped_dup, &a_lhs->vreg_value);
                 auto index_attr = remapInternedString(scoping->mangleName(a->attr));
                 a_lhs->index_attr = index_attr;
-                a_lhs->lineno = a->lineno;
+                setLineno(a_lhs, a->lineno);
                 TmpValue name_lhs = createDstName(a_lhs);
 
                 auto remapped_value = remapExpr(node->value);
@@ -2261,14 +2268,14 @@ public:
                 binop->op_type = remapBinOpType(node->op_type);
                 unmapExpr(name_lhs, &binop->vreg_left);
                 unmapExpr(remapped_value, &binop->vreg_right);
-                binop->lineno = node->lineno;
+                setLineno(binop, node->lineno);
                 TmpValue node_name = createDstName(binop);
 
                 BST_StoreAttr* a_target = allocAndPush<BST_StoreAttr>();
                 unmapExpr(node_name, &a_target->vreg_value);
                 unmapExpr(value_remapped, &a_target->vreg_target);
                 a_target->index_attr = index_attr;
-                a_target->lineno = a->lineno;
+                setLineno(a_target, a->lineno);
 
                 return true;
             }
@@ -2297,14 +2304,14 @@ public:
                         auto remapped_lower = remapExpr(slice->lower);
                         auto remapped_upper = remapExpr(slice->upper);
                         auto* del = allocAndPush<BST_DeleteSubSlice>();
-                        del->lineno = node->lineno;
+                        setLineno(del, node->lineno);
                         unmapExpr(remapped_value, &del->vreg_value);
                         unmapExpr(remapped_lower, &del->vreg_lower);
                         unmapExpr(remapped_upper, &del->vreg_upper);
                     } else {
                         auto remapped_slice = remapSlice(s->slice);
                         auto* del = allocAndPush<BST_DeleteSub>();
-                        del->lineno = node->lineno;
+                        setLineno(del, node->lineno);
                         unmapExpr(remapped_value, &del->vreg_value);
                         unmapExpr(remapped_slice, &del->vreg_slice);
                     }
@@ -2314,7 +2321,7 @@ public:
                     AST_Attribute* astattr = static_cast<AST_Attribute*>(t);
                     auto remaped_value = remapExpr(astattr->value);
                     auto* del = allocAndPush<BST_DeleteAttr>();
-                    del->lineno = node->lineno;
+                    setLineno(del, node->lineno);
                     unmapExpr(remaped_value, &del->vreg_value);
                     del->index_attr = remapInternedString(scoping->mangleName(astattr->attr));
                     break;
@@ -2322,7 +2329,7 @@ public:
                 case AST_TYPE::Name: {
                     AST_Name* s = static_cast<AST_Name*>(t);
                     auto* del = allocAndPush<BST_DeleteName>();
-                    del->lineno = node->lineno;
+                    setLineno(del, node->lineno);
                     del->index_id = remapInternedString(s->id);
                     fillScopingInfo(del, s->id, scoping);
                     break;
@@ -2379,7 +2386,7 @@ public:
             auto remapped_value = remapExpr(v);
 
             BST_Print* remapped = allocAndPush<BST_Print>();
-            remapped->lineno = node->lineno;
+            setLineno(remapped, node->lineno);
 
             unmapExpr(remapped_dest, &remapped->vreg_dest);
             if (i < node->values.size() - 1)
@@ -2395,7 +2402,7 @@ public:
             assert(node->nl);
 
             BST_Print* final = allocAndPush<BST_Print>();
-            final->lineno = node->lineno;
+            setLineno(final, node->lineno);
             // TODO not good to reuse 'dest' like this
             unmapExpr(dest, &final->vreg_dest);
             final->nl = node->nl;
@@ -2425,7 +2432,7 @@ public:
 
         auto remapped_br_test = callNonzero(remapExpr(node->test));
         BST_Branch* br = allocAndPush<BST_Branch>();
-        br->lineno = node->lineno;
+        setLineno(br, node->lineno);
         unmapExpr(remapped_br_test, &br->vreg_test);
 
         CFGBlock* starting_block = curblock;
@@ -2493,7 +2500,7 @@ public:
         auto remapped_locals = remapExpr(node->locals);
 
         BST_Exec* astexec = allocAndPush<BST_Exec>();
-        astexec->lineno = node->lineno;
+        setLineno(astexec, node->lineno);
         unmapExpr(remapped_body, &astexec->vreg_body);
         unmapExpr(remapped_globals, &astexec->vreg_globals);
         unmapExpr(remapped_locals, &astexec->vreg_locals);
@@ -2561,7 +2568,7 @@ public:
         // There might be a better way to represent this, maybe with a dedicated AST_Kill bytecode?
         auto del = allocAndPush<BST_DeleteName, false /* can't throw */>();
         del->index_id = remapInternedString(name);
-        del->lineno = 0;
+        setLineno(del, 0);
         fillScopingInfo(del, name, scoping);
         return del;
     }
@@ -2576,7 +2583,7 @@ public:
         TmpValue remapped_iter = remapExpr(node->iter);
         BST_GetIter* iter_call = allocAndPush<BST_GetIter>();
         unmapExpr(remapped_iter, &iter_call->vreg_value);
-        iter_call->lineno = node->lineno;
+        setLineno(iter_call, node->lineno);
         TmpValue itername(createUniqueName("#iter_"), node->lineno);
         unmapExpr(itername, &iter_call->vreg_dst);
 
@@ -2586,7 +2593,7 @@ public:
 
         auto itername_dup = _dup(itername);
         BST_HasNext* test_call = allocAndPush<BST_HasNext>();
-        test_call->lineno = node->lineno;
+        setLineno(test_call, node->lineno);
         unmapExpr(itername_dup, &test_call->vreg_value);
         TmpValue tmp_has_call = createDstName(test_call);
 
@@ -2628,7 +2635,7 @@ public:
             remapped_iter = _dup(itername);
             BST_HasNext* end_call = allocAndPush<BST_HasNext>();
             unmapExpr(remapped_iter, &end_call->vreg_value);
-            end_call->lineno = node->lineno;
+            setLineno(end_call, node->lineno);
             TmpValue tmp_end_call = createDstName(end_call);
 
             BST_Branch* end_br = makeBranch(tmp_end_call);
@@ -2688,7 +2695,7 @@ public:
             remapped_arg2 = remapExpr(node->arg2);
 
         BST_Raise* remapped = allocAndPush<BST_Raise>();
-        remapped->lineno = node->lineno;
+        setLineno(remapped, node->lineno);
         if (node->arg0)
             unmapExpr(remapped_arg0, &remapped->vreg_arg0);
         if (node->arg1)
@@ -2754,13 +2761,13 @@ public:
                     // TODO This is supposed to be exc_type_name (value doesn't matter for checking matches)
                     unmapExpr(remapped_exc_value_name, &is_caught_here->vreg_value);
                     unmapExpr(handled_type, &is_caught_here->vreg_cls);
-                    is_caught_here->lineno = exc_handler->lineno;
+                    setLineno(is_caught_here, exc_handler->lineno);
                     TmpValue name_is_caught_here = createDstName(is_caught_here);
 
                     auto remapped_br_test = callNonzero(name_is_caught_here);
                     BST_Branch* br = allocAndPush<BST_Branch>();
                     unmapExpr(remapped_br_test, &br->vreg_test);
-                    br->lineno = exc_handler->lineno;
+                    setLineno(br, exc_handler->lineno);
 
                     CFGBlock* exc_handle = cfg->addDeferredBlock();
                     exc_next = cfg->addDeferredBlock();
@@ -2809,7 +2816,7 @@ public:
                 // Even though the line number of the trackback will correctly point to the line that
                 // raised, this matches CPython's behavior that the frame's line number points to
                 // the last statement of the last except block.
-                raise->lineno = getLastLinenoSub(node->handlers.back()->body.back());
+                setLineno(raise, getLastLinenoSub(node->handlers.back()->body.back()));
 
                 curblock = NULL;
             }
@@ -3224,13 +3231,84 @@ void VRegInfo::assignVRegs(const CodeConstants& code_constants, CFG* cfg, const
 #endif
 }
 
+static void writeVarint(std::vector<unsigned char>& data, uint32_t n) {
+    while (n >= 0x80) {
+        data.push_back((n & 0x7f) | 0x80);
+        n >>= 7;
+    }
+    data.push_back(n);
+}
+
+static uint32_t readVarint(const unsigned char*& p) {
+    uint32_t n = 0;
+    for (int shift = 0;; shift += 7) {
+        unsigned char c = *p++;
+        n |= (uint32_t)(c & 0x7f) << shift;
+        if (!(c & 0x80))
+            return n;
+    }
+}
+
+void LineTable::build(std::vector<std::pair<int, int>> entries) {
+    entries.erase(std::remove_if(entries.begin(), entries.end(),
+                                 [](const std::pair<int, int>& e) { return e.second == 0; }),
+                  entries.end());
+    std::stable_sort(entries.begin(), entries.end(), [](const std::pair<int, int>& lhs, const std::pair<int, int>& rhs) {
+        return lhs.first < rhs.first;
+    });
+
+    data.clear();
+    int last_offset = 0, last_lineno = 0;
+    for (int i = 0; i < entries.size(); i++) {
+        int offset = entries[i].first, lineno = entries[i].second;
+        if (i + 1 < entries.size() && entries[i + 1].first == offset)
+            continue;
+        if (lineno == last_lineno)
+            continue;
+
+        assert(offset >= last_offset);
+        writeVarint(data, offset - last_offset);
+        // zigzag encoding, so that small negative deltas stay small
+        int delta = lineno - last_lineno;
+        writeVarint(data, delta < 0 ? ((uint32_t)~delta << 1) | 1 : (uint32_t)delta << 1);
+        last_offset = offset;
+        last_lineno = lineno;
+    }
+    data.shrink_to_fit();
+}
+
+int LineTable::getLineno(int offset) const {
+    return Cursor(*this).getLineno(offset);
+}
+
+int LineTable::Cursor::getLineno(int offset) {
+    if (offset < cur_offset) {
+        pos = 0;
+        cur_offset = cur_lineno = 0;
+    }
+
+    const unsigned char* start = table.data.data();
+    const unsigned char* end = start + table.data.size();
+    const unsigned char* p = start + pos;
+    while (p < end) {
+        int next_offset = cur_offset + readVarint(p);
+        if (next_offset > offset)
+            break;
+        uint32_t delta = readVarint(p);
+        cur_lineno += (delta & 1) ? ~(int)(delta >> 1) : (int)(delta >> 1);
+        cur_offset = next_offset;
+        pos = p - start;
+    }
+    return cur_lineno;
+}
+
 // Prune unnecessary blocks from the CFG.
 // Not strictly necessary, but makes the output easier to look at,
 // and can make the analyses more efficient.
 // The extra blocks would get merged by LLVM passes, so I'm not sure
 // how much overall improvement there is.
 // returns num of removed blocks
-static int pruneUnnecessaryBlocks(CFG* rtn) {
+static int pruneUnnecessaryBlocks(CFG* rtn, llvm::DenseMap<int, int>& linenos) {
     llvm::DenseMap<CFGBlock*, CFGBlock*> blocks_to_merge;
     // Must evaluate end() on every iteration because erase() will invalidate the end.
     for (auto it = rtn->blocks.begin(); it != rtn->blocks.end(); ++it) {
@@ -3273,6 +3351,19 @@ static int pruneUnnecessaryBlocks(CFG* rtn) {
         BSTAllocator final_bytecode;
         final_bytecode.reserve(rtn->bytecode.getSize());
 
+        // the line numbers are keyed by bytecode offset, so they have to move along with the statements
+        llvm::DenseMap<int, int> final_linenos;
+        auto move_linenos = [&](CFGBlock* block, int new_offset_of_block_start, bool skip_terminator) {
+            for (BST_stmt* stmt : *block) {
+                if (skip_terminator && stmt->is_terminator())
+                    break;
+                int old_offset = rtn->bytecode.getOffset(stmt);
+                auto it = linenos.find(old_offset);
+                if (it != linenos.end())
+                    final_linenos[new_offset_of_block_start + old_offset - block->offset_of_first_stmt] = it->second;
+            }
+        };
+
         int offset = 0;
         for (CFGBlock* b : rtn->blocks) {
             int block_size = b->sizeInBytes();
@@ -3281,15 +3372,18 @@ static int pruneUnnecessaryBlocks(CFG* rtn) {
             if (should_merge_blocks) {
                 // copy first block without the terminator
                 block_size -= b->getTerminator()->size_in_bytes();
+                move_linenos(b, offset, true);
                 memcpy(final_bytecode.allocate(block_size), b->body(), block_size);
                 offset += block_size;
                 // copy second block and delete it
                 CFGBlock* second_block = blocks_to_merge[b];
                 int second_block_size = second_block->sizeInBytes();
+                move_linenos(second_block, offset, false);
                 memcpy(final_bytecode.allocate(second_block_size), second_block->body(), second_block_size);
                 offset += second_block_size;
                 delete second_block;
             } else {
+                move_linenos(b, offset, false);
                 memcpy(final_bytecode.allocate(block_size), b->body(), block_size);
                 offset += block_size;
             }
@@ -3297,6 +3391,7 @@ static int pruneUnnecessaryBlocks(CFG* rtn) {
             b->offset_of_first_stmt = new_offset_of_block_start;
         }
         rtn->bytecode = std::move(final_bytecode);
+        linenos = std::move(final_linenos);
     }
 
     return blocks_to_merge.size();
@@ -3321,7 +3416,7 @@ static std::pair<CFG*, CodeConstants> computeCFG(llvm::ArrayRef<AST_stmt*> body,
         InternedString id = stringpool.get("__name__");
         // A classdef always starts with "__module__ = __name__"
         auto module_name_value = visitor.allocAndPush<BST_LoadName>();
-        module_name_value->lineno = lineno;
+        visitor.setLineno(module_name_value, lineno);
         module_name_value->index_id = visitor.remapInternedString(id);
         fillScopingInfo(module_name_value, id, scoping);
         TmpValue module_name = visitor.createDstName(module_name_value);
@@ -3354,7 +3449,7 @@ static std::pair<CFG*, CodeConstants> computeCFG(llvm::ArrayRef<AST_stmt*> body,
 
                 auto load = visitor.allocAndPush<BST_LoadName>();
                 load->index_id = visitor.remapInternedString(arg_name);
-                load->lineno = arg_expr->lineno;
+                visitor.setLineno(load, arg_expr->lineno);
                 fillScopingInfo(load, arg_name, scoping);
                 TmpValue val = visitor.createDstName(load);
 
@@ -3380,14 +3475,14 @@ static std::pair<CFG*, CodeConstants> computeCFG(llvm::ArrayRef<AST_stmt*> body,
         TmpValue name = visitor.createDstName(locals);
 
         BST_Return* rtn = visitor.allocAndPush<BST_Return>();
-        rtn->lineno = getLastLineno(body, lineno);
+        visitor.setLineno(rtn, getLastLineno(body, lineno));
         visitor.unmapExpr(name, &rtn->vreg_value);
     } else if (visitor.curblock) {
         // Put a fake "return" statement at the end of every function just to make sure they all have one;
         // we already have to support multiple return statements in a function, but this way we can avoid
         // having to support not having a return statement:
         BST_Return* return_stmt = visitor.allocAndPush<BST_Return>();
-        return_stmt->lineno = getLastLineno(body, lineno);
+        visitor.setLineno(return_stmt, getLastLineno(body, lineno));
         return_stmt->vreg_value = VREG_UNDEFINED;
     }
 
@@ -3490,13 +3585,13 @@ static std::pair<CFG*, CodeConstants> computeCFG(llvm::ArrayRef<AST_stmt*> body,
 
             //if (bst->type() != AST_TYPE::Return)
                 //continue;
-            if (bst->lineno == 0) {
+            if (visitor.getLineno(bst) == 0) {
                 rtn->print(visitor.code_constants);
                 printf("\n");
                 print_bst(bst, visitor.code_constants);
                 printf("\n");
             }
-            assert(bst->lineno > 0);
+            assert(visitor.getLineno(bst) > 0);
         }
     }
 #endif
@@ -3506,7 +3601,9 @@ static std::pair<CFG*, CodeConstants> computeCFG(llvm::ArrayRef<AST_stmt*> body,
 
     rtn->getVRegInfo().assignVRegs(visitor.code_constants, rtn, param_names, visitor.id_vreg);
 
-    pruneUnnecessaryBlocks(rtn);
+    pruneUnnecessaryBlocks(rtn, visitor.linenos);
+
+    rtn->lines.build(std::vector<std::pair<int, int>>(visitor.linenos.begin(), visitor.linenos.end()));
 
     visitor.code_constants.optimizeSize();
     rtn->bytecode.optimizeSize();
@@ -3514,6 +3611,8 @@ static std::pair<CFG*, CodeConstants> computeCFG(llvm::ArrayRef<AST_stmt*> body,
 
     static StatCounter bst_bytecode_bytes("num_bst_bytecode_bytes");
     bst_bytecode_bytes.log(rtn->bytecode.getSize());
+    static StatCounter bst_linetable_bytes("num_bst_linetable_bytes");
+    bst_linetable_bytes.log(rtn->lines.getSize());
 
     // TODO add code which serializes the final bytecode to disk
 
@@ -223,6 +223,41 @@ public:
                      llvm::DenseMap<class TrackingVRegPtr, InternedString>& id_vreg);
 };
 
+// Maps bytecode offsets to line numbers, so that the BST nodes don't have to carry one each.  Like CPython's
+// co_lnotab, this is a list of (offset delta, line delta) pairs with an entry for every statement that is on a
+// different line than the one before it; a statement without an entry is on the line of the closest entry before it.
+// The deltas are stored as variable length integers, and the line deltas are signed since blocks are not laid out in
+// source order.
+//
+// Lookups have to decode the table from the start, which is fine for its users: tracebacks, frame.f_lineno and the
+// debug info of the llvm tier (which uses a Cursor).
+class LineTable {
+private:
+    std::vector<unsigned char> data;
+
+public:
+    // Takes (offset, lineno) pairs in any order; if an offset appears more than once, the last entry for it wins.
+    // Entries with lineno 0 (unknown) are ignored.
+    void build(std::vector<std::pair<int, int>> entries);
+
+    int getLineno(int offset) const;
+    int getSize() const { return data.size(); }
+
+    // Lookup state for a sequence of (mostly) increasing offsets, such as the statements of a block.
+    class Cursor {
+    private:
+        const LineTable& table;
+        int pos; // position of the next entry in data
+        // offset and line of the last entry that was decoded
+        int cur_offset, cur_lineno;
+
+    public:
+        Cursor(const LineTable& table) : table(table), pos(0), cur_offset(0), cur_lineno(0) {}
+
+        int getLineno(int offset);
+    };
+};
+
 // Control Flow Graph
 class CFG {
 private:
@@ -232,6 +267,7 @@ private:
 public:
     std::vector<CFGBlock*> blocks;
     BSTAllocator bytecode;
+    LineTable lines;
 
 public:
     CFG() : next_idx(0) {}
@@ -287,6 +323,9 @@ public:
         return (BST_stmt*)&bytecode.getData()[offset];
     }
 
+    int getLineno(int stmt_offset) const { return lines.getLineno(stmt_offset); }
+    int getLineno(BST_stmt* stmt) const { return lines.getLineno(bytecode.getOffset(stmt)); }
+
     void print(const CodeConstants& code_constants, llvm::raw_ostream& stream = llvm::outs());
 };
 
@@ -0,0 +1,541 @@
+// Copyright (c) 2014-2016 Dropbox, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef PYSTON_CORE_COMPACTMAP_H
+#define PYSTON_CORE_COMPACTMAP_H
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace pyston {
+
+// A hash map with the same interface as pyston::DenseMap (for the parts that we use), but with the layout of
+// CPython 3.6's compact dicts: the (key, value) entries are stored densely in a separate array, and the hash table
+// itself only holds entry numbers.  The index table uses 1, 2 or 4 byte slots depending on its size, so it is much
+// smaller than a table of full buckets.
+//
+// The probing sequence, resize policy and iteration order (by index slot) are exactly the same as DenseMap's, which
+// in turn copies CPython 2.7's dicts, so switching a map from one to the other doesn't change the order in which
+// Python code sees dict items.
+//
+// Like DenseMap, it uses KeyInfoT::getHashValue and KeyInfoT::isEqual, and marks deleted entries with
+// KeyInfoT::getTombstoneKey(), so that key can't be inserted.  Iterators are invalidated by insertions that
+// cause the table to be resized.
+//
+// KeyInfoT also has to provide isFastKey() and isEqualFast(): while every key in the map is a "fast" key, lookups of
+// fast keys compare with isEqualFast instead of isEqual.  This is how dicts get CPython's lookdict_string behavior.
+// Inserting a key that isn't fast switches the map over to isEqual, until the next resize finds that all the
+// remaining keys are fast again.
+template <typename KeyT, typename ValueT, typename KeyInfoT, unsigned MinSize = 8> class CompactMap {
+public:
+    typedef std::pair<KeyT, ValueT> value_type;
+    typedef unsigned size_type;
+
+private:
+    static_assert(MinSize >= 8 && (MinSize & (MinSize - 1)) == 0, "MinSize must be a power of two, at least 8");
+
+    enum : int {
+        EMPTY = -1,
+        DUMMY = -2,
+    };
+
+    // A Header, then the index table (num_indices slots of indexWidth() bytes each), then the entries array.
+    char* table = NULL;
+    // The number of slots in the index table; a power of two, or zero if nothing has been allocated.
+    unsigned num_indices = 0;
+    // The number of used entries, including deleted ones.
+    unsigned num_entries = 0;
+    // The number of live entries.
+    unsigned num_live = 0;
+    // The number of DUMMY slots in the index table.
+    unsigned num_dummies = 0;
+
+    struct Header {
+        uint32_t capacity;   // the size of the entries array
+        uint16_t width;      // the size of each index slot, which has to be able to hold any entry number
+        bool all_fast_keys;  // whether every key in the map is a fast key
+    };
+
+    static unsigned indexWidthFor(unsigned capacity) {
+        if (capacity <= (1 << 7))
+            return 1;
+        if (capacity <= (1 << 15))
+            return 2;
+        return 4;
+    }
+
+    // The resize policy below keeps fewer than 2/3 of the slots in use, so that's how many entries we leave room for.
+    static unsigned defaultCapacityFor(unsigned n) { return (n << 1) / 3 + 1; }
+    static size_t tableBytes(unsigned n, unsigned capacity) {
+        return sizeof(Header) + n * indexWidthFor(capacity) + capacity * sizeof(value_type);
+    }
+
+    Header* header() const { return reinterpret_cast<Header*>(table); }
+    unsigned entriesCapacity() const { return header()->capacity; }
+    unsigned indexWidth() const { return header()->width; }
+    char* indices() const { return table + sizeof(Header); }
+    value_type* entries() const { return reinterpret_cast<value_type*>(indices() + num_indices * indexWidth()); }
+
+    static int readIndex(const char* indices, unsigned width, unsigned slot) {
+        switch (width) {
+            case 1:
+                return reinterpret_cast<const int8_t*>(indices)[slot];
+            case 2:
+                return reinterpret_cast<const int16_t*>(indices)[slot];
+            default:
+                return reinterpret_cast<const int32_t*>(indices)[slot];
+        }
+    }
+
+    static void writeIndex(char* indices, unsigned width, unsigned slot, int ix) {
+        switch (width) {
+            case 1:
+                reinterpret_cast<int8_t*>(indices)[slot] = ix;
+                break;
+            case 2:
+                reinterpret_cast<int16_t*>(indices)[slot] = ix;
+                break;
+            default:
+                reinterpret_cast<int32_t*>(indices)[slot] = ix;
+                break;
+        }
+    }
+
+    int getIndex(unsigned slot) const { return readIndex(indices(), indexWidth(), slot); }
+    void setIndex(unsigned slot, int ix) { writeIndex(indices(), indexWidth(), slot, ix); }
+
+    static bool isDeleted(const value_type& entry) {
+        return KeyInfoT::isEqual(entry.first, KeyInfoT::getTombstoneKey());
+    }
+
+    // Same as DenseMap::grow's sizing: the smallest power of two that is at least at_least, and at least MinSize.
+    static unsigned sizeFor(unsigned at_least) {
+        unsigned n = MinSize;
+        while (n < at_least)
+            n <<= 1;
+        return n;
+    }
+
+    // Returns the entry number for the given key, or -1 if it's not in the map.  Stores the index slot that points to
+    // the entry, or if the key isn't in the map, the slot where it should get inserted (the first DUMMY slot on the
+    // probe sequence, if there is one).
+    int lookup(const KeyT& key, unsigned& slot_out) const {
+        if (header()->all_fast_keys && KeyInfoT::isFastKey(key))
+            return lookupImpl<true>(key, slot_out);
+        return lookupImpl<false>(key, slot_out);
+    }
+
+    template <bool Fast> int lookupImpl(const KeyT& key, unsigned& slot_out) const {
+        assert(num_indices);
+        size_t perturb = KeyInfoT::getHashValue(key);
+        unsigned mask = num_indices - 1;
+        unsigned slot = perturb & mask;
+        int free_slot = -1;
+        value_type* ents = entries();
+
+        while (true) {
+            int ix = getIndex(slot);
+            if (ix == EMPTY) {
+                slot_out = free_slot >= 0 ? free_slot : slot;
+                return -1;
+            }
+
+            if (ix == DUMMY) {
+                if (free_slot < 0)
+                    free_slot = slot;
+            } else if (Fast ? KeyInfoT::isEqualFast(key, ents[ix].first) : KeyInfoT::isEqual(key, ents[ix].first)) {
+                slot_out = slot;
+                return ix;
+            }
+
+            slot = ((slot << 2) + slot + perturb + 1) & mask;
+            perturb >>= 5;
+        }
+    }
+
+    // Finds the index slot that points to entry number ix.
+    unsigned findSlotOfEntry(int ix) const {
+        size_t perturb = KeyInfoT::getHashValue(entries()[ix].first);
+        unsigned mask = num_indices - 1;
+        unsigned slot = perturb & mask;
+        while (getIndex(slot) != ix) {
+            assert(getIndex(slot) != EMPTY);
+            slot = ((slot << 2) + slot + perturb + 1) & mask;
+            perturb >>= 5;
+        }
+        return slot;
+    }
+
+    void allocate(unsigned n, unsigned capacity) {
+        table = static_cast<char*>(malloc(tableBytes(n, capacity)));
+        header()->capacity = capacity;
+        header()->width = indexWidthFor(capacity);
+        header()->all_fast_keys = true;
+        num_indices = n;
+        num_entries = num_live = num_dummies = 0;
+        memset(indices(), 0xff, n * indexWidth()); // sets every slot to EMPTY
+    }
+
+    // Reallocates the table to have new_num_indices index slots.  Like DenseMap::moveFromOldBuckets, this reinserts
+    // the old entries in the order of their old slots, so the new table ends up exactly like DenseMap's would.
+    void resize(unsigned new_num_indices) {
+        char* old_table = table;
+        unsigned old_num_indices = num_indices;
+        unsigned old_num_entries = num_entries;
+        unsigned old_num_live = num_live;
+        unsigned old_width = old_table ? indexWidth() : 0;
+        const char* old_indices = old_table ? indices() : NULL;
+        value_type* old_entries = old_table ? entries() : NULL;
+
+        allocate(new_num_indices, std::max(defaultCapacityFor(new_num_indices), old_num_live + 1));
+        if (!old_table)
+            return;
+
+        value_type* new_entries = entries();
+        unsigned mask = num_indices - 1;
+        unsigned n = 0;
+        bool all_fast_keys = true;
+        for (unsigned i = 0; i < old_num_indices; i++) {
+            int ix = readIndex(old_indices, old_width, i);
+            if (ix < 0)
+                continue;
+
+            new (&new_entries[n]) value_type(std::move(old_entries[ix]));
+            if (!KeyInfoT::isFastKey(new_entries[n].first))
+                all_fast_keys = false;
+
+            size_t perturb = KeyInfoT::getHashValue(new_entries[n].first);
+            unsigned slot = perturb & mask;
+            while (getIndex(slot) != EMPTY) {
+                slot = ((slot << 2) + slot + perturb + 1) & mask;
+                perturb >>= 5;
+            }
+            setIndex(slot, n);
+            n++;
+        }
+        assert(n == old_num_live);
+        num_entries = num_live = n;
+        header()->all_fast_keys = all_fast_keys;
+
+        for (unsigned i = 0; i < old_num_entries; i++)
+            old_entries[i].~value_type();
+        free(old_table);
+    }
+
+    // Makes room to append one more entry to the entries array, without changing the index table (and so without
+    // changing the iteration order).  Deleted entries get squeezed out if there are enough of them, otherwise the
+    // entries array gets bigger.
+    void reserveEntry() {
+        unsigned capacity = entriesCapacity();
+        if (num_entries < capacity)
+            return;
+
+        if (num_entries - num_live >= capacity / 8) {
+            value_type* ents = entries();
+            unsigned n = 0;
+            for (unsigned i = 0; i < num_entries; i++) {
+                if (isDeleted(ents[i])) {
+                    ents[i].~value_type();
+                    continue;
+                }
+                if (n != i) {
+                    setIndex(findSlotOfEntry(i), n);
+                    new (&ents[n]) value_type(std::move(ents[i]));
+                    ents[i].~value_type();
+                }
+                n++;
+            }
+            assert(n == num_live);
+            num_entries = n;
+            return;
+        }
+
+        unsigned new_capacity = capacity + capacity / 2;
+        unsigned new_width = indexWidthFor(new_capacity);
+        char* new_table = static_cast<char*>(malloc(tableBytes(num_indices, new_capacity)));
+        reinterpret_cast<Header*>(new_table)->capacity = new_capacity;
+        reinterpret_cast<Header*>(new_table)->width = new_width;
+        reinterpret_cast<Header*>(new_table)->all_fast_keys = header()->all_fast_keys;
+        char* new_indices = new_table + sizeof(Header);
+        for (unsigned i = 0; i < num_indices; i++)
+            writeIndex(new_indices, new_width, i, getIndex(i));
+        value_type* old_entries = entries();
+        value_type* new_entries = reinterpret_cast<value_type*>(new_indices + num_indices * new_width);
+        for (unsigned i = 0; i < num_entries; i++) {
+            new (&new_entries[i]) value_type(std::move(old_entries[i]));
+            old_entries[i].~value_type();
+        }
+        free(table);
+        table = new_table;
+    }
+
+    // Same policy as DenseMap::growMaybe.  Returns whether the table got reallocated.
+    bool growMaybe() {
+        if (num_live * 3 >= num_indices * 2) {
+            resize(sizeFor(num_live * (num_live > 50000 ? 2 : 4)));
+            return true;
+        }
+        if (num_indices - (num_live + num_dummies) <= num_indices / 8) {
+            resize(num_indices);
+            return true;
+        }
+        return false;
+    }
+
+    void destroyAll() {
+        value_type* ents = entries();
+        for (unsigned i = 0; i < num_entries; i++)
+            ents[i].~value_type();
+    }
+
+    void eraseAt(unsigned slot) {
+        int ix = getIndex(slot);
+        assert(ix >= 0);
+        setIndex(slot, DUMMY);
+        value_type& entry = entries()[ix];
+        entry.~value_type();
+        new (&entry) value_type(KeyInfoT::getTombstoneKey(), ValueT());
+        num_live--;
+        num_dummies++;
+    }
+
+public:
+    template <bool IsConst> class Iterator {
+    private:
+        typedef typename std::conditional<IsConst, const CompactMap, CompactMap>::type map_type;
+        typedef typename std::conditional<IsConst, const value_type, value_type>::type entry_type;
+        map_type* map;
+        unsigned slot;
+
+        void skipEmpty() {
+            while (slot < map->num_indices && map->getIndex(slot) < 0)
+                ++slot;
+        }
+
+    public:
+        Iterator() : map(NULL), slot(0) {}
+        Iterator(map_type* map, unsigned slot, bool skip = true) : map(map), slot(slot) {
+            if (skip)
+                skipEmpty();
+        }
+        // Allow conversion from iterator to const_iterator:
+        template <bool WasConst, typename = typename std::enable_if<IsConst && !WasConst>::type>
+        Iterator(const Iterator<WasConst>& it)
+            : map(it.map), slot(it.slot) {}
+
+        entry_type& operator*() const { return map->entries()[map->getIndex(slot)]; }
+        entry_type* operator->() const { return &map->entries()[map->getIndex(slot)]; }
+
+        bool operator==(const Iterator& rhs) const { return slot == rhs.slot; }
+        bool operator!=(const Iterator& rhs) const { return slot != rhs.slot; }
+
+        Iterator& operator++() {
+            ++slot;
+            skipEmpty();
+            return *this;
+        }
+
+        friend class CompactMap;
+        friend class Iterator<!IsConst>;
+    };
+    typedef Iterator<false> iterator;
+    typedef Iterator<true> const_iterator;
+
+    CompactMap() {}
+    CompactMap(const CompactMap& rhs) {
+        // Like DenseMap, copy the table as-is so that the copy iterates in the same order.
+        if (!rhs.table)
+            return;
+        size_t index_bytes = sizeof(Header) + rhs.num_indices * rhs.indexWidth();
+        table = static_cast<char*>(malloc(tableBytes(rhs.num_indices, rhs.entriesCapacity())));
+        memcpy(table, rhs.table, index_bytes);
+        num_indices = rhs.num_indices;
+        num_entries = rhs.num_entries;
+        num_live = rhs.num_live;
+        num_dummies = rhs.num_dummies;
+        value_type* ents = entries();
+        value_type* rhs_ents = rhs.entries();
+        for (unsigned i = 0; i < num_entries; i++)
+            new (&ents[i]) value_type(rhs_ents[i]);
+    }
+    CompactMap(CompactMap&& rhs) { swap(rhs); }
+    CompactMap& operator=(const CompactMap& rhs) {
+        if (this != &rhs) {
+            CompactMap copy(rhs);
+            swap(copy);
+        }
+        return *this;
+    }
+    CompactMap& operator=(CompactMap&& rhs) {
+        swap(rhs);
+        return *this;
+    }
+    ~CompactMap() {
+        if (table) {
+            destroyAll();
+            free(table);
+        }
+    }
+
+    void swap(CompactMap& rhs) {
+        std::swap(table, rhs.table);
+        std::swap(num_indices, rhs.num_indices);
+        std::swap(num_entries, rhs.num_entries);
+        std::swap(num_live, rhs.num_live);
+        std::swap(num_dummies, rhs.num_dummies);
+    }
+
+    iterator begin() { return iterator(this, 0); }
+    iterator end() { return iterator(this, num_indices, false); }
+    const_iterator begin() const { return const_iterator(this, 0); }
+    const_iterator end() const { return const_iterator(this, num_indices, false); }
+
+    bool empty() const { return num_live == 0; }
+    size_type size() const { return num_live; }
+
+    iterator find(const KeyT& key) {
+        if (!num_live)
+            return end();
+        unsigned slot;
+        if (lookup(key, slot) < 0)
+            return end();
+        return iterator(this, slot, false);
+    }
+    const_iterator find(const KeyT& key) const {
+        if (!num_live)
+            return end();
+        unsigned slot;
+        if (lookup(key, slot) < 0)
+            return end();
+        return const_iterator(this, slot, false);
+    }
+
+    size_type count(const KeyT& key) const { return find(key) == end() ? 0 : 1; }
+
+    ValueT lookup(const KeyT& key) const {
+        auto it = find(key);
+        if (it == end())
+            return ValueT();
+        return it->second;
+    }
+
+    std::pair<iterator, bool> insert(const value_type& kv) {
+        if (!num_indices)
+            resize(sizeFor(4));
+
+        unsigned slot;
+        if (lookup(kv.first, slot) >= 0)
+            return std::make_pair(iterator(this, slot, false), false);
+
+        reserveEntry();
+        if (getIndex(slot) == DUMMY)
+            num_dummies--;
+        unsigned ix = num_entries++;
+        new (&entries()[ix]) value_type(kv);
+        setIndex(slot, ix);
+        num_live++;
+        if (!KeyInfoT::isFastKey(kv.first))
+            header()->all_fast_keys = false;
+
+        if (growMaybe()) {
+            int found = lookup(kv.first, slot);
+            assert(found >= 0);
+            (void)found;
+        }
+        return std::make_pair(iterator(this, slot, false), true);
+    }
+
+    ValueT& operator[](const KeyT& key) { return insert(std::make_pair(key, ValueT())).first->second; }
+
+    bool erase(const KeyT& key) {
+        if (!num_live)
+            return false;
+        unsigned slot;
+        if (lookup(key, slot) < 0)
+            return false;
+        eraseAt(slot);
+        return true;
+    }
+
+    void erase(iterator it) {
+        assert(it.map == this && it.slot < num_indices);
+        eraseAt(it.slot);
+    }
+
+    // Same as DenseMap::grow: reallocates the table to have room for at least this many entries.
+    void grow(unsigned at_least) {
+        unsigned new_num_indices = sizeFor(at_least);
+        assert(new_num_indices * 2 > num_live * 3);
+        resize(new_num_indices);
+    }
+
+    // Same as DenseMap::clear, including shrinking the table if it was mostly empty.
+    void clear() {
+        if (num_live == 0 && num_dummies == 0)
+            return;
+
+        if (num_live * 4 < num_indices && num_indices > MinSize) {
+            unsigned old_num_live = num_live;
+            unsigned new_num_indices = 0;
+            if (old_num_live) {
+                new_num_indices = 1;
+                while (new_num_indices < old_num_live)
+                    new_num_indices <<= 1;
+                new_num_indices = std::max(MinSize, new_num_indices * 2);
+            }
+            freeAllMemory();
+            if (new_num_indices)
+                allocate(new_num_indices, defaultCapacityFor(new_num_indices));
+            return;
+        }
+
+        destroyAll();
+        memset(indices(), 0xff, num_indices * indexWidth());
+        num_entries = num_live = num_dummies = 0;
+        header()->all_fast_keys = true;
+    }
+
+    void freeAllMemory() {
+        if (!table)
+            return;
+        destroyAll();
+        free(table);
+        table = NULL;
+        num_indices = num_entries = num_live = num_dummies = 0;
+    }
+
+    // Whether lookups of fast keys are currently using KeyInfoT::isEqualFast.
+    bool allKeysFast() const { return !table || header()->all_fast_keys; }
+
+    size_t getMemorySize() const { return num_indices ? tableBytes(num_indices, entriesCapacity()) : 0; }
+
+    // Raw access by index slot, for PyDict_Next-style iteration by position.  Returns NULL for unused slots.
+    size_type numSlots() const { return num_indices; }
+    value_type* entryAtSlot(size_type slot) {
+        assert(slot < num_indices);
+        int ix = getIndex(slot);
+        if (ix < 0)
+            return NULL;
+        return &entries()[ix];
+    }
+};
+}
+
+#endif
@@ -121,6 +121,26 @@ public:
       grow(Size);
   }
 
+  // Pyston addition:
+  // Makes room for NumNew more entries before a bulk insert, the same way CPython's set_merge
+  // presizes its table, so that the merge itself never rehashes.
+  void reserveForMerge(unsigned NumNew) {
+    if (NumNew == 0)
+      return;
+    unsigned Buckets = std::max<unsigned>(getNumBuckets(), MinSize);
+    if ((getNumEntries() + getNumTombstones() + NumNew) * 3 >= Buckets * 2)
+      grow((getNumEntries() + NumNew) * 2 + 1);
+  }
+
+  // Pyston addition:
+  // CPython rebuilds a set's table after set_difference_update if more than 1/5 of it is dummies.
+  void compactAfterRemovals() {
+    if (getNumTombstones() * 5 < getNumBuckets() - 1)
+      return;
+    unsigned NumEntries = getNumEntries();
+    grow((NumEntries > 50000 ? NumEntries * 2 : NumEntries * 4) + 1);
+  }
+
   void clear() {
     if (getNumEntries() == 0 && getNumTombstones() == 0) return;
 
@@ -77,6 +77,10 @@ public:
   /// the Size of the set.
   void resize(size_t Size) { TheMap.resize(Size); }
 
+  // Pyston additions, see DenseMap:
+  void reserveForMerge(unsigned NumNew) { TheMap.reserveForMerge(NumNew); }
+  void compactAfterRemovals() { TheMap.compactAfterRemovals(); }
+
   void clear() {
     TheMap.clear();
   }
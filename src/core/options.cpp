@@ -79,6 +79,9 @@ bool ENABLE_PYSTON_PASSES = 0 && _GLOBAL_ENABLE;
 bool ENABLE_TYPE_FEEDBACK = 1 && _GLOBAL_ENABLE;
 bool ENABLE_RUNTIME_ICS = 1 && _GLOBAL_ENABLE;
 bool ENABLE_JIT_OBJECT_CACHE = 1 && _GLOBAL_ENABLE;
+// Redundancy elimination on the rewriter's action list (load CSE, guard merging, dead loads).
+// Turn it off to compare the ic_rewrites_total_bytes stat with and without it.
+bool ENABLE_REWRITER_PEEPHOLE = 1 && ENABLE_ICS;
 
 bool ENABLE_FRAME_INTROSPECTION = 1;
 
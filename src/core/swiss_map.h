@@ -0,0 +1,386 @@
+// Copyright (c) 2014-2016 Dropbox, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef PYSTON_CORE_SWISSMAP_H
+#define PYSTON_CORE_SWISSMAP_H
+
+#include <cassert>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+#include "core/common.h"
+#include "core/from_llvm/DenseMapInfo.h"
+
+namespace pyston {
+
+// An open-addressing hash map in the style of Abseil's "Swiss tables", with the same interface as pyston::DenseMap
+// (for the parts that we use), so that a map can be switched from one to the other by changing its typedef.
+//
+// Next to the array of (key, value) slots there is an array of one-byte control words: either EMPTY, DELETED, or
+// 7 bits of the hash of the key in that slot.  A lookup loads the control bytes for a group of 16 slots at once
+// and compares them all against the hash with a couple of SSE2 instructions, so it only touches the slots whose
+// control byte matches, instead of every bucket along the probe sequence like DenseMap does.
+//
+// The differences from DenseMap:
+// - KeyInfoT::getEmptyKey() and getTombstoneKey() are never used, so every key value can be stored.
+// - Erasing leaves a DELETED control byte behind (a tombstone), like DenseMap; they get cleared out when the table
+//   gets rehashed.
+// - Iteration order is by slot, which is unrelated to CPython's dict order.  This is why dicts and sets don't use it.
+template <typename KeyT, typename ValueT, typename KeyInfoT = DenseMapInfo<KeyT>, unsigned MinSize = 16>
+class SwissMap {
+public:
+    typedef std::pair<KeyT, ValueT> value_type;
+    typedef unsigned size_type;
+
+private:
+    static const unsigned GROUP_SIZE = 16;
+    static_assert(MinSize >= GROUP_SIZE && (MinSize & (MinSize - 1)) == 0,
+                  "MinSize must be a power of two, and at least one group");
+
+    enum : int8_t {
+        EMPTY = -128,
+        DELETED = -2,
+    };
+
+    // num_slots control bytes, followed by the slots.
+    int8_t* ctrl = NULL;
+    value_type* slots = NULL;
+    // A power of two (and a multiple of GROUP_SIZE), or zero if nothing has been allocated.
+    unsigned num_slots = 0;
+    unsigned num_entries = 0;
+    unsigned num_tombstones = 0;
+
+    // Keep at least 1/8 of the slots empty, so that probe sequences stay short and always terminate.
+    static unsigned maxLoad(unsigned n) { return n - n / 8; }
+
+    static size_t hashOf(const KeyT& key) {
+        // The KeyInfoT hashes (pointer hashes in particular) aren't great in their high bits, which we use for the
+        // control bytes, so mix them first:
+        return (size_t)KeyInfoT::getHashValue(key) * 0x9E3779B97F4A7C15ull;
+    }
+    static int8_t h2(size_t hash) { return hash >> (sizeof(size_t) * 8 - 7); }
+    unsigned firstGroup(size_t hash) const { return (hash >> 7) & (num_slots / GROUP_SIZE - 1); }
+    unsigned nextGroup(unsigned group, unsigned step) const { return (group + step) & (num_slots / GROUP_SIZE - 1); }
+
+    // The control bytes of one group, with methods that return bitmasks (one bit per slot in the group) of the slots
+    // whose control bytes satisfy some condition.
+    struct Group {
+#ifdef __SSE2__
+        __m128i c;
+        explicit Group(const int8_t* p) : c(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p))) {}
+        unsigned match(int8_t b) const { return _mm_movemask_epi8(_mm_cmpeq_epi8(c, _mm_set1_epi8(b))); }
+        unsigned matchEmpty() const { return match(EMPTY); }
+        unsigned matchEmptyOrDeleted() const { return _mm_movemask_epi8(_mm_cmpgt_epi8(_mm_set1_epi8(-1), c)); }
+#else
+        const int8_t* c;
+        explicit Group(const int8_t* p) : c(p) {}
+        unsigned match(int8_t b) const {
+            unsigned r = 0;
+            for (unsigned i = 0; i < GROUP_SIZE; i++)
+                r |= (unsigned)(c[i] == b) << i;
+            return r;
+        }
+        unsigned matchEmpty() const { return match(EMPTY); }
+        unsigned matchEmptyOrDeleted() const {
+            unsigned r = 0;
+            for (unsigned i = 0; i < GROUP_SIZE; i++)
+                r |= (unsigned)(c[i] < -1) << i;
+            return r;
+        }
+#endif
+    };
+
+    // Returns the slot holding the key, or -1.
+    int findSlot(const KeyT& key) const {
+        if (!num_entries)
+            return -1;
+        size_t hash = hashOf(key);
+        int8_t tag = h2(hash);
+        unsigned group = firstGroup(hash);
+        for (unsigned step = 1;; step++) {
+            Group g(ctrl + group * GROUP_SIZE);
+            for (unsigned m = g.match(tag); m; m &= m - 1) {
+                unsigned slot = group * GROUP_SIZE + __builtin_ctz(m);
+                if (likely(KeyInfoT::isEqual(key, slots[slot].first)))
+                    return slot;
+            }
+            if (likely(g.matchEmpty()))
+                return -1;
+            group = nextGroup(group, step);
+        }
+    }
+
+    // Returns the first EMPTY or DELETED slot on the probe sequence for this hash.
+    unsigned findFreeSlot(size_t hash) const {
+        unsigned group = firstGroup(hash);
+        for (unsigned step = 1;; step++) {
+            unsigned m = Group(ctrl + group * GROUP_SIZE).matchEmptyOrDeleted();
+            if (m)
+                return group * GROUP_SIZE + __builtin_ctz(m);
+            group = nextGroup(group, step);
+        }
+    }
+
+    static unsigned sizeFor(unsigned num_entries) {
+        unsigned n = MinSize;
+        while (maxLoad(n) < num_entries)
+            n <<= 1;
+        return n;
+    }
+
+    void allocate(unsigned n) {
+        char* mem = static_cast<char*>(malloc(n + n * sizeof(value_type)));
+        ctrl = reinterpret_cast<int8_t*>(mem);
+        slots = reinterpret_cast<value_type*>(mem + n);
+        num_slots = n;
+        num_entries = num_tombstones = 0;
+        memset(ctrl, EMPTY, n);
+    }
+
+    void rehash(unsigned new_num_slots) {
+        assert(maxLoad(new_num_slots) >= num_entries);
+        int8_t* old_ctrl = ctrl;
+        value_type* old_slots = slots;
+        unsigned old_num_slots = num_slots;
+        unsigned old_num_entries = num_entries;
+
+        allocate(new_num_slots);
+        for (unsigned i = 0; i < old_num_slots; i++) {
+            if (old_ctrl[i] < 0)
+                continue;
+            size_t hash = hashOf(old_slots[i].first);
+            unsigned slot = findFreeSlot(hash);
+            ctrl[slot] = h2(hash);
+            new (&slots[slot]) value_type(std::move(old_slots[i]));
+            old_slots[i].~value_type();
+        }
+        num_entries = old_num_entries;
+        free(old_ctrl);
+    }
+
+    void destroyAll() {
+        for (unsigned i = 0; i < num_slots; i++) {
+            if (ctrl[i] >= 0)
+                slots[i].~value_type();
+        }
+    }
+
+    void eraseSlot(unsigned slot) {
+        assert(ctrl[slot] >= 0);
+        slots[slot].~value_type();
+        ctrl[slot] = DELETED;
+        num_entries--;
+        num_tombstones++;
+    }
+
+public:
+    template <bool IsConst> class Iterator {
+    private:
+        typedef typename std::conditional<IsConst, const value_type, value_type>::type entry_type;
+        entry_type* ptr;
+        const int8_t* c;
+        const int8_t* c_end;
+
+        void skipEmpty() {
+            while (c != c_end && *c < 0) {
+                ++c;
+                ++ptr;
+            }
+        }
+
+    public:
+        Iterator() : ptr(NULL), c(NULL), c_end(NULL) {}
+        Iterator(entry_type* ptr, const int8_t* c, const int8_t* c_end, bool skip = true)
+            : ptr(ptr), c(c), c_end(c_end) {
+            if (skip)
+                skipEmpty();
+        }
+        // Allow conversion from iterator to const_iterator:
+        template <bool WasConst, typename = typename std::enable_if<IsConst && !WasConst>::type>
+        Iterator(const Iterator<WasConst>& it)
+            : ptr(it.ptr), c(it.c), c_end(it.c_end) {}
+
+        entry_type& operator*() const { return *ptr; }
+        entry_type* operator->() const { return ptr; }
+
+        bool operator==(const Iterator& rhs) const { return ptr == rhs.ptr; }
+        bool operator!=(const Iterator& rhs) const { return ptr != rhs.ptr; }
+
+        Iterator& operator++() {
+            ++c;
+            ++ptr;
+            skipEmpty();
+            return *this;
+        }
+
+        friend class SwissMap;
+        friend class Iterator<!IsConst>;
+    };
+    typedef Iterator<false> iterator;
+    typedef Iterator<true> const_iterator;
+
+    SwissMap() {}
+    SwissMap(const SwissMap& rhs) {
+        if (!rhs.num_slots)
+            return;
+        allocate(rhs.num_slots);
+        memcpy(ctrl, rhs.ctrl, num_slots);
+        for (unsigned i = 0; i < num_slots; i++) {
+            if (ctrl[i] >= 0)
+                new (&slots[i]) value_type(rhs.slots[i]);
+        }
+        num_entries = rhs.num_entries;
+        num_tombstones = rhs.num_tombstones;
+    }
+    SwissMap(SwissMap&& rhs) { swap(rhs); }
+    SwissMap& operator=(const SwissMap& rhs) {
+        if (this != &rhs) {
+            SwissMap copy(rhs);
+            swap(copy);
+        }
+        return *this;
+    }
+    SwissMap& operator=(SwissMap&& rhs) {
+        swap(rhs);
+        return *this;
+    }
+    ~SwissMap() { freeAllMemory(); }
+
+    void swap(SwissMap& rhs) {
+        std::swap(ctrl, rhs.ctrl);
+        std::swap(slots, rhs.slots);
+        std::swap(num_slots, rhs.num_slots);
+        std::swap(num_entries, rhs.num_entries);
+        std::swap(num_tombstones, rhs.num_tombstones);
+    }
+
+    iterator begin() { return iterator(slots, ctrl, ctrl + num_slots); }
+    iterator end() { return iterator(slots + num_slots, ctrl + num_slots, ctrl + num_slots, false); }
+    const_iterator begin() const { return const_iterator(slots, ctrl, ctrl + num_slots); }
+    const_iterator end() const {
+        return const_iterator(slots + num_slots, ctrl + num_slots, ctrl + num_slots, false);
+    }
+
+    bool empty() const { return num_entries == 0; }
+    size_type size() const { return num_entries; }
+
+    iterator find(const KeyT& key) {
+        int slot = findSlot(key);
+        if (slot < 0)
+            return end();
+        return iterator(slots + slot, ctrl + slot, ctrl + num_slots, false);
+    }
+    const_iterator find(const KeyT& key) const {
+        int slot = findSlot(key);
+        if (slot < 0)
+            return end();
+        return const_iterator(slots + slot, ctrl + slot, ctrl + num_slots, false);
+    }
+
+    size_type count(const KeyT& key) const { return findSlot(key) < 0 ? 0 : 1; }
+
+    ValueT lookup(const KeyT& key) const {
+        int slot = findSlot(key);
+        if (slot < 0)
+            return ValueT();
+        return slots[slot].second;
+    }
+
+    std::pair<iterator, bool> insert(const value_type& kv) {
+        int existing = findSlot(kv.first);
+        if (existing >= 0)
+            return std::make_pair(iterator(slots + existing, ctrl + existing, ctrl + num_slots, false), false);
+
+        if (num_entries + num_tombstones + 1 > maxLoad(num_slots)) {
+            // If it's mostly tombstones, rehashing at the same size is enough to clean them out:
+            if (num_slots && num_entries + 1 <= maxLoad(num_slots) / 2)
+                rehash(num_slots);
+            else
+                rehash(sizeFor((num_entries + 1) * 2));
+        }
+
+        size_t hash = hashOf(kv.first);
+        unsigned slot = findFreeSlot(hash);
+        if (ctrl[slot] == DELETED)
+            num_tombstones--;
+        ctrl[slot] = h2(hash);
+        new (&slots[slot]) value_type(kv);
+        num_entries++;
+        return std::make_pair(iterator(slots + slot, ctrl + slot, ctrl + num_slots, false), true);
+    }
+
+    ValueT& operator[](const KeyT& key) {
+        int slot = findSlot(key);
+        if (slot >= 0)
+            return slots[slot].second;
+        return insert(std::make_pair(key, ValueT())).first->second;
+    }
+
+    bool erase(const KeyT& key) {
+        int slot = findSlot(key);
+        if (slot < 0)
+            return false;
+        eraseSlot(slot);
+        return true;
+    }
+
+    void erase(iterator it) { eraseSlot(it.c - ctrl); }
+
+    // Makes sure that the map can hold at least this many entries without having to be rehashed.
+    void grow(unsigned at_least) {
+        unsigned new_num_slots = sizeFor(at_least);
+        if (new_num_slots > num_slots)
+            rehash(new_num_slots);
+    }
+
+    void clear() {
+        if (num_entries == 0 && num_tombstones == 0)
+            return;
+
+        // Like DenseMap, shrink the table if it's mostly empty:
+        if (num_entries * 4 < num_slots && num_slots > MinSize) {
+            unsigned new_num_slots = sizeFor(num_entries);
+            freeAllMemory();
+            allocate(new_num_slots);
+            return;
+        }
+
+        destroyAll();
+        memset(ctrl, EMPTY, num_slots);
+        num_entries = num_tombstones = 0;
+    }
+
+    void freeAllMemory() {
+        if (!ctrl)
+            return;
+        destroyAll();
+        free(ctrl);
+        ctrl = NULL;
+        slots = NULL;
+        num_slots = num_entries = num_tombstones = 0;
+    }
+
+    size_t getMemorySize() const { return num_slots + num_slots * sizeof(value_type); }
+};
+}
+
+#endif
@@ -362,6 +362,11 @@ class FrameInfo;
 
 extern std::vector<Box*> constants;
 extern std::vector<Box*> late_constants; // constants that should be freed after normal constants
+// Makes b immortal (see _Py_SetImmortal in object.h).  Only for objects that live until teardown anyway and don't hold
+// references to other objects; instances of heap types reference their class, so those are left alone.
+// __pyston__.freeze() (_PyGC_Freeze) follows the same rule for heap-type instances, but the containers it makes
+// immortal do hold references, which is why teardown skips its refcount checks once the heap has been frozen.
+void makeImmortal(Box* b);
 
 // A specific compilation of a FunctionMetadata.  Usually these will be created by the LLVM JIT, which will take a
 // FunctionMetadata
@@ -699,6 +704,11 @@ public:
 
     HCAttrs(HiddenClass* hcls = NULL) : hcls(hcls), attr_list(nullptr) {}
 
+    // Instances of classes with BoxedClass::num_inline_attrs > 0 have their inline attribute slots
+    // directly following the HCAttrs struct.
+    AttrList* inlineAttrList() { return reinterpret_cast<AttrList*>(this + 1); }
+    bool hasInlineAttrList() { return attr_list == inlineAttrList(); }
+
     int traverse(visitproc visit, void* arg) noexcept;
 
     void _clearRaw() noexcept;       // Raw clear -- clears out and decrefs all the attrs.
@@ -708,6 +718,9 @@ public:
 };
 static_assert(sizeof(HCAttrs) == sizeof(struct _hcattrs), "");
 
+// The number of inline attribute slots that Python-defined classes reserve in their instances.
+#define NUM_INLINE_HCATTRS 4
+
 extern std::vector<BoxedClass*> classes;
 
 // Debugging helper: pass this as a tp_clear function to say that you have explicitly verified
@@ -786,6 +799,10 @@ struct FastToken {};
 extern FastToken FAST;
 struct FastGCToken {};
 extern FastGCToken FAST_GC;
+struct SlabToken {};
+extern SlabToken SLAB;
+struct SlabGCToken {};
+extern SlabGCToken SLAB_GC;
 
 
 // "Box" is the base class of any C++ type that implements a Python type.  For example,
@@ -812,6 +829,8 @@ protected:
     // The restrictions on when you can use the fast variant are encoded as assertions in the implementation
     // (see runtime/types.h)
     template <bool is_gc> static void* newFast(size_t size, BoxedClass* cls);
+    // newSlab(): like newFast(), but takes the memory from cls's slab allocator (see runtime/slab.h).
+    template <bool is_gc> static void* newSlab(size_t size, BoxedClass* cls);
 
 public:
     // Add a no-op constructor to make sure that we don't zero-initialize cls
@@ -821,6 +840,8 @@ public:
 
     void* operator new(size_t size, BoxedClass* cls, FastToken _dummy) { return newFast<false>(size, cls); }
     void* operator new(size_t size, BoxedClass* cls, FastGCToken _dummy) { return newFast<true>(size, cls); }
+    void* operator new(size_t size, BoxedClass* cls, SlabToken _dummy) { return newSlab<false>(size, cls); }
+    void* operator new(size_t size, BoxedClass* cls, SlabGCToken _dummy) { return newSlab<true>(size, cls); }
 
     void operator delete(void* ptr) __attribute__((visibility("default"))) { abort(); }
 
@@ -914,6 +935,14 @@ static_assert(offsetof(Box, cls) == offsetof(struct _object, ob_type), "");
     }                                                                                                                  \
     void* operator new(size_t size) __attribute__((visibility("default"))) { return newFast<is_gc>(size, default_cls); }
 
+// DEFAULT_CLASS_SIMPLE for classes whose instances are allocated from a slab of their own rather than from pymalloc.
+// Only worth it for small objects that get created and freed at a high rate.
+#define DEFAULT_CLASS_SIMPLE_SLAB(default_cls, is_gc)                                                                  \
+    void* operator new(size_t size, BoxedClass * cls) __attribute__((visibility("default"))) {                         \
+        return Box::operator new(size, cls);                                                                           \
+    }                                                                                                                  \
+    void* operator new(size_t size) __attribute__((visibility("default"))) { return newSlab<is_gc>(size, default_cls); }
+
 // This corresponds to CPython's PyVarObject, for objects with a variable number of "items" that are stored inline.
 // For example, strings and tuples store their data in line in the main object allocation, so are BoxVars.  Lists,
 // since they have a changeable size, store their elements in a separate array, and their main object is a fixed
@@ -970,8 +999,8 @@ static_assert(offsetof(BoxVar, ob_size) == offsetof(struct _varobject, ob_size),
                                                                                                                        \
         BoxVar* rtn = static_cast<BoxVar*>(mem);                                                                       \
         rtn->cls = default_cls;                                                                                        \
-        _Py_NewReference(rtn);                                                                                         \
         rtn->ob_size = nitems;                                                                                         \
+        _Py_NewReference(rtn);                                                                                         \
         return rtn;                                                                                                    \
     }
 
@@ -387,6 +387,8 @@ static int main(int argc, char** argv) noexcept {
 #ifdef SIGXFSZ
         PyOS_setsig(SIGXFSZ, SIG_IGN);
 #endif
+        if ((p = Py_GETENV("PYSTON_TYPE_STATS_SIGNAL")) && *p != '\0')
+            installTypeStatsSignalHandler(atoi(p));
 
 #ifndef NDEBUG
         if (LOG_IC_ASSEMBLY || LOG_BJIT_ASSEMBLY) {
@@ -465,7 +467,7 @@ static int main(int argc, char** argv) noexcept {
                 AST_Module* m;
                 std::unique_ptr<ASTAllocator> ast_allocator;
                 std::tie(m, ast_allocator) = parse_string(command, /* future_flags = */ 0);
-                compileAndRunModule(m, main_module);
+                compileAndRunModule(m, std::move(ast_allocator), main_module);
                 rtncode = 0;
             } catch (ExcInfo e) {
                 setCAPIException(e);
@@ -512,7 +514,7 @@ static int main(int argc, char** argv) noexcept {
                     AST_Module* ast;
                     std::tie(ast, ast_allocator) = parse_file(fn, /* future_flags = */ 0);
 
-                    compileAndRunModule(ast, main_module);
+                    compileAndRunModule(ast, std::move(ast_allocator), main_module);
                     rtncode = 0;
                 } catch (ExcInfo e) {
                     setCAPIException(e);
@@ -306,12 +306,63 @@ extern "C" Box* sum(Box* container, Box* initial) {
     static RuntimeICCache<BinopIC, 3> runtime_ic_cache;
     std::shared_ptr<BinopIC> pp = runtime_ic_cache.getIC(__builtin_return_address(0));
 
+    // Like CPython, keep the running total unboxed while everything is an exact int, and then
+    // (starting from a float, or when the int total turns into one) while everything is an exact
+    // float or int.  Once something else shows up we box the total and stay on the generic path.
+    enum { INT, FLOAT, GENERIC } mode = GENERIC;
+    i64 i_total = 0;
+    double f_total = 0;
+    bool leaving_int = false;
+    if (initial->cls == int_cls) {
+        mode = INT;
+        i_total = static_cast<BoxedInt*>(initial)->n;
+    } else if (initial->cls == float_cls) {
+        mode = FLOAT;
+        f_total = static_cast<BoxedFloat*>(initial)->d;
+    }
+
     Py_INCREF(initial);
     auto cur = autoDecref(initial);
     for (Box* e : container->pyElements()) {
         AUTO_DECREF(e);
+
+        if (mode == INT) {
+            i64 r;
+            if (e->cls == int_cls && !__builtin_saddl_overflow(i_total, static_cast<BoxedInt*>(e)->n, &r)) {
+                i_total = r;
+                continue;
+            }
+            cur = boxInt(i_total);
+            mode = GENERIC;
+            leaving_int = true;
+        } else if (mode == FLOAT) {
+            if (e->cls == float_cls) {
+                f_total += static_cast<BoxedFloat*>(e)->d;
+                continue;
+            }
+            if (e->cls == int_cls) {
+                f_total += (double)static_cast<BoxedInt*>(e)->n;
+                continue;
+            }
+            cur = boxFloat(f_total);
+            mode = GENERIC;
+        }
+
         cur = pp->call(cur, e, AST_TYPE::Add);
+
+        if (leaving_int) {
+            leaving_int = false;
+            if (cur->cls == float_cls) {
+                mode = FLOAT;
+                f_total = static_cast<BoxedFloat*>(cur.get())->d;
+            }
+        }
     }
+
+    if (mode == INT)
+        return boxInt(i_total);
+    if (mode == FLOAT)
+        return boxFloat(f_total);
     return incref(cur.get());
 }
 
@@ -2385,6 +2436,7 @@ void setupBuiltins() {
     ellipsis_cls->freeze();
     Ellipsis = new (ellipsis_cls) Box();
     assert(Ellipsis->cls);
+    makeImmortal(Ellipsis);
 
     constants.push_back(Ellipsis);
     builtins_module->giveAttrBorrowed("Ellipsis", Ellipsis);
@@ -2399,6 +2451,7 @@ void setupBuiltins() {
     notimplemented_cls->freeze();
     notimplemented_cls->instances_are_nonzero = true;
     NotImplemented = new (notimplemented_cls) Box();
+    makeImmortal(NotImplemented);
 
     constants.push_back(NotImplemented);
     builtins_module->giveAttrBorrowed("NotImplemented", NotImplemented);
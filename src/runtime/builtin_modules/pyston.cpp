@@ -12,6 +12,10 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <algorithm>
+#include <csignal>
+#include <unordered_set>
+
 #include "codegen/parser.h"
 #include "core/types.h"
 #include "runtime/objmodel.h"
@@ -20,6 +24,7 @@
 namespace pyston {
 
 BoxedModule* pyston_module;
+bool froze_heap = false;
 
 static Box* setOption(Box* option, Box* value) {
     if (option->cls != str_cls)
@@ -46,6 +51,7 @@ static Box* setOption(Box* option, Box* value) {
     else CHECK(SPECULATION_THRESHOLD);
     else CHECK(ENABLE_ICS);
     else CHECK(ENABLE_ICGETATTRS);
+    else CHECK(ENABLE_REWRITER_PEEPHOLE);
     else raiseExcHelper(ValueError, "unknown option name '%s", option_string->data());
 
     Py_RETURN_NONE;
@@ -76,6 +82,106 @@ static Box* pyCompile(Box* fname, Box* force) {
     Py_RETURN_NONE;
 }
 
+// Meant to be called in a pre-forking server right before it starts its workers: every object that
+// is alive is moved out of the cycle collector's generations, and all of them except instances of
+// heap types (see makeImmortal) become immortal, so the workers don't write to those objects'
+// refcounts or GC headers and the pages stay shared with the parent.
+static Box* freeze() {
+    // Don't keep garbage alive forever.
+    PyGC_Collect();
+    Py_ssize_t n = _PyGC_Freeze(1);
+    froze_heap = true;
+    return boxInt(n);
+}
+
+// Collects every type that has live instances, by walking the subclass lists down from object.
+static void collectLiveTypes(BoxedClass* cls, std::unordered_set<BoxedClass*>& seen, std::vector<BoxedClass*>& out) {
+    if (!seen.insert(cls).second)
+        return;
+    if (cls->tp_live_count)
+        out.push_back(cls);
+
+    if (!cls->tp_subclasses)
+        return;
+    assert(PyList_Check(cls->tp_subclasses));
+    for (Py_ssize_t i = 0; i < PyList_GET_SIZE(cls->tp_subclasses); i++) {
+        Box* sub = PyWeakref_GET_OBJECT(PyList_GET_ITEM(cls->tp_subclasses, i));
+        if (sub != Py_None)
+            collectLiveTypes(static_cast<BoxedClass*>(sub), seen, out);
+    }
+}
+
+static std::vector<BoxedClass*> liveTypes() {
+    std::unordered_set<BoxedClass*> seen;
+    std::vector<BoxedClass*> types;
+    collectLiveTypes(object_cls, seen, types);
+    std::sort(types.begin(), types.end(),
+              [](BoxedClass* a, BoxedClass* b) { return a->tp_live_bytes > b->tp_live_bytes; });
+    return types;
+}
+
+// Returns a list of (type, live instances, bytes) tuples, largest first.  The counts are maintained
+// on every allocation and deallocation (see _Py_INC_LIVE), so this is cheap enough to poll.
+static Box* typeStats() {
+    std::vector<BoxedClass*> types = liveTypes();
+
+    BoxedList* rtn = new BoxedList();
+    for (BoxedClass* cls : types) {
+        Box* entry = Py_BuildValue("(Onn)", cls, cls->tp_live_count, cls->tp_live_bytes);
+        if (!entry)
+            throwCAPIException();
+        listAppendInternalStolen(rtn, entry);
+    }
+    return rtn;
+}
+
+static void dumpTypeStats() {
+    Py_ssize_t total_count = 0, total_bytes = 0;
+    fprintf(stderr, "%12s %14s  %s\n", "count", "bytes", "type");
+    for (BoxedClass* cls : liveTypes()) {
+        fprintf(stderr, "%12zd %14zd  %s\n", cls->tp_live_count, cls->tp_live_bytes, cls->tp_name);
+        total_count += cls->tp_live_count;
+        total_bytes += cls->tp_live_bytes;
+    }
+    fprintf(stderr, "%12zd %14zd  total\n", total_count, total_bytes);
+}
+
+// Returns a list of (type, slabs, live objects, object capacity of those slabs, total allocations, slabs released)
+// tuples, one per class that allocates from slabs.
+static Box* slabStats() {
+    BoxedList* rtn = new BoxedList();
+    for (SlabAllocator* allocator : SlabAllocator::all()) {
+        Box* entry = Py_BuildValue("(OLLLLL)", allocator->cls, (PY_LONG_LONG)allocator->nslabs,
+                                   (PY_LONG_LONG)allocator->nobjects,
+                                   (PY_LONG_LONG)(allocator->nslabs * allocator->blocksPerSlab()),
+                                   (PY_LONG_LONG)allocator->nallocs, (PY_LONG_LONG)allocator->nreleased);
+        if (!entry)
+            throwCAPIException();
+        listAppendInternalStolen(rtn, entry);
+    }
+    return rtn;
+}
+
+static Box* pyDumpTypeStats() {
+    dumpTypeStats();
+    Py_RETURN_NONE;
+}
+
+static int dumpTypeStatsPendingCall(void*) {
+    dumpTypeStats();
+    return 0;
+}
+
+static void typeStatsSignalHandler(int sig) {
+    // Not safe to walk the types from inside the handler; do it at the next safe point.
+    Py_AddPendingCall(dumpTypeStatsPendingCall, NULL);
+}
+
+void installTypeStatsSignalHandler(int sig) {
+    if (PyOS_setsig(sig, typeStatsSignalHandler) == SIG_ERR)
+        fprintf(stderr, "warning: could not install the type stats handler for signal %d\n", sig);
+}
+
 void setupPyston() {
     pyston_module = createModule(autoDecref(boxString("__pyston__")));
 
@@ -90,5 +196,15 @@ void setupPyston() {
 
     pyston_module->giveAttr(
         "py_compile", new BoxedBuiltinFunctionOrMethod(BoxedCode::create((void*)pyCompile, UNKNOWN, 2, "pyCompile")));
+
+    pyston_module->giveAttr("freeze",
+                            new BoxedBuiltinFunctionOrMethod(BoxedCode::create((void*)freeze, UNKNOWN, 0, "freeze")));
+
+    pyston_module->giveAttr(
+        "typeStats", new BoxedBuiltinFunctionOrMethod(BoxedCode::create((void*)typeStats, UNKNOWN, 0, "typeStats")));
+    pyston_module->giveAttr("dumpTypeStats", new BoxedBuiltinFunctionOrMethod(BoxedCode::create(
+                                                 (void*)pyDumpTypeStats, NONE, 0, "dumpTypeStats")));
+    pyston_module->giveAttr(
+        "slabStats", new BoxedBuiltinFunctionOrMethod(BoxedCode::create((void*)slabStats, UNKNOWN, 0, "slabStats")));
 }
 }
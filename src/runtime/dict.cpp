@@ -314,6 +314,22 @@ template <enum ExceptionStyle S> Box* dictGetitem(BoxedDict* self, Box* k) noexc
     return incref(it->second);
 }
 
+// dict.__getitem__ for an exact dict and an exact str key; getitem ICs call this directly.
+Box* dictGetitemStr(BoxedDict* self, BoxedString* k) noexcept {
+    assert(self->cls == dict_cls && k->cls == str_cls);
+
+    // If there are non-str keys in the dict, the comparisons could run arbitrary code:
+    if (unlikely(!self->d.allKeysFast()))
+        return dictGetitem<CAPI>(self, k);
+
+    Box* r = self->getOrNull(k);
+    if (!r) {
+        PyErr_SetObject(KeyError, autoDecref(BoxedTuple::create1(k)));
+        return NULL;
+    }
+    return incref(r);
+}
+
 extern "C" PyObject* PyDict_New() noexcept {
     return new BoxedDict();
 }
@@ -408,43 +424,27 @@ extern "C" int PyDict_Next(PyObject* op, Py_ssize_t* ppos, PyObject** pkey, PyOb
     assert(PyDict_Check(op));
     BoxedDict* self = static_cast<BoxedDict*>(op);
 
-    // Callers of PyDict_New() provide a pointer to some storage for this function to use, in
-    // the form of a Py_ssize_t* -- ie they allocate a Py_ssize_t on their stack, and let us use
-    // it.
-    //
-    // We want to store an unordered_map::iterator in that.  In my glibc it would fit, but to keep
-    // things a little bit more portable, allocate separate storage for the iterator, and store the
-    // pointer to this storage in the Py_ssize_t slot.
-    //
-    // Results in lots of indirection unfortunately.  If it becomes an issue we can try to switch
-    // to storing the iterator directly in the stack slot.
-
-    typedef BoxedDict::DictMap::iterator iterator;
-
-    static_assert(sizeof(Py_ssize_t) == sizeof(iterator*), "");
-    iterator** it_ptr = reinterpret_cast<iterator**>(ppos);
-
-    // Clients are supposed to zero-initialize *ppos:
-    if (*it_ptr == NULL) {
-        *it_ptr = (iterator*)malloc(sizeof(iterator));
-        **it_ptr = self->d.begin();
-    }
-
-    iterator* it = *it_ptr;
-
-    if (*it == self->d.end()) {
-        free(it);
+    // Like in CPython, *ppos is the position in the hash table.
+    Py_ssize_t i = *ppos;
+    if (i < 0)
         return 0;
-    }
 
-    if (pkey)
-        *pkey = (*it)->first.value;
-    if (pvalue)
-        *pvalue = (*it)->second;
+    auto&& map = self->d;
+    for (; i < (Py_ssize_t)map.numSlots(); i++) {
+        auto* entry = map.entryAtSlot(i);
+        if (!entry)
+            continue;
 
-    ++(*it);
+        *ppos = i + 1;
+        if (pkey)
+            *pkey = entry->first.value;
+        if (pvalue)
+            *pvalue = entry->second;
+        return 1;
+    }
 
-    return 1;
+    *ppos = i;
+    return 0;
 }
 
 extern "C" BORROWED(PyObject*) PyDict_GetItemString(PyObject* dict, const char* key) noexcept {
@@ -948,7 +948,8 @@ static Box* characterize(BoxedDict* a, BoxedDict* b, Box** pval) noexcept {
         thisbval = NULL;
         try {
             it = b->d.find(thiskey);
-            thisbval = it->second;
+            if (it != b->d.end())
+                thisbval = it->second;
         } catch (ExcInfo e) {
             setCAPIException(e);
             goto Fail;
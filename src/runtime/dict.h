@@ -25,22 +25,29 @@ public:
     BoxedDict* d;
     BoxedDict::DictMap::iterator it;
     const BoxedDict::DictMap::iterator itEnd;
+    // For item iterators: the last (key, value) tuple we returned.  Like CPython, if nobody else
+    // holds a reference to it by the time the next item is requested, we refill it instead of
+    // allocating a new tuple.
+    BoxedTuple* result;
 
     BoxedDictIterator(BoxedDict* d);
 
     static void dealloc(BoxedDictIterator* o) noexcept {
         PyObject_GC_UnTrack(o);
         Py_DECREF(o->d);
+        Py_XDECREF(o->result);
         o->cls->tp_free(o);
     }
 
     static int traverse(BoxedDictIterator* self, visitproc visit, void* arg) noexcept {
         Py_VISIT(self->d);
+        Py_VISIT(self->result);
         return 0;
     }
 };
 
 Box* dictGetitem(BoxedDict* self, Box* k);
+Box* dictGetitemStr(BoxedDict* self, BoxedString* k) noexcept;
 
 Box* dict_iter(Box* s) noexcept;
 Box* dictIterKeys(Box* self);
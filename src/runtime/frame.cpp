@@ -140,9 +140,9 @@ public:
             return boxInt(f->_linenumber);
         }
 
-        BST_stmt* stmt = f->frame_info->code->source->cfg->getStmtFromOffset(f->frame_info->stmt_offset);
-        ASSERT(stmt->lineno > 0 && stmt->lineno < 1000000, "%d", stmt->lineno);
-        return boxInt(stmt->lineno);
+        int lineno = f->frame_info->code->source->cfg->getLineno(f->frame_info->stmt_offset);
+        ASSERT(lineno > 0 && lineno < 1000000, "%d", lineno);
+        return boxInt(lineno);
     }
 
     void handleFrameExit() {
@@ -156,9 +156,8 @@ public:
         assert(!_locals);
         _locals = incref(locals(this, NULL));
 
-        BST_stmt* stmt = frame_info->code->source->cfg->getStmtFromOffset(frame_info->stmt_offset);
-        ASSERT(stmt->lineno > 0 && stmt->lineno < 1000000, "%d", stmt->lineno);
-        _linenumber = stmt->lineno;
+        _linenumber = frame_info->code->source->cfg->getLineno(frame_info->stmt_offset);
+        ASSERT(_linenumber > 0 && _linenumber < 1000000, "%d", _linenumber);
 
         frame_info = NULL; // this means exited == true
         assert(hasExited());
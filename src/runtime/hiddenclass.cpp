@@ -27,6 +27,15 @@
 
 namespace pyston {
 
+// Memory used by normal hidden classes, which are never freed.
+static StatCounter hidden_class_bytes("hidden_class_bytes");
+
+// How many slow lookups a normal hidden class can get before we build its attr_offsets map.
+#define HCLS_MATERIALIZE_THRESHOLD 16
+
+// Number of children at which we switch to a hash map to find them.
+#define HCLS_CHILDREN_MAP_THRESHOLD 8
+
 HiddenClassSingleton* HiddenClass::makeSingleton() {
     return new HiddenClassSingleton;
 }
@@ -37,6 +46,7 @@ HiddenClassNormal* HiddenClass::makeRoot() {
     assert(!made);
     made = true;
 #endif
+    hidden_class_bytes.log(sizeof(HiddenClassNormal));
     return new HiddenClassNormal;
 }
 
@@ -60,15 +70,14 @@ void HiddenClassSingleton::appendAttribute(BoxedString* attr) {
     assert(type == SINGLETON);
     dependent_getattrs.invalidateAll();
     assert(attr_offsets.count(attr) == 0);
-    int n = this->attributeArraySize();
-    attr_offsets[attr] = n;
+    attr_offsets[attr] = array_size++;
 }
 
 void HiddenClassSingleton::appendAttrwrapper() {
     assert(type == SINGLETON);
     dependent_getattrs.invalidateAll();
     assert(attrwrapper_offset == -1);
-    attrwrapper_offset = this->attributeArraySize();
+    attrwrapper_offset = array_size++;
 }
 
 void HiddenClassSingleton::delAttribute(BoxedString* attr) {
@@ -87,6 +96,7 @@ void HiddenClassSingleton::delAttribute(BoxedString* attr) {
     }
     if (attrwrapper_offset != -1 && attrwrapper_offset > prev_idx)
         attrwrapper_offset--;
+    array_size--;
 }
 
 void HiddenClassSingleton::addDependence(Rewriter* rewriter) {
@@ -94,24 +104,123 @@ void HiddenClassSingleton::addDependence(Rewriter* rewriter) {
     rewriter->addDependenceOn(dependent_getattrs);
 }
 
+int HiddenClassSingletonOrNormal::getOffsetSlow(BoxedString* attr) {
+    HiddenClassNormal* self = getAsNormal();
+    if (++self->slow_lookups > HCLS_MATERIALIZE_THRESHOLD) {
+        materializeAttrOffsets();
+        return getOffset(attr);
+    }
+    return self->lookupOffsetInChain(attr);
+}
+
+void HiddenClassSingletonOrNormal::materializeAttrOffsets() {
+    static StatCounter num_materialized("num_hidden_classes_materialized");
+    num_materialized.log();
+
+    HiddenClassNormal* self = getAsNormal();
+    assert(!attr_offsets_valid);
+
+    // Start from the closest ancestor that already has its map, and add the attributes that came after it.
+    llvm::SmallVector<HiddenClassNormal*, 16> chain;
+    HiddenClassNormal* cur = self;
+    while (!cur->attr_offsets_valid) {
+        chain.push_back(cur);
+        cur = cur->parent;
+    }
+
+    attr_offsets = cur->attr_offsets;
+    for (auto it = chain.rbegin(), end = chain.rend(); it != end; ++it) {
+        if ((*it)->added_attr)
+            attr_offsets[(*it)->added_attr] = (*it)->array_size - 1;
+    }
+    attr_offsets_valid = true;
+
+    hidden_class_bytes.log(attr_offsets.getMemorySize());
+}
+
+HiddenClassNormal::HiddenClassNormal(HiddenClassNormal* parent, BoxedString* added_attr)
+    : HiddenClassSingletonOrNormal(HiddenClass::NORMAL), parent(parent), added_attr(added_attr) {
+    assert(parent->type == HiddenClass::NORMAL);
+    attrwrapper_offset = parent->attrwrapper_offset;
+    array_size = parent->array_size + 1;
+    attr_offsets_valid = false;
+    if (!added_attr)
+        attrwrapper_offset = parent->array_size;
+
+    hidden_class_bytes.log(sizeof(HiddenClassNormal));
+}
+
+int HiddenClassNormal::lookupOffsetInChain(BoxedString* attr) {
+    for (HiddenClassNormal* cur = this;; cur = cur->parent) {
+        if (cur->attr_offsets_valid) {
+            auto it = cur->attr_offsets.find(attr);
+            if (it == cur->attr_offsets.end())
+                return -1;
+            return it->second;
+        }
+        if (cur->added_attr == attr)
+            return cur->array_size - 1;
+        // The root always has a valid (empty) map, so we will stop there.
+        assert(cur->parent);
+    }
+}
+
+HiddenClassNormal* HiddenClassNormal::findChild(BoxedString* attr) {
+    if (children_map) {
+        auto it = children_map->find(attr);
+        if (it == children_map->end())
+            return NULL;
+        return it->second;
+    }
+
+    for (auto&& p : children) {
+        if (p.first == attr)
+            return p.second;
+    }
+    return NULL;
+}
+
+void HiddenClassNormal::addChild(BoxedString* attr, HiddenClassNormal* child) {
+    if (!children_map && children.size() < HCLS_CHILDREN_MAP_THRESHOLD) {
+        size_t old_capacity = children.capacity();
+        children.push_back(std::make_pair(attr, child));
+        if (children.capacity() != old_capacity)
+            hidden_class_bytes.log((children.capacity() - old_capacity) * sizeof(children[0]));
+        return;
+    }
+
+    if (!children_map) {
+        children_map.reset(new pyston::SwissMap<BoxedString*, HiddenClassNormal*>());
+        for (auto&& p : children)
+            (*children_map)[p.first] = p.second;
+        children.clear();
+        hidden_class_bytes.log(sizeof(*children_map));
+    }
+
+    size_t old_size = children_map->getMemorySize();
+    (*children_map)[attr] = child;
+    if (children_map->getMemorySize() > old_size)
+        hidden_class_bytes.log(children_map->getMemorySize() - old_size);
+}
+
 HiddenClassNormal* HiddenClassNormal::getOrMakeChild(BoxedString* attr) {
     STAT_TIMER(t0, "us_timer_hiddenclass_getOrMakeChild", 0);
 
     assert(attr->interned_state != SSTATE_NOT_INTERNED);
     assert(type == NORMAL);
 
-    auto it = children.find(attr);
-    if (it != children.end())
-        return it->second;
+    HiddenClassNormal* child = findChild(attr);
+    if (child)
+        return child;
 
     static StatCounter num_hclses("num_hidden_classes");
     num_hclses.log();
 
     // XXX: need to hold a ref to the string (or maybe we don't if we can hook the un-interning)
-    HiddenClassNormal* rtn = new HiddenClassNormal(this);
-    rtn->attr_offsets[attr] = this->attributeArraySize();
-    this->children[attr] = rtn;
+    HiddenClassNormal* rtn = new HiddenClassNormal(this, attr);
+    addChild(attr, rtn);
     assert(rtn->attributeArraySize() == this->attributeArraySize() + 1);
+    assert(rtn->getOffset(attr) == this->attributeArraySize());
     return rtn;
 }
 
@@ -120,9 +229,9 @@ HiddenClassNormal* HiddenClassNormal::getAttrwrapperChild() {
     assert(attrwrapper_offset == -1);
 
     if (!attrwrapper_child) {
-        HiddenClassNormal* made = new HiddenClassNormal(this);
-        made->attrwrapper_offset = this->attributeArraySize();
+        HiddenClassNormal* made = new HiddenClassNormal(this, NULL);
         this->attrwrapper_child = made;
+        assert(made->attrwrapper_offset == this->attributeArraySize());
         assert(made->attributeArraySize() == this->attributeArraySize() + 1);
     }
 
@@ -137,32 +246,23 @@ HiddenClassNormal* HiddenClassNormal::delAttrToMakeHC(BoxedString* attr) {
 
     assert(attr->interned_state != SSTATE_NOT_INTERNED);
     assert(type == NORMAL);
-    int idx = getOffset(attr);
-    assert(idx >= 0);
-
-    std::vector<BoxedString*> new_attrs(attributeArraySize() - 1);
-    for (auto it = attr_offsets.begin(); it != attr_offsets.end(); ++it) {
-        if (it->second < idx)
-            new_attrs[it->second] = it->first;
-        else if (it->second > idx) {
-            new_attrs[it->second - 1] = it->first;
-        }
-    }
+    assert(getOffset(attr) >= 0);
 
-    int new_attrwrapper_offset = attrwrapper_offset;
-    if (new_attrwrapper_offset > idx)
-        new_attrwrapper_offset--;
+    // Find the hidden class that added the attribute; the result is its parent plus whatever got added after it.
+    llvm::SmallVector<HiddenClassNormal*, 16> added_after;
+    HiddenClassNormal* cur = this;
+    while (cur->added_attr != attr) {
+        added_after.push_back(cur);
+        cur = cur->parent;
+        assert(cur);
+    }
 
-    // TODO we can first locate the parent HiddenClass of the deleted
-    // attribute and hence avoid creation of its ancestors.
-    HiddenClassNormal* cur = root_hcls;
-    int curidx = 0;
-    for (const auto& attr : new_attrs) {
-        if (curidx == new_attrwrapper_offset)
-            cur = cur->getAttrwrapperChild();
+    cur = cur->parent;
+    for (auto it = added_after.rbegin(), end = added_after.rend(); it != end; ++it) {
+        if ((*it)->added_attr)
+            cur = cur->getOrMakeChild((*it)->added_attr);
         else
-            cur = cur->getOrMakeChild(attr);
-        curidx++;
+            cur = cur->getAttrwrapperChild();
     }
     if (cur == root_hcls)
         return NULL;
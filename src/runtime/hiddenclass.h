@@ -15,11 +15,14 @@
 #ifndef PYSTON_RUNTIME_HIDDENCLASS_H
 #define PYSTON_RUNTIME_HIDDENCLASS_H
 
+#include <memory>
+#include <llvm/ADT/SmallVector.h>
 #include <llvm/ADT/StringMap.h>
 
 #include "Python.h"
 
 #include "core/from_llvm/DenseMap.h"
+#include "core/swiss_map.h"
 #include "core/types.h"
 
 namespace pyston {
@@ -90,30 +93,38 @@ class HiddenClassSingletonOrNormal : public HiddenClass {
 protected:
     HiddenClassSingletonOrNormal(HCType type) : HiddenClass(type) {}
 
-    HiddenClassSingletonOrNormal(HiddenClassSingletonOrNormal* parent)
-        : HiddenClass(HiddenClass::NORMAL),
-          attrwrapper_offset(parent->attrwrapper_offset),
-          attr_offsets(parent->attr_offsets) {
-        assert(parent->type == HiddenClass::NORMAL);
-    }
-
     // If >= 0, is the offset where we stored an attrwrapper object
     int attrwrapper_offset = -1;
 
+    // The total number of slots in the attribute array.
+    int array_size = 0;
+
     typedef pyston::DenseMap<BoxedString*, int, pyston::DenseMapInfo<BoxedString*>,
                              pyston::detail::DenseMapPair<BoxedString*, int>, 16> Map;
+
+    // Singletons always keep attr_offsets up to date.  Normal hidden classes only record the attribute they add on
+    // top of their parent, and build attr_offsets once someone needs the whole mapping or once they have been
+    // looked up often enough; until then attr_offsets is empty and attr_offsets_valid is false.
+    bool attr_offsets_valid = true;
     Map attr_offsets;
 
+    int getOffsetSlow(BoxedString* attr);
+    void materializeAttrOffsets();
+
 public:
     // The mapping from string attribute names to attribute offsets.  There may be other objects in the attributes
     // array.
     BORROWED(const Map&) getStrAttrOffsets() {
         assert(type == NORMAL || type == SINGLETON);
+        if (unlikely(!attr_offsets_valid))
+            materializeAttrOffsets();
         return attr_offsets;
     }
 
     int getOffset(BoxedString* attr) {
         assert(type == NORMAL || type == SINGLETON);
+        if (unlikely(!attr_offsets_valid))
+            return getOffsetSlow(attr);
         auto it = attr_offsets.find(attr);
         if (it == attr_offsets.end())
             return -1;
@@ -129,10 +140,7 @@ public:
     // attributes.
     int attributeArraySize() {
         ASSERT(type == NORMAL || type == SINGLETON, "%d", type);
-        int r = attr_offsets.size();
-        if (attrwrapper_offset != -1)
-            r += 1;
-        return r;
+        return array_size;
     }
 
     friend class HiddenClass;
@@ -141,17 +149,33 @@ public:
 class HiddenClassNormal final : public HiddenClassSingletonOrNormal {
 protected:
     HiddenClassNormal() : HiddenClassSingletonOrNormal(HiddenClass::NORMAL) {}
-    HiddenClassNormal(HiddenClassNormal* parent) : HiddenClassSingletonOrNormal(parent) {}
+    HiddenClassNormal(HiddenClassNormal* parent, BoxedString* added_attr);
+
+    // The hidden class that this one was derived from, and the attribute that was appended to get here
+    // (NULL if it was the attrwrapper).  Only the root has no parent.
+    HiddenClassNormal* parent = NULL;
+    BoxedString* added_attr = NULL;
 
-    pyston::SmallDenseMap<BoxedString*, HiddenClassNormal*> children;
+    // How many times getOffset() had to walk up the parent chain.
+    int slow_lookups = 0;
+
+    // Most hidden classes have very few children, so we search them linearly and only switch to a hash map
+    // once there are a lot of them.
+    llvm::SmallVector<std::pair<BoxedString*, HiddenClassNormal*>, 1> children;
+    std::unique_ptr<pyston::SwissMap<BoxedString*, HiddenClassNormal*>> children_map;
     HiddenClassNormal* attrwrapper_child = NULL;
 
+    HiddenClassNormal* findChild(BoxedString* attr);
+    void addChild(BoxedString* attr, HiddenClassNormal* child);
+    int lookupOffsetInChain(BoxedString* attr);
+
 public:
     HiddenClassNormal* getOrMakeChild(BoxedString* attr);
     HiddenClassNormal* getAttrwrapperChild();
     HiddenClassNormal* delAttrToMakeHC(BoxedString* attr);
 
     friend class HiddenClass;
+    friend class HiddenClassSingletonOrNormal;
 };
 
 class HiddenClassSingleton final : public HiddenClassSingletonOrNormal {
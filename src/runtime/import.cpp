@@ -92,7 +92,7 @@ extern "C" PyObject* load_source_module(char* name, char* pathname, FILE* fp) no
         AST_Module* ast;
         std::tie(ast, ast_allocator) = caching_parse_file(pathname, /* future_flags = */ 0);
         assert(ast);
-        compileAndRunModule(ast, module);
+        compileAndRunModule(ast, std::move(ast_allocator), module);
         Box* r = getSysModulesDict()->getOrNull(name_boxed);
         if (!r) {
             PyErr_Format(ImportError, "Loaded module %.200s not found in sys.modules", name);
@@ -124,7 +124,7 @@ extern "C" PyObject* PyImport_ExecCodeModuleEx(const char* name, PyObject* co, c
         AST_Module* ast;
         std::unique_ptr<ASTAllocator> ast_allocator;
         std::tie(ast, ast_allocator) = parse_string(code->data(), /* future_flags = */ 0);
-        compileAndRunModule(ast, module);
+        compileAndRunModule(ast, std::move(ast_allocator), module);
         return incref(module);
     } catch (ExcInfo e) {
         removeModule(s);
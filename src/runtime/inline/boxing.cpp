@@ -30,6 +30,12 @@ extern "C" Box* createList() {
     return new BoxedList();
 }
 
+// Lives here rather than in tuple.cpp so that the JIT can inline the free list fast path of
+// BoxedTuple::operator new into the code that builds tuples.
+extern "C" Box* createTuple(int64_t nelts, Box** elts) {
+    return BoxedTuple::create(nelts, elts);
+}
+
 BoxedString* boxStringTwine(const llvm::Twine& t) {
     llvm::SmallString<256> Vec;
     return boxString(t.toStringRef(Vec));
@@ -19,7 +19,8 @@
 
 namespace pyston {
 
-BoxedDictIterator::BoxedDictIterator(BoxedDict* d) : d(d), it(d->d.begin()), itEnd(d->d.end()) {
+BoxedDictIterator::BoxedDictIterator(BoxedDict* d)
+    : d(d), it(d->d.begin()), itEnd(d->d.end()), result(NULL) {
     Py_INCREF(d);
 }
 
@@ -66,16 +67,34 @@ Box* dictiter_next(Box* s) noexcept {
         return NULL;
 
     Box* rtn = nullptr;
+    // References to drop once we are done with the iterator, since that can run arbitrary code:
+    Box* to_decref[2] = { NULL, NULL };
     if (self->cls == &PyDictIterKey_Type) {
         rtn = incref(self->it->first.value);
     } else if (self->cls == &PyDictIterValue_Type) {
         rtn = incref(self->it->second);
     } else if (self->cls == &PyDictIterItem_Type) {
-        rtn = BoxedTuple::create({ self->it->first.value, self->it->second });
+        BoxedTuple* result = self->result;
+        if (result && result->ob_refcnt == 1) {
+            to_decref[0] = result->elts[0];
+            to_decref[1] = result->elts[1];
+            result->elts[0] = incref(self->it->first.value);
+            result->elts[1] = incref(self->it->second);
+            // The tuple may have been untracked while it only held atomic objects:
+            if (!_PyObject_GC_IS_TRACKED(result))
+                _PyObject_GC_TRACK(result);
+            rtn = incref(result);
+        } else {
+            rtn = BoxedTuple::create2(self->it->first.value, self->it->second);
+            self->result = static_cast<BoxedTuple*>(incref(rtn));
+            to_decref[0] = result;
+        }
     } else {
         RELEASE_ASSERT(0, "");
     }
     ++self->it;
+    Py_XDECREF(to_decref[0]);
+    Py_XDECREF(to_decref[1]);
     return rtn;
 }
 
@@ -154,6 +154,7 @@ void force() {
     FORCE(exec);
 
     FORCE(dump);
+    FORCE(_Py_DeallocFunc);
 
     FORCE(boxFloat);
 
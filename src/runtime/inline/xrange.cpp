@@ -87,7 +87,7 @@ public:
         cur = start;
     }
 
-    DEFAULT_CLASS_SIMPLE(xrange_iterator_cls, true);
+    DEFAULT_CLASS_SIMPLE_SLAB(xrange_iterator_cls, true);
 
     static llvm_compat_bool xrangeIteratorHasnextUnboxed(Box* s) __attribute__((visibility("default"))) {
         assert(s->cls == xrange_iterator_cls);
@@ -1554,6 +1554,7 @@ void setupInt() {
 
     for (int i = MIN_INTERNED_INT; i <= MAX_INTERNED_INT; i++) {
         interned_ints[-MIN_INTERNED_INT + i] = new BoxedInt(i);
+        makeImmortal(interned_ints[-MIN_INTERNED_INT + i]);
     }
 
     int_cls->giveAttr("__getnewargs__",
@@ -1005,22 +1005,32 @@ extern "C" Box* PyList_GetSlice(PyObject* a, Py_ssize_t ilow, Py_ssize_t ihigh)
         self, autoDecref(new BoxedSlice(autoDecref(boxInt(ilow)), autoDecref(boxInt(ihigh)), autoDecref(boxInt(1)))));
 }
 
+// Equality test used when searching a list.  Lists have to keep their elements boxed, since C code
+// reads ob_item directly, but for lists of numbers most of the search time goes into the generic
+// rich comparison; exact ints and floats get compared by value here instead.
+// 'ELT_FIRST' picks the argument order of the generic comparison, which is visible to __eq__.
+template <bool ELT_FIRST> static inline bool listItemEquals(Box* item, Box* elt) {
+    if (item == elt)
+        return true;
+
+    if (item->cls == elt->cls) {
+        if (item->cls == int_cls)
+            return static_cast<BoxedInt*>(item)->n == static_cast<BoxedInt*>(elt)->n;
+        if (item->cls == float_cls)
+            return static_cast<BoxedFloat*>(item)->d == static_cast<BoxedFloat*>(elt)->d;
+    }
+
+    int r = ELT_FIRST ? PyObject_RichCompareBool(elt, item, Py_EQ) : PyObject_RichCompareBool(item, elt, Py_EQ);
+    if (r == -1)
+        throwCAPIException();
+    return r;
+}
+
 static inline int listContainsShared(BoxedList* self, Box* elt) {
     assert(PyList_Check(self));
 
-    int size = self->size;
-    for (int i = 0; i < size; i++) {
-        Box* e = self->elts->elts[i];
-
-        bool identity_eq = e == elt;
-        if (identity_eq)
-            return true;
-
-        int r = PyObject_RichCompareBool(elt, e, Py_EQ);
-        if (r == -1)
-            throwCAPIException();
-
-        if (r)
+    for (int i = 0; i < self->size; i++) {
+        if (listItemEquals<true>(self->elts->elts[i], elt))
             return true;
     }
     return false;
@@ -1078,17 +1088,10 @@ Box* listContains(BoxedList* self, Box* elt) {
 }
 
 Box* listCount(BoxedList* self, Box* elt) {
-    int size = self->size;
     int count = 0;
 
-    for (int i = 0; i < size; i++) {
-        Box* e = self->elts->elts[i];
-
-        int r = PyObject_RichCompareBool(e, elt, Py_EQ);
-        if (r == -1)
-            throwCAPIException();
-
-        if (r)
+    for (int i = 0; i < self->size; i++) {
+        if (listItemEquals<false>(self->elts->elts[i], elt))
             count++;
     }
     return boxInt(count);
@@ -1119,13 +1122,7 @@ Box* listIndex(BoxedList* self, Box* elt, Box* _start, Box** args) {
     stop = std::min(stop, self->size);
 
     for (int64_t i = start; i < stop && i < self->size; i++) {
-        Box* e = self->elts->elts[i];
-
-        int r = PyObject_RichCompareBool(e, elt, Py_EQ);
-        if (r == -1)
-            throwCAPIException();
-
-        if (r)
+        if (listItemEquals<false>(self->elts->elts[i], elt))
             return boxInt(i);
     }
 
@@ -1139,11 +1136,7 @@ Box* listRemove(BoxedList* self, Box* elt) {
     for (int i = 0; i < self->size; i++) {
         Box* e = self->elts->elts[i];
 
-        int r = PyObject_RichCompareBool(e, elt, Py_EQ);
-        if (r == -1)
-            throwCAPIException();
-
-        if (r) {
+        if (listItemEquals<false>(e, elt)) {
             memmove(self->elts->elts + i, self->elts->elts + i + 1, (self->size - i - 1) * sizeof(Box*));
             self->size--;
             Py_DECREF(e);
@@ -1194,12 +1187,14 @@ static PyObject* list_richcompare(PyObject* v, PyObject* w, int op) noexcept {
     }
 
     /* Search for the first index where items are different */
-    for (i = 0; i < Py_SIZE(vl) && i < Py_SIZE(wl); i++) {
-        int k = PyObject_RichCompareBool(vl->ob_item[i], wl->ob_item[i], Py_EQ);
-        if (k < 0)
-            return NULL;
-        if (!k)
-            break;
+    try {
+        for (i = 0; i < Py_SIZE(vl) && i < Py_SIZE(wl); i++) {
+            if (!listItemEquals<false>(vl->ob_item[i], wl->ob_item[i]))
+                break;
+        }
+    } catch (ExcInfo e) {
+        setCAPIException(e);
+        return NULL;
     }
 
     if (i >= Py_SIZE(vl) || i >= Py_SIZE(wl)) {
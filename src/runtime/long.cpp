@@ -63,6 +63,156 @@ int _PyLong_DigitValue[256] = {
 #define IS_LITTLE_ENDIAN (int)*(unsigned char*)&one
 #define PY_ABS_LLONG_MIN (0 - (unsigned PY_LONG_LONG)PY_LLONG_MIN)
 
+static_assert(GMP_LIMB_BITS == 64 && GMP_NAIL_BITS == 0, "the small-long fast paths assume 64-bit limbs");
+
+// GMP memory functions.  BoxedLongs start out with n pointing at their inline limbs, which GMP doesn't know
+// about: when such a value outgrows them, GMP will "realloc" and eventually "free" that pointer.  To tell the two
+// apart, every buffer we hand out to GMP is preceded by a header word of 0, while the inline limbs are preceded by
+// BoxedLong::inline_tag.
+//
+// Buffers come from the runtime's allocator (pymalloc), with a free list in front of it for each limb count up to
+// GMP_POOL_MAX_LIMBS: bignum code tends to churn through temporaries of the same few sizes.  Like the rest of
+// pymalloc, the pools are protected by the GIL, which is held for all of the runtime's GMP calls.
+//
+// Both of these can be overridden at build time, eg -DGMP_POOL_MAXFREELIST=0 to disable the pools.
+#ifndef GMP_POOL_MAX_LIMBS
+#define GMP_POOL_MAX_LIMBS 64
+#endif
+#ifndef GMP_POOL_MAXFREELIST
+#define GMP_POOL_MAXFREELIST 64 /* Maximum number of buffers of each size to save */
+#endif
+
+namespace {
+struct GMPBufferHeader {
+    uint64_t tag; // always 0; see LONG_INLINE_LIMBS_TAG
+};
+
+// Free buffers are chained through their first word.
+struct GMPFreeBuffer {
+    GMPFreeBuffer* next;
+};
+
+GMPFreeBuffer* gmp_free_list[GMP_POOL_MAX_LIMBS + 1];
+int gmp_numfree[GMP_POOL_MAX_LIMBS + 1];
+
+StatCounter gmp_pool_hits("gmp_pool_hits");
+StatCounter gmp_pool_misses("gmp_pool_misses");
+StatCounter gmp_pool_large("gmp_pool_large");
+StatCounter gmp_pool_full("gmp_pool_full");
+
+// Requests are rounded up to whole limbs; returns 0 for sizes that are too big for the pools.
+inline size_t gmpPoolClass(size_t size) {
+    size_t nlimbs = (size + sizeof(mp_limb_t) - 1) / sizeof(mp_limb_t);
+    return nlimbs <= GMP_POOL_MAX_LIMBS ? nlimbs : 0;
+}
+
+void* gmpAllocate(size_t size) {
+    size_t cls = gmpPoolClass(size);
+    if (cls && gmp_numfree[cls]) {
+        gmp_pool_hits.log();
+        GMPFreeBuffer* buf = gmp_free_list[cls];
+        gmp_free_list[cls] = buf->next;
+        gmp_numfree[cls]--;
+        return buf;
+    }
+
+    if (cls) {
+        gmp_pool_misses.log();
+        size = cls * sizeof(mp_limb_t);
+    } else {
+        gmp_pool_large.log();
+    }
+
+    GMPBufferHeader* header = (GMPBufferHeader*)PyObject_Malloc(sizeof(GMPBufferHeader) + size);
+    RELEASE_ASSERT(header, "GMP: out of memory allocating %ld bytes", size);
+    header->tag = 0;
+    return header + 1;
+}
+
+void gmpFree(void* ptr, size_t size) {
+    GMPBufferHeader* header = (GMPBufferHeader*)ptr - 1;
+    if (header->tag == LONG_INLINE_LIMBS_TAG)
+        return;
+
+    size_t cls = gmpPoolClass(size);
+    if (cls) {
+        if (gmp_numfree[cls] < GMP_POOL_MAXFREELIST) {
+            GMPFreeBuffer* buf = (GMPFreeBuffer*)ptr;
+            buf->next = gmp_free_list[cls];
+            gmp_free_list[cls] = buf;
+            gmp_numfree[cls]++;
+            return;
+        }
+        gmp_pool_full.log();
+    }
+    PyObject_Free(header);
+}
+
+void* gmpReallocate(void* ptr, size_t old_size, size_t new_size) {
+    GMPBufferHeader* header = (GMPBufferHeader*)ptr - 1;
+    size_t old_cls = header->tag == LONG_INLINE_LIMBS_TAG ? 0 : gmpPoolClass(old_size);
+    size_t new_cls = gmpPoolClass(new_size);
+
+    // Pooled buffers are sized to their class, so this might fit already.
+    if (old_cls && old_cls == new_cls)
+        return ptr;
+
+    if (header->tag == LONG_INLINE_LIMBS_TAG || old_cls || new_cls) {
+        void* rtn = gmpAllocate(new_size);
+        memcpy(rtn, ptr, std::min(old_size, new_size));
+        gmpFree(ptr, old_size);
+        return rtn;
+    }
+
+    gmp_pool_large.log();
+    header = (GMPBufferHeader*)PyObject_Realloc(header, sizeof(GMPBufferHeader) + new_size);
+    RELEASE_ASSERT(header, "GMP: out of memory allocating %ld bytes", new_size);
+    return header + 1;
+}
+}
+
+void setupGMP() {
+    mp_set_memory_functions(gmpAllocate, gmpReallocate, gmpFree);
+}
+
+// Fast paths for small values, which skip GMP entirely: if the operands fit in a single limb, the result of
+// add/sub/mul/divmod fits in 128 bits, which we compute directly and store in the result's inline limbs.
+static inline bool longAsSmall(mpz_srcptr n, int64_t* v) {
+    int size = n->_mp_size;
+    if (size == 0) {
+        *v = 0;
+        return true;
+    }
+    if ((size != 1 && size != -1) || n->_mp_d[0] > (mp_limb_t)INT64_MAX)
+        return false;
+    *v = size > 0 ? (int64_t)n->_mp_d[0] : -(int64_t)n->_mp_d[0];
+    return true;
+}
+
+static BoxedLong* boxLongFrom128(__int128 v) {
+    static_assert(LONG_INLINE_LIMBS >= 2, "");
+    BoxedLong* rtn = new BoxedLong();
+    unsigned __int128 mag = v < 0 ? -(unsigned __int128)v : (unsigned __int128)v;
+    rtn->inline_limbs[0] = (mp_limb_t)mag;
+    rtn->inline_limbs[1] = (mp_limb_t)(mag >> 64);
+    int size = rtn->inline_limbs[1] ? 2 : (rtn->inline_limbs[0] ? 1 : 0);
+    rtn->n->_mp_size = v < 0 ? -size : size;
+    return rtn;
+}
+
+// Python semantics: the remainder has the sign of the divisor.
+static inline void floorDivmodSmall(int64_t a, int64_t b, __int128* q, __int128* r) {
+    assert(b != 0);
+    __int128 quot = (__int128)a / b;
+    __int128 rem = (__int128)a % b;
+    if (rem != 0 && ((rem < 0) != (b < 0))) {
+        quot -= 1;
+        rem += b;
+    }
+    *q = quot;
+    *r = rem;
+}
+
 void BoxedLong::tp_dealloc(Box* b) noexcept {
     mpz_clear(static_cast<BoxedLong*>(b)->n);
     b->cls->tp_free(b);
@@ -74,7 +224,7 @@ extern "C" int _PyLong_Sign(PyObject* l) noexcept {
 
 extern "C" PyObject* _PyLong_Copy(PyLongObject* src) noexcept {
     BoxedLong* rtn = new BoxedLong();
-    mpz_init_set(rtn->n, ((BoxedLong*)src)->n);
+    mpz_set(rtn->n, ((BoxedLong*)src)->n);
     return rtn;
 }
 
@@ -220,9 +370,9 @@ extern "C" PyObject* PyLong_FromString(const char* str, char** pend, int base) n
     BoxedLong* rtn = new BoxedLong();
     int r = 0;
     if (str_ref_trimmed != str_ref)
-        r = mpz_init_set_str(rtn->n, str_ref_trimmed.str().c_str(), base);
+        r = mpz_set_str(rtn->n, str_ref_trimmed.str().c_str(), base);
     else
-        r = mpz_init_set_str(rtn->n, str, base);
+        r = mpz_set_str(rtn->n, str, base);
 
     if (pend) {
         *pend = const_cast<char*>(str) + str_ref.size();
@@ -423,13 +573,13 @@ extern "C" PyObject* PyLong_FromDouble(double v) noexcept {
     }
 
     BoxedLong* rtn = new BoxedLong();
-    mpz_init_set_d(rtn->n, v);
+    mpz_set_d(rtn->n, v);
     return rtn;
 }
 
 extern "C" PyObject* PyLong_FromLong(long ival) noexcept {
     BoxedLong* rtn = new BoxedLong();
-    mpz_init_set_si(rtn->n, ival);
+    mpz_set_si(rtn->n, ival);
     return rtn;
 }
 
@@ -453,7 +603,7 @@ extern "C" PyObject* PyLong_FromUnicode(Py_UNICODE* u, Py_ssize_t length, int ba
 
 extern "C" PyObject* PyLong_FromUnsignedLong(unsigned long ival) noexcept {
     BoxedLong* rtn = new BoxedLong();
-    mpz_init_set_ui(rtn->n, ival);
+    mpz_set_ui(rtn->n, ival);
     return rtn;
 }
 
@@ -614,7 +764,6 @@ extern "C" PyObject* _PyLong_FromByteArray(const unsigned char* bytes, size_t n,
     }
 
     BoxedLong* rtn = new BoxedLong();
-    mpz_init(rtn->n);
     mpz_import(rtn->n, 1, 1, n, little_endian ? -1 : 1, 0, &bytes[0]);
 
 
@@ -637,33 +786,33 @@ extern "C" void _PyLong_AsMPZ(PyObject* obj, _PyLongMPZ num) noexcept {
 
 extern "C" PyObject* _PyLong_FromMPZ(const _PyLongMPZ num) noexcept {
     BoxedLong* r = new BoxedLong();
-    mpz_init_set(r->n, (mpz_srcptr)num);
+    mpz_set(r->n, (mpz_srcptr)num);
     return r;
 }
 
 extern "C" Box* createLong(llvm::StringRef s) {
     BoxedLong* rtn = new BoxedLong();
     assert(s.data()[s.size()] == '\0');
-    int r = mpz_init_set_str(rtn->n, s.data(), 10);
+    int r = mpz_set_str(rtn->n, s.data(), 10);
     RELEASE_ASSERT(r == 0, "%d: '%s'", r, s.data());
     return rtn;
 }
 
 extern "C" BoxedLong* boxLong(int64_t n) {
     BoxedLong* rtn = new BoxedLong();
-    mpz_init_set_si(rtn->n, n);
+    mpz_set_si(rtn->n, n);
     return rtn;
 }
 
 extern "C" PyObject* PyLong_FromLongLong(long long ival) noexcept {
     BoxedLong* rtn = new BoxedLong();
-    mpz_init_set_si(rtn->n, ival);
+    mpz_set_si(rtn->n, ival);
     return rtn;
 }
 
 extern "C" PyObject* PyLong_FromUnsignedLongLong(unsigned long long ival) noexcept {
     BoxedLong* rtn = new BoxedLong();
-    mpz_init_set_ui(rtn->n, ival);
+    mpz_set_ui(rtn->n, ival);
     return rtn;
 }
 
@@ -773,7 +922,7 @@ template <ExceptionStyle S> Box* longNew(Box* _cls, Box* val, Box* base) noexcep
 
     BoxedLong* rtn = new (cls) BoxedLong();
 
-    mpz_init_set(rtn->n, l->n);
+    mpz_set(rtn->n, l->n);
     return rtn;
 }
 
@@ -786,7 +935,7 @@ Box* longInt(Box* v) {
     static_assert(sizeof(BoxedInt::n) == sizeof(long), "");
     if (overflow) {
         BoxedLong* rtn = new BoxedLong();
-        mpz_init_set(rtn->n, ((BoxedLong*)v)->n);
+        mpz_set(rtn->n, ((BoxedLong*)v)->n);
         return rtn;
     } else
         return boxInt(n);
@@ -798,7 +947,7 @@ Box* longToLong(Box* self) noexcept {
     } else {
         assert(PyLong_Check(self));
         BoxedLong* l = new BoxedLong();
-        mpz_init_set(l->n, static_cast<BoxedLong*>(self)->n);
+        mpz_set(l->n, static_cast<BoxedLong*>(self)->n);
         return l;
     }
 }
@@ -896,7 +1045,6 @@ Box* longNeg(BoxedLong* v1) {
         raiseExcHelper(TypeError, "descriptor '__neg__' requires a 'long' object but received a '%s'", getTypeName(v1));
 
     BoxedLong* r = new BoxedLong();
-    mpz_init(r->n);
     mpz_neg(r->n, v1->n);
     return r;
 }
@@ -909,7 +1057,7 @@ Box* longPos(BoxedLong* v) {
         return incref(v);
     } else {
         BoxedLong* r = new BoxedLong();
-        mpz_init_set(r->n, v->n);
+        mpz_set(r->n, v->n);
         return r;
     }
 }
@@ -917,7 +1065,6 @@ Box* longPos(BoxedLong* v) {
 Box* longAbs(BoxedLong* v1) {
     assert(PyLong_Check(v1));
     BoxedLong* r = new BoxedLong();
-    mpz_init(r->n);
     mpz_abs(r->n, v1->n);
     return r;
 }
@@ -926,18 +1073,23 @@ Box* longAdd(BoxedLong* v1, Box* _v2) {
     if (!PyLong_Check(v1))
         raiseExcHelper(TypeError, "descriptor '__add__' requires a 'long' object but received a '%s'", getTypeName(v1));
 
+    int64_t small1, small2;
     if (PyLong_Check(_v2)) {
         BoxedLong* v2 = static_cast<BoxedLong*>(_v2);
 
+        if (longAsSmall(v1->n, &small1) && longAsSmall(v2->n, &small2))
+            return boxLongFrom128((__int128)small1 + small2);
+
         BoxedLong* r = new BoxedLong();
-        mpz_init(r->n);
         mpz_add(r->n, v1->n, v2->n);
         return r;
     } else if (PyInt_Check(_v2)) {
         BoxedInt* v2 = static_cast<BoxedInt*>(_v2);
 
+        if (longAsSmall(v1->n, &small1))
+            return boxLongFrom128((__int128)small1 + v2->n);
+
         BoxedLong* r = new BoxedLong();
-        mpz_init(r->n);
         if (v2->n >= 0)
             mpz_add_ui(r->n, v1->n, v2->n);
         else
@@ -955,13 +1107,11 @@ extern "C" Box* longAnd(BoxedLong* v1, Box* _v2) {
     if (PyLong_Check(_v2)) {
         BoxedLong* v2 = static_cast<BoxedLong*>(_v2);
         BoxedLong* r = new BoxedLong();
-        mpz_init(r->n);
         mpz_and(r->n, v1->n, v2->n);
         return r;
     } else if (PyInt_Check(_v2)) {
         BoxedInt* v2_int = static_cast<BoxedInt*>(_v2);
         BoxedLong* r = new BoxedLong();
-        mpz_init(r->n);
         mpz_t v2_long;
         mpz_init(v2_long);
         if (v2_int->n >= 0)
@@ -981,13 +1131,11 @@ extern "C" Box* longOr(BoxedLong* v1, Box* _v2) {
     if (PyLong_Check(_v2)) {
         BoxedLong* v2 = static_cast<BoxedLong*>(_v2);
         BoxedLong* r = new BoxedLong();
-        mpz_init(r->n);
         mpz_ior(r->n, v1->n, v2->n);
         return r;
     } else if (PyInt_Check(_v2)) {
         BoxedInt* v2_int = static_cast<BoxedInt*>(_v2);
         BoxedLong* r = new BoxedLong();
-        mpz_init(r->n);
         mpz_t v2_long;
         mpz_init(v2_long);
         if (v2_int->n >= 0)
@@ -1007,13 +1155,11 @@ extern "C" Box* longXor(BoxedLong* v1, Box* _v2) {
     if (PyLong_Check(_v2)) {
         BoxedLong* v2 = static_cast<BoxedLong*>(_v2);
         BoxedLong* r = new BoxedLong();
-        mpz_init(r->n);
         mpz_xor(r->n, v1->n, v2->n);
         return r;
     } else if (PyInt_Check(_v2)) {
         BoxedInt* v2_int = static_cast<BoxedInt*>(_v2);
         BoxedLong* r = new BoxedLong();
-        mpz_init(r->n);
         mpz_t v2_long;
         mpz_init(v2_long);
         if (v2_int->n >= 0)
@@ -1031,13 +1177,20 @@ static PyObject* long_richcompare(Box* _v1, Box* _v2, int op) noexcept {
     RELEASE_ASSERT(PyLong_Check(_v1), "");
     BoxedLong* v1 = static_cast<BoxedLong*>(_v1);
 
+    int64_t small1, small2;
     if (PyLong_Check(_v2)) {
         BoxedLong* v2 = static_cast<BoxedLong*>(_v2);
 
+        if (longAsSmall(v1->n, &small1) && longAsSmall(v2->n, &small2))
+            return convert_3way_to_object(op, (small1 > small2) - (small1 < small2));
+
         return convert_3way_to_object(op, mpz_cmp(v1->n, v2->n));
     } else if (PyInt_Check(_v2)) {
         BoxedInt* v2 = static_cast<BoxedInt*>(_v2);
 
+        if (longAsSmall(v1->n, &small1))
+            return convert_3way_to_object(op, (small1 > v2->n) - (small1 < v2->n));
+
         return convert_3way_to_object(op, mpz_cmp_si(v1->n, v2->n));
     } else {
         return incref(NotImplemented);
@@ -1050,7 +1203,7 @@ Box* convertToLong(Box* val) {
     } else if (PyInt_Check(val)) {
         BoxedInt* val_int = static_cast<BoxedInt*>(val);
         BoxedLong* r = new BoxedLong();
-        mpz_init_set_si(r->n, val_int->n);
+        mpz_set_si(r->n, val_int->n);
         return r;
     } else {
         return incref(NotImplemented);
@@ -1074,7 +1227,6 @@ Box* longLShiftLong(BoxedLong* lhs, Box* _rhs) {
 
     uint64_t n = asUnsignedLong(rhs_long);
     BoxedLong* r = new BoxedLong();
-    mpz_init(r->n);
     mpz_mul_2exp(r->n, lhs->n, n);
     return r;
 }
@@ -1117,7 +1269,6 @@ Box* longRShiftLong(BoxedLong* lhs, Box* _rhs) {
 
     uint64_t n = asUnsignedLong(rhs_long);
     BoxedLong* r = new BoxedLong();
-    mpz_init(r->n);
     mpz_div_2exp(r->n, lhs->n, n);
     return r;
 }
@@ -1165,18 +1316,23 @@ Box* longSub(BoxedLong* v1, Box* _v2) {
     if (!PyLong_Check(v1))
         raiseExcHelper(TypeError, "descriptor '__sub__' requires a 'long' object but received a '%s'", getTypeName(v1));
 
+    int64_t small1, small2;
     if (PyLong_Check(_v2)) {
         BoxedLong* v2 = static_cast<BoxedLong*>(_v2);
 
+        if (longAsSmall(v1->n, &small1) && longAsSmall(v2->n, &small2))
+            return boxLongFrom128((__int128)small1 - small2);
+
         BoxedLong* r = new BoxedLong();
-        mpz_init(r->n);
         mpz_sub(r->n, v1->n, v2->n);
         return r;
     } else if (PyInt_Check(_v2)) {
         BoxedInt* v2 = static_cast<BoxedInt*>(_v2);
 
+        if (longAsSmall(v1->n, &small1))
+            return boxLongFrom128((__int128)small1 - v2->n);
+
         BoxedLong* r = new BoxedLong();
-        mpz_init(r->n);
         if (v2->n >= 0)
             mpz_sub_ui(r->n, v1->n, v2->n);
         else
@@ -1199,18 +1355,23 @@ Box* longMul(BoxedLong* v1, Box* _v2) {
     if (!PyLong_Check(v1))
         raiseExcHelper(TypeError, "descriptor '__mul__' requires a 'long' object but received a '%s'", getTypeName(v1));
 
+    int64_t small1, small2;
     if (PyLong_Check(_v2)) {
         BoxedLong* v2 = static_cast<BoxedLong*>(_v2);
 
+        if (longAsSmall(v1->n, &small1) && longAsSmall(v2->n, &small2))
+            return boxLongFrom128((__int128)small1 * small2);
+
         BoxedLong* r = new BoxedLong();
-        mpz_init(r->n);
         mpz_mul(r->n, v1->n, v2->n);
         return r;
     } else if (PyInt_Check(_v2)) {
         BoxedInt* v2 = static_cast<BoxedInt*>(_v2);
 
+        if (longAsSmall(v1->n, &small1))
+            return boxLongFrom128((__int128)small1 * v2->n);
+
         BoxedLong* r = new BoxedLong();
-        mpz_init(r->n);
         mpz_mul_si(r->n, v1->n, v2->n);
         return r;
     } else {
@@ -1222,14 +1383,20 @@ Box* longDiv(BoxedLong* v1, Box* _v2) {
     if (!PyLong_Check(v1))
         raiseExcHelper(TypeError, "descriptor '__div__' requires a 'long' object but received a '%s'", getTypeName(v1));
 
+    int64_t small1, small2;
+    __int128 small_q, small_r;
     if (PyLong_Check(_v2)) {
         BoxedLong* v2 = static_cast<BoxedLong*>(_v2);
 
         if (mpz_sgn(v2->n) == 0)
             raiseExcHelper(ZeroDivisionError, "long division or modulo by zero");
 
+        if (longAsSmall(v1->n, &small1) && longAsSmall(v2->n, &small2)) {
+            floorDivmodSmall(small1, small2, &small_q, &small_r);
+            return boxLongFrom128(small_q);
+        }
+
         BoxedLong* r = new BoxedLong();
-        mpz_init(r->n);
         mpz_fdiv_q(r->n, v1->n, v2->n);
         return r;
     } else if (PyInt_Check(_v2)) {
@@ -1238,8 +1405,13 @@ Box* longDiv(BoxedLong* v1, Box* _v2) {
         if (v2->n == 0)
             raiseExcHelper(ZeroDivisionError, "long division or modulo by zero");
 
+        if (longAsSmall(v1->n, &small1)) {
+            floorDivmodSmall(small1, v2->n, &small_q, &small_r);
+            return boxLongFrom128(small_q);
+        }
+
         BoxedLong* r = new BoxedLong();
-        mpz_init_set_si(r->n, v2->n);
+        mpz_set_si(r->n, v2->n);
         mpz_fdiv_q(r->n, v1->n, r->n);
         return r;
     } else {
@@ -1258,14 +1430,20 @@ Box* longMod(BoxedLong* v1, Box* _v2) {
     if (!PyLong_Check(v1))
         raiseExcHelper(TypeError, "descriptor '__mod__' requires a 'long' object but received a '%s'", getTypeName(v1));
 
+    int64_t small1, small2;
+    __int128 small_q, small_r;
     if (PyLong_Check(_v2)) {
         BoxedLong* v2 = static_cast<BoxedLong*>(_v2);
 
         if (mpz_sgn(v2->n) == 0)
             raiseExcHelper(ZeroDivisionError, "long division or modulo by zero");
 
+        if (longAsSmall(v1->n, &small1) && longAsSmall(v2->n, &small2)) {
+            floorDivmodSmall(small1, small2, &small_q, &small_r);
+            return boxLongFrom128(small_r);
+        }
+
         BoxedLong* r = new BoxedLong();
-        mpz_init(r->n);
         mpz_mmod(r->n, v1->n, v2->n);
         return r;
     } else if (PyInt_Check(_v2)) {
@@ -1274,8 +1452,13 @@ Box* longMod(BoxedLong* v1, Box* _v2) {
         if (v2->n == 0)
             raiseExcHelper(ZeroDivisionError, "long division or modulo by zero");
 
+        if (longAsSmall(v1->n, &small1)) {
+            floorDivmodSmall(small1, v2->n, &small_q, &small_r);
+            return boxLongFrom128(small_r);
+        }
+
         BoxedLong* r = new BoxedLong();
-        mpz_init_set_si(r->n, v2->n);
+        mpz_set_si(r->n, v2->n);
         mpz_mmod(r->n, v1->n, r->n);
         return r;
     } else {
@@ -1315,12 +1498,21 @@ Box* longDivmodLong(BoxedLong* lhs, Box* _rhs) {
     if (mpz_sgn(rhs_long->n) == 0)
         raiseExcHelper(ZeroDivisionError, "long division or modulo by zero");
 
+    int64_t small_lhs, small_rhs;
+    if (longAsSmall(lhs->n, &small_lhs) && longAsSmall(rhs_long->n, &small_rhs)) {
+        __int128 small_q, small_r;
+        floorDivmodSmall(small_lhs, small_rhs, &small_q, &small_r);
+        BoxedLong* q = boxLongFrom128(small_q);
+        BoxedLong* r = boxLongFrom128(small_r);
+        AUTO_DECREF(q);
+        AUTO_DECREF(r);
+        return BoxedTuple::create({ q, r });
+    }
+
     BoxedLong* q = new BoxedLong();
     BoxedLong* r = new BoxedLong();
     AUTO_DECREF(q);
     AUTO_DECREF(r);
-    mpz_init(q->n);
-    mpz_init(r->n);
     mpz_fdiv_qr(q->n, r->n, lhs->n, rhs_long->n);
     return BoxedTuple::create({ q, r });
 }
@@ -1361,14 +1553,13 @@ Box* longRdiv(BoxedLong* v1, Box* _v2) {
         BoxedLong* v2 = static_cast<BoxedLong*>(_v2);
 
         BoxedLong* r = new BoxedLong();
-        mpz_init(r->n);
         mpz_fdiv_q(r->n, v2->n, v1->n);
         return r;
     } else if (PyInt_Check(_v2)) {
         BoxedInt* v2 = static_cast<BoxedInt*>(_v2);
 
         BoxedLong* r = new BoxedLong();
-        mpz_init_set_si(r->n, v2->n);
+        mpz_set_si(r->n, v2->n);
         mpz_fdiv_q(r->n, r->n, v1->n);
         return r;
     } else {
@@ -1504,7 +1695,6 @@ Box* longPowLong(BoxedLong* lhs, Box* _rhs, Box* _mod) {
     }
 
     BoxedLong* r = new BoxedLong();
-    mpz_init(r->n);
 
     if (_mod != Py_None) {
         mpz_powm(r->n, lhs->n, rhs_long->n, mod_long->n);
@@ -1560,7 +1750,6 @@ extern "C" Box* longInvert(BoxedLong* v) {
                        getTypeName(v));
 
     BoxedLong* r = new BoxedLong();
-    mpz_init(r->n);
     mpz_com(r->n, v->n);
     return r;
 }
@@ -1585,6 +1774,25 @@ Box* longHash(BoxedLong* self) {
                        getTypeName(self));
 
     // If the long fits into an int we have to return the same hash in order that we can find the value in a dict.
+    int64_t small;
+    if (longAsSmall(self->n, &small))
+        return boxInt(small == -1 ? -2 : small);
+
+    int size = self->n->_mp_size;
+    if (size == 2 || size == -2) {
+        // Same as the general case below: |n| mod ULONG_MAX, except that multiples of ULONG_MAX hash as ULONG_MAX.
+        // Since 2**64 == 1 mod ULONG_MAX, that's the sum of the two limbs with the carry wrapped around.
+        unsigned long lo = self->n->_mp_d[0], hi = self->n->_mp_d[1];
+        unsigned long remainder = lo + hi;
+        if (remainder < lo)
+            remainder++;
+        if (size < 0)
+            remainder = -remainder;
+        if (remainder == -1)
+            remainder = -2;
+        return boxInt(remainder);
+    }
+
     if (mpz_fits_slong_p(self->n)) {
         auto v = mpz_get_si(self->n);
         if (v == -1)
@@ -1625,7 +1833,7 @@ extern "C" Box* longIndex(BoxedLong* v) noexcept {
     if (PyLong_CheckExact(v))
         return incref(v);
     BoxedLong* rtn = new BoxedLong();
-    mpz_init_set(rtn->n, v->n);
+    mpz_set(rtn->n, v->n);
     return rtn;
 }
 
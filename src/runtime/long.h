@@ -24,14 +24,32 @@
 namespace pyston {
 
 void setupLong();
+// Installs our GMP memory functions; this has to happen before anything allocates GMP memory.
+void setupGMP();
 
 extern BoxedClass* long_cls;
 
+// Limbs of storage that every long carries inline: values up to 128 bits never need a separate GMP allocation.
+#define LONG_INLINE_LIMBS 2
+// Marks the word before a BoxedLong's inline limbs, so that our GMP memory functions can tell them apart from
+// buffers they allocated themselves.
+#define LONG_INLINE_LIMBS_TAG 0x50794c6f6e67496eUL
+
 class BoxedLong : public Box {
 public:
     mpz_t n;
 
-    BoxedLong() __attribute__((visibility("default"))) {}
+    uint64_t inline_tag;
+    mp_limb_t inline_limbs[LONG_INLINE_LIMBS];
+
+    // n starts out initialized and pointing at the inline limbs, so callers should mpz_set() it rather than
+    // mpz_init() it.  GMP moves the value to a heap buffer if it outgrows them.
+    BoxedLong() __attribute__((visibility("default"))) {
+        inline_tag = LONG_INLINE_LIMBS_TAG;
+        n->_mp_alloc = LONG_INLINE_LIMBS;
+        n->_mp_size = 0;
+        n->_mp_d = inline_limbs;
+    }
 
     static void tp_dealloc(Box* b) noexcept;
 
@@ -389,6 +389,14 @@ static void clear_slots(PyTypeObject* type, PyObject* self) noexcept {
     }
 }
 
+// Returns cls as a BoxedHeapClass (which keeps the attribute presizing state) if it is one, NULL otherwise.  Checking
+// Py_TPFLAGS_HEAPTYPE alone isn't enough: C extensions can create types with that flag that aren't BoxedHeapClasses.
+static BoxedHeapClass* asBoxedHeapClass(BoxedClass* cls) {
+    if ((cls->tp_flags & Py_TPFLAGS_HEAPTYPE) && cls->is_pyston_class)
+        return static_cast<BoxedHeapClass*>(cls);
+    return NULL;
+}
+
 static void subtype_dealloc(Box* self) noexcept {
     PyTypeObject* type, *base;
     destructor basedealloc;
@@ -509,7 +517,11 @@ static void subtype_dealloc(Box* self) noexcept {
 
     // Pyston addition: same for hcattrs
     if (type->attrs_offset && !base->attrs_offset) {
-        self->getHCAttrsPtr()->clearForDealloc();
+        HCAttrs* attrs = self->getHCAttrsPtr();
+        BoxedHeapClass* heap_type = asBoxedHeapClass(type);
+        if (attrs->hcls && attrs->hcls->type != HiddenClass::DICT_BACKED && heap_type)
+            heap_type->noteFinalAttrCount(attrs->hcls->getAsSingletonOrNormal()->attributeArraySize());
+        attrs->clearForDealloc();
     }
 
     /* Extract the type again; tp_del may have changed it */
@@ -677,12 +689,14 @@ BoxedClass::BoxedClass(BoxedClass* base, int attrs_offset, int weaklist_offset,
                        traverseproc traverse, inquiry clear)
     : attrs(HiddenClass::makeSingleton()),
       attrs_offset(attrs_offset),
+      num_inline_attrs(0),
       is_constant(false),
       is_user_defined(is_user_defined),
       is_pyston_class(true),
       has___class__(false),
       has_instancecheck(false),
-      tpp_call(NULL, NULL) {
+      tpp_call(NULL, NULL),
+      slab_allocator(NULL) {
 
     bool ok_noclear = (clear == NOCLEAR);
     if (ok_noclear)
@@ -698,7 +712,7 @@ BoxedClass::BoxedClass(BoxedClass* base, int attrs_offset, int weaklist_offset,
     classes.push_back(this);
 
     // Zero out the CPython tp_* slots:
-    memset(&tp_name, 0, (char*)(&tp_version_tag + 1) - (char*)(&tp_name));
+    memset(&tp_name, 0, (char*)(&tp_live_bytes + 1) - (char*)(&tp_name));
     tp_basicsize = instance_size;
     tp_weaklistoffset = weaklist_offset;
     tp_name = name;
@@ -782,8 +796,10 @@ BoxedClass::BoxedClass(BoxedClass* base, int attrs_offset, int weaklist_offset,
         // Will have to add __base__ = None later
     } else {
         assert(object_cls);
-        if (base->attrs_offset)
+        if (base->attrs_offset) {
             RELEASE_ASSERT(attrs_offset == base->attrs_offset, "");
+            num_inline_attrs = base->num_inline_attrs;
+        }
         assert(tp_basicsize >= base->tp_basicsize);
     }
 
@@ -793,7 +809,7 @@ BoxedClass::BoxedClass(BoxedClass* base, int attrs_offset, int weaklist_offset,
     }
 
     if (attrs_offset) {
-        assert(tp_basicsize >= attrs_offset + sizeof(HCAttrs));
+        assert(tp_basicsize >= attrs_offset + sizeof(HCAttrs) + num_inline_attrs * sizeof(Box*));
         assert(attrs_offset % sizeof(void*) == 0); // Not critical I suppose, but probably signals a bug
     }
 }
@@ -922,7 +938,10 @@ BoxedHeapClass::BoxedHeapClass(BoxedClass* base, int attrs_offset, int weaklist_
     : BoxedClass(base, attrs_offset, weaklist_offset, instance_size, is_user_defined, name->data(), true,
                  subtype_dealloc, PyObject_GC_Del, true, subtype_traverse, subtype_clear),
       ht_name(incref(name)),
-      ht_slots(NULL) {
+      ht_slots(NULL),
+      attrs_presize(0),
+      attrs_presize_overshoots(0),
+      attrs_presize_window_max(0) {
     assert(is_user_defined);
 
     /* Always override allocation strategy to use regular heap */
@@ -1049,6 +1068,20 @@ BORROWED(BoxedDict*) Box::getDict() {
     return d;
 }
 
+// Whether the given hidden class implies that the object's attributes live in its inline slots,
+// in which case ICs can access them directly rather than going through attr_list.
+static bool hclsImpliesInlineAttrs(BoxedClass* cls, HiddenClass* hcls) {
+    return hcls->type == HiddenClass::NORMAL && cls->num_inline_attrs > 0
+           && hcls->getAsNormal()->attributeArraySize() <= cls->num_inline_attrs;
+}
+
+// The offset, relative to the start of the object, of an inline attribute slot.
+static int inlineAttrOffset(BoxedClass* cls, int idx) {
+    assert(cls->attrs_offset > 0);
+    assert(idx < cls->num_inline_attrs);
+    return cls->attrs_offset + sizeof(HCAttrs) + offsetof(HCAttrs::AttrList, attrs) + idx * sizeof(Box*);
+}
+
 static StatCounter box_getattr_slowpath("slowpath_box_getattr");
 
 template <Rewritable rewritable> BORROWED(Box*) Box::getattr(BoxedString* attr, GetattrRewriteArgs* rewrite_args) {
@@ -1143,6 +1176,10 @@ template <Rewritable rewritable> BORROWED(Box*) Box::getattr(BoxedString* attr,
             if (cls->attrs_offset < 0) {
                 REWRITE_ABORTED("");
                 rewrite_args = NULL;
+            } else if (hclsImpliesInlineAttrs(cls, hcls)) {
+                RewriterVar* r_rtn = rewrite_args->obj->getAttr(inlineAttrOffset(cls, offset), Location::any())
+                                         ->setType(RefType::BORROWED);
+                rewrite_args->setReturn(r_rtn, ReturnConvention::HAS_RETURN);
             } else {
                 RewriterVar* r_attrs
                     = rewrite_args->obj->getAttr(cls->attrs_offset + offsetof(HCAttrs, attr_list), Location::any());
@@ -1200,13 +1237,18 @@ static_assert(sizeof(freelist_index) / sizeof(freelist_index[0]) == MAX_FREELIST
 static bool isPowerOfTwo(int n) {
     return __builtin_popcountll(n) == 1;
 }
+// Whether an array holding n attributes might be full.  Arrays can be allocated with more room than this function
+// would suggest (see allocAttrsForInstance), so the actual capacity has to be checked at these sizes.
 static bool arrayIsAtCapacity(int n) {
     return n >= INITIAL_ARRAY_SIZE && isPowerOfTwo(n);
 }
 
-static int nextAttributeArraySize(int n) {
-    assert(arrayIsAtCapacity(n));
-    return n * 2;
+// The capacity of the array we allocate to hold n attributes.
+static int attrsCapacityFor(int n) {
+    int capacity = INITIAL_ARRAY_SIZE;
+    while (capacity < n)
+        capacity *= 2;
+    return capacity;
 }
 
 static int freelistIndex(int n) {
@@ -1214,23 +1256,36 @@ static int freelistIndex(int n) {
     return freelist_index[n];
 }
 
+// Out-of-line attribute arrays are prefixed with a word that records their capacity, since with presizing
+// the capacity is no longer determined by the number of attributes.
+static int64_t& attrsCapacity(HCAttrs::AttrList* attrs) {
+    return reinterpret_cast<int64_t*>(attrs)[-1];
+}
+
+static HCAttrs::AttrList* mallocAttrs(int nattrs) {
+    int64_t* header = (int64_t*)PyObject_MALLOC(sizeof(int64_t) + sizeof(HCAttrs::AttrList) + nattrs * sizeof(Box*));
+    HCAttrs::AttrList* rtn = reinterpret_cast<HCAttrs::AttrList*>(header + 1);
+    attrsCapacity(rtn) = nattrs;
+    return rtn;
+}
+
 static HCAttrs::AttrList* allocFromFreelist(int freelist_idx) {
     auto&& freelist = attrlist_freelist[freelist_idx];
     int size = freelist.size;
+    int nattrs = (1 << freelist_idx) * INITIAL_ARRAY_SIZE;
     if (size) {
         auto rtn = freelist.next_free;
         freelist.size = size - 1;
         freelist.next_free = *reinterpret_cast<HCAttrs::AttrList**>(rtn);
+        assert(attrsCapacity(rtn) == nattrs);
 
 #ifndef NDEBUG
-        int nattrs = (1 << freelist_idx) * INITIAL_ARRAY_SIZE;
         memset(rtn, 0xcb, sizeof(HCAttrs::AttrList) + nattrs * sizeof(Box*));
 #endif
         return rtn;
     }
 
-    int nattrs = (1 << freelist_idx) * INITIAL_ARRAY_SIZE;
-    return (HCAttrs::AttrList*)PyObject_MALLOC(sizeof(HCAttrs::AttrList) + nattrs * sizeof(Box*));
+    return mallocAttrs(nattrs);
 }
 
 static HCAttrs::AttrList* allocAttrs(int nattrs) {
@@ -1239,10 +1294,11 @@ static HCAttrs::AttrList* allocAttrs(int nattrs) {
     if (nattrs <= MAX_FREELIST_SIZE)
         return allocFromFreelist(freelistIndex(nattrs));
 
-    return (HCAttrs::AttrList*)PyObject_MALLOC(sizeof(HCAttrs::AttrList) + nattrs * sizeof(Box*));
+    return mallocAttrs(nattrs);
 }
 
-static void freeAttrs(HCAttrs::AttrList* attrs, int nattrs) {
+static void freeAttrs(HCAttrs::AttrList* attrs) {
+    int nattrs = attrsCapacity(attrs);
     if (nattrs <= MAX_FREELIST_SIZE) {
         int idx = freelistIndex(nattrs);
         auto&& freelist = attrlist_freelist[idx];
@@ -1250,7 +1306,7 @@ static void freeAttrs(HCAttrs::AttrList* attrs, int nattrs) {
 
         // TODO: should drop an old item from the freelist, not a new one
         if (size == ARRAYLIST_FREELIST_SIZE) {
-            PyObject_FREE(attrs);
+            PyObject_FREE(&attrsCapacity(attrs));
             return;
         } else {
 #ifndef NDEBUG
@@ -1263,23 +1319,87 @@ static void freeAttrs(HCAttrs::AttrList* attrs, int nattrs) {
         }
     }
 
-    PyObject_FREE(attrs);
+    PyObject_FREE(&attrsCapacity(attrs));
 }
 
-static HCAttrs::AttrList* reallocAttrs(HCAttrs::AttrList* attrs, int old_nattrs, int new_nattrs) {
-    assert(arrayIsAtCapacity(old_nattrs));
-    assert(new_nattrs > old_nattrs);
+// Allocates an out-of-line attributes array for an instance of cls which has nattrs attributes (copied over from
+// old_attrs) and is about to get another one.  Heap classes remember how many attributes their instances have
+// needed, so that we can allocate the final size up front instead of growing the array several times.
+static HCAttrs::AttrList* allocAttrsForInstance(BoxedClass* cls, HCAttrs::AttrList* old_attrs, int nattrs) {
+    static StatCounter num_presized("num_hcattrs_presized_arrays");
 
-    HCAttrs::AttrList* rtn = allocAttrs(new_nattrs);
-    memcpy(rtn, attrs, sizeof(HCAttrs::AttrList) + sizeof(Box*) * old_nattrs);
+    int capacity = attrsCapacityFor(nattrs + 1);
+    if (BoxedHeapClass* hcls = asBoxedHeapClass(cls)) {
+        int presize_capacity = attrsCapacityFor(hcls->attrs_presize);
+        if (presize_capacity > capacity) {
+            capacity = presize_capacity;
+            num_presized.log();
+        }
+    }
+
+    HCAttrs::AttrList* rtn = allocAttrs(capacity);
+    if (nattrs)
+        memcpy(rtn->attrs, old_attrs->attrs, sizeof(Box*) * nattrs);
 #ifndef NDEBUG
-    memset(&rtn->attrs[old_nattrs], 0xcb, sizeof(Box*) * (new_nattrs - old_nattrs));
+    memset(&rtn->attrs[nattrs], 0xcb, sizeof(Box*) * (capacity - nattrs));
 #endif
-    freeAttrs(attrs, old_nattrs);
+    return rtn;
+}
+
+// Called when an instance of cls with nattrs attributes needs room for one more.  Returns either the same array,
+// if it was presized with enough room, or a new one.
+static HCAttrs::AttrList* growAttrsIfFull(BoxedClass* cls, HCAttrs::AttrList* attrs, int nattrs) {
+    static StatCounter num_reallocs("num_hcattrs_reallocs");
+    static StatCounter num_reallocs_avoided("num_hcattrs_reallocs_avoided");
+
+    assert(arrayIsAtCapacity(nattrs));
+    if (attrsCapacity(attrs) > nattrs) {
+        num_reallocs_avoided.log();
+        return attrs;
+    }
 
+    num_reallocs.log();
+    if (BoxedHeapClass* hcls = asBoxedHeapClass(cls)) {
+        hcls->attrs_presize = std::max(hcls->attrs_presize, nattrs + 1);
+    }
+
+    HCAttrs::AttrList* rtn = allocAttrsForInstance(cls, attrs, nattrs);
+    freeAttrs(attrs);
     return rtn;
 }
 
+// Moves a full set of inline attribute slots out to a newly-allocated array.
+static HCAttrs::AttrList* moveAttrsOutOfLine(BoxedClass* cls, HCAttrs::AttrList* inline_attrs, int nattrs) {
+    static StatCounter num_inline_overflows("num_hcattrs_inline_overflows");
+    num_inline_overflows.log();
+
+    return allocAttrsForInstance(cls, inline_attrs, nattrs);
+}
+
+// The number of instance deallocations in a row that have to come in under attrs_presize before we lower it.
+#define ATTRS_PRESIZE_TRIM_THRESHOLD 32
+
+void BoxedHeapClass::noteFinalAttrCount(int nattrs) {
+    static StatCounter num_trims("num_hcattrs_presize_trims");
+
+    if (attrs_presize == 0)
+        return;
+
+    if (attrsCapacityFor(nattrs) >= attrsCapacityFor(attrs_presize)) {
+        attrs_presize_overshoots = 0;
+        attrs_presize_window_max = 0;
+        return;
+    }
+
+    attrs_presize_window_max = std::max(attrs_presize_window_max, nattrs);
+    if (++attrs_presize_overshoots >= ATTRS_PRESIZE_TRIM_THRESHOLD) {
+        num_trims.log();
+        attrs_presize = attrs_presize_window_max;
+        attrs_presize_overshoots = 0;
+        attrs_presize_window_max = 0;
+    }
+}
+
 void Box::setDictBacked(STOLEN(Box*) val) {
     // this checks for: v.__dict__ = v.__dict__
     if (val->cls == attrwrapper_cls && unwrapAttrWrapper(val) == this) {
@@ -1321,6 +1441,7 @@ void Box::setDictBacked(STOLEN(Box*) val) {
 
     auto old_attr_list = hcattrs->attr_list;
     int old_attr_list_size = hcls->getAsSingletonOrNormal()->attributeArraySize();
+    bool old_attr_list_inline = hcattrs->hasInlineAttrList();
 
     hcattrs->hcls = HiddenClass::dict_backed;
     hcattrs->attr_list = new_attr_list;
@@ -1328,7 +1449,8 @@ void Box::setDictBacked(STOLEN(Box*) val) {
     assert((bool)old_attr_list == (bool)old_attr_list_size);
     if (old_attr_list_size) {
         decrefArray(old_attr_list->attrs, old_attr_list_size);
-        freeAttrs(old_attr_list, old_attr_list_size);
+        if (!old_attr_list_inline)
+            freeAttrs(old_attr_list);
     }
 }
 
@@ -1340,6 +1462,7 @@ void HCAttrs::_clearRaw() noexcept {
 
     auto old_attr_list = this->attr_list;
     auto old_attr_list_size = hcls->attributeArraySize();
+    bool old_attr_list_inline = this->hasInlineAttrList();
 
     // singleton classes will not get reused so free it
     if (hcls->type == HiddenClass::SINGLETON) {
@@ -1354,8 +1477,8 @@ void HCAttrs::_clearRaw() noexcept {
         // DICT_BACKED attrs don't use the freelist:
         if (hcls->type == HiddenClass::DICT_BACKED)
             PyObject_FREE(old_attr_list);
-        else
-            freeAttrs(old_attr_list, old_attr_list_size);
+        else if (!old_attr_list_inline)
+            freeAttrs(old_attr_list);
     }
 }
 
@@ -1437,28 +1560,64 @@ void Box::appendNewHCAttr(BORROWED(Box*) new_attr, SetattrRewriteArgs* rewrite_a
     assert(hcls->type == HiddenClass::NORMAL || hcls->type == HiddenClass::SINGLETON);
 
     int numattrs = hcls->attributeArraySize();
+    int num_inline_attrs = cls->num_inline_attrs;
+
+    if (numattrs < num_inline_attrs) {
+        // The new attribute still fits into the object's inline slots.
+        assert(numattrs == 0 || attrs->hasInlineAttrList());
+        if (numattrs == 0)
+            attrs->attr_list = attrs->inlineAttrList();
+
+        if (rewrite_args) {
+            rewrite_args->obj->setAttr(inlineAttrOffset(cls, numattrs), rewrite_args->attrval,
+                                       RewriterVar::SetattrType::HANDED_OFF);
+            rewrite_args->attrval->refConsumed();
+
+            if (numattrs == 0) {
+                RewriterVar* r_inline = rewrite_args->rewriter->add(
+                    rewrite_args->obj, cls->attrs_offset + sizeof(HCAttrs), Location::any());
+                rewrite_args->obj->setAttr(cls->attrs_offset + offsetof(HCAttrs, attr_list), r_inline);
+            }
+
+            rewrite_args->out_success = true;
+        }
+        attrs->attr_list->attrs[numattrs] = incref(new_attr);
+        return;
+    }
 
     RewriterVar* r_array = NULL;
-    if (numattrs == 0 || arrayIsAtCapacity(numattrs)) {
+    if (numattrs == num_inline_attrs && num_inline_attrs > 0) {
+        // The inline slots are full; move all the attributes out of line.
+        assert(attrs->hasInlineAttrList());
+        attrs->attr_list = moveAttrsOutOfLine(cls, attrs->attr_list, numattrs);
+        if (rewrite_args) {
+            RewriterVar* r_cls = rewrite_args->rewriter->loadConst((intptr_t)cls, Location::forArg(0));
+            RewriterVar* r_inline = rewrite_args->rewriter->add(rewrite_args->obj, cls->attrs_offset + sizeof(HCAttrs),
+                                                                Location::forArg(1));
+            RewriterVar* r_oldsize = rewrite_args->rewriter->loadConst(numattrs, Location::forArg(2));
+            r_array = rewrite_args->rewriter->call(true, (void*)moveAttrsOutOfLine, r_cls, r_inline, r_oldsize);
+        }
+    } else if (numattrs == 0 || arrayIsAtCapacity(numattrs)) {
         if (numattrs == 0) {
-            attrs->attr_list = allocFromFreelist(0);
+            attrs->attr_list = allocAttrsForInstance(cls, NULL, 0);
             if (rewrite_args) {
-                RewriterVar* r_newsize = rewrite_args->rewriter->loadConst(0, Location::forArg(0));
-                r_array = rewrite_args->rewriter->call(true, (void*)allocFromFreelist, r_newsize);
+                RewriterVar* r_cls = rewrite_args->rewriter->loadConst((intptr_t)cls, Location::forArg(0));
+                RewriterVar* r_null = rewrite_args->rewriter->loadConst(0, Location::forArg(1));
+                RewriterVar* r_oldsize = rewrite_args->rewriter->loadConst(0, Location::forArg(2));
+                r_array = rewrite_args->rewriter->call(true, (void*)allocAttrsForInstance, r_cls, r_null, r_oldsize);
             }
         } else {
-            int new_size = nextAttributeArraySize(numattrs);
-            attrs->attr_list = (HCAttrs::AttrList*)reallocAttrs(attrs->attr_list, numattrs, new_size);
+            attrs->attr_list = growAttrsIfFull(cls, attrs->attr_list, numattrs);
             if (rewrite_args) {
                 if (cls->attrs_offset < 0) {
                     REWRITE_ABORTED("");
                     rewrite_args = NULL;
                 } else {
+                    RewriterVar* r_cls = rewrite_args->rewriter->loadConst((intptr_t)cls, Location::forArg(0));
                     RewriterVar* r_oldarray = rewrite_args->obj->getAttr(
-                        cls->attrs_offset + offsetof(HCAttrs, attr_list), Location::forArg(0));
-                    RewriterVar* r_oldsize = rewrite_args->rewriter->loadConst(numattrs, Location::forArg(1));
-                    RewriterVar* r_newsize = rewrite_args->rewriter->loadConst(new_size, Location::forArg(2));
-                    r_array = rewrite_args->rewriter->call(true, (void*)reallocAttrs, r_oldarray, r_oldsize, r_newsize);
+                        cls->attrs_offset + offsetof(HCAttrs, attr_list), Location::forArg(1));
+                    RewriterVar* r_oldsize = rewrite_args->rewriter->loadConst(numattrs, Location::forArg(2));
+                    r_array = rewrite_args->rewriter->call(true, (void*)growAttrsIfFull, r_cls, r_oldarray, r_oldsize);
                 }
             }
         }
@@ -1561,6 +1720,11 @@ void Box::setattr(BoxedString* attr, BORROWED(Box*) val, SetattrRewriteArgs* rew
                 if (cls->attrs_offset < 0) {
                     REWRITE_ABORTED("");
                     rewrite_args = NULL;
+                } else if (hclsImpliesInlineAttrs(cls, hcls)) {
+                    rewrite_args->obj->replaceAttr(inlineAttrOffset(cls, offset), rewrite_args->attrval,
+                                                   /* prev_nullable */ false);
+
+                    rewrite_args->out_success = true;
                 } else {
                     RewriterVar* r_hattrs
                         = rewrite_args->obj->getAttr(cls->attrs_offset + offsetof(HCAttrs, attr_list), Location::any());
@@ -1580,7 +1744,7 @@ void Box::setattr(BoxedString* attr, BORROWED(Box*) val, SetattrRewriteArgs* rew
         if (hcls->type == HiddenClass::NORMAL) {
             auto* new_hcls = hcls->getAsNormal()->getOrMakeChild(attr);
             // make sure we don't need to rearrange the attributes
-            assert(new_hcls->getStrAttrOffsets().lookup(attr) == hcls->attributeArraySize());
+            assert(new_hcls->getOffset(attr) == hcls->attributeArraySize());
 
             this->appendNewHCAttr(val, rewrite_args);
             attrs->hcls = new_hcls;
@@ -1630,21 +1794,28 @@ extern "C" BORROWED(PyObject*) _PyType_Lookup(PyTypeObject* type, PyObject* name
 }
 
 #define MCACHE_MAX_ATTR_SIZE 100
-#define MCACHE_SIZE_EXP 10
+// Pyston change: CPython 2.7 uses 10 here; we route all non-IC'd type lookups (including the ones coming from
+// the C API) through this cache, so make it bigger.
+#define MCACHE_SIZE_EXP 12
 #define MCACHE_HASH(version, name_hash)                                                                                \
     (((unsigned int)(version) * (unsigned int)(name_hash)) >> (8 * sizeof(unsigned int) - MCACHE_SIZE_EXP))
 #define MCACHE_HASH_METHOD(type, name) MCACHE_HASH((type)->tp_version_tag, ((BoxedString*)(name))->hash)
-#define MCACHE_CACHEABLE_NAME(name) PyString_CheckExact(name) && PyString_GET_SIZE(name) <= MCACHE_MAX_ATTR_SIZE
+#define MCACHE_CACHEABLE_NAME(name) (PyString_CheckExact(name) && PyString_GET_SIZE(name) <= MCACHE_MAX_ATTR_SIZE)
 
-struct method_cache_entry {
+// Pyston change: pad the entries out to 32 bytes and align them, so that a probe only ever touches one cache line.
+struct alignas(32) method_cache_entry {
     // Pyston change:
     // unsigned int version;
     PY_UINT64_T version;
     PyObject* name;  /* reference to exactly a str or None */
     PyObject* value; /* borrowed */
 };
+static_assert(sizeof(method_cache_entry) == 32, "");
 
 static struct method_cache_entry method_cache[1 << MCACHE_SIZE_EXP];
+static StatCounter mcache_hits("num_type_cache_hits");
+static StatCounter mcache_misses("num_type_cache_misses");
+static StatCounter mcache_uncacheable("num_type_cache_uncacheable");
 static unsigned int next_version_tag = 0;
 static bool is_wrap_around = false; // Pyston addition
 
@@ -1790,6 +1961,7 @@ BORROWED(Box*) typeLookup(BoxedClass* cls, BoxedString* attr, GetattrRewriteArgs
             if (method_cache[h].version == cls->tp_version_tag && method_cache[h].name == attr) {
                 val = method_cache[h].value;
                 found_cached_entry = true;
+                mcache_hits.log();
             }
         }
 
@@ -1810,12 +1982,16 @@ BORROWED(Box*) typeLookup(BoxedClass* cls, BoxedString* attr, GetattrRewriteArgs
             }
 
             if (MCACHE_CACHEABLE_NAME(attr) && assign_version_tag(cls)) {
+                mcache_misses.log();
+
                 auto h = MCACHE_HASH_METHOD(cls, attr);
                 method_cache[h].version = cls->tp_version_tag;
                 method_cache[h].value = val; /* borrowed */
                 Py_INCREF(attr);
                 Py_DECREF(method_cache[h].name);
                 method_cache[h].name = attr;
+            } else {
+                mcache_uncacheable.log();
             }
         }
         if (rewrite_args) {
@@ -5722,6 +5898,22 @@ extern "C" Box* augbinop(Box* lhs, Box* rhs, int op_type) {
     return rtn;
 }
 
+// Implements `name += rhs` where name is the local stored in vregs[vreg], for callers that know the
+// result gets stored straight back into it.  If the variable holds a str that nothing else refers
+// to (its only references are the variable's and the one we were passed), we can take over the
+// variable's reference and append in place.  Otherwise this is just augbinop.
+extern "C" Box* augbinopLocal(STOLEN(Box*) lhs, Box* rhs, int op_type, Box** vregs, int vreg) {
+    if (op_type == AST_TYPE::Add && lhs->cls == str_cls && rhs->cls == str_cls && lhs->ob_refcnt == 2
+        && vregs[vreg] == lhs && static_cast<BoxedString*>(lhs)->interned_state == SSTATE_NOT_INTERNED) {
+        vregs[vreg] = NULL;
+        Py_DECREF(lhs);
+        return strAppendInPlace(static_cast<BoxedString*>(lhs), static_cast<BoxedString*>(rhs));
+    }
+
+    AUTO_DECREF(lhs);
+    return augbinop(lhs, rhs, op_type);
+}
+
 static bool convert3wayCompareResultToBool(Box* v, int op_type) {
     long result = PyInt_AsLong(v);
     if (result == -1 && PyErr_Occurred())
@@ -6412,6 +6604,26 @@ Box* getitemInternal(Box* target, Box* slice, GetitemRewriteArgs* rewrite_args)
         rewrite_args = NULL;
     }
 
+    // Indexing an exact dict with an exact str is common enough to get its own path.
+    if (target->cls == dict_cls && slice->cls == str_cls) {
+        if (rewrite_args) {
+            RewriterVar* r_obj = rewrite_args->target;
+            RewriterVar* r_slice = rewrite_args->slice;
+            r_obj->addAttrGuard(offsetof(Box, cls), (intptr_t)dict_cls);
+            r_slice->addAttrGuard(offsetof(Box, cls), (intptr_t)str_cls);
+            RewriterVar* r_rtn
+                = rewrite_args->rewriter->call(true, (void*)dictGetitemStr, r_obj, r_slice)->setType(RefType::OWNED);
+            if (S == CXX)
+                rewrite_args->rewriter->checkAndThrowCAPIException(r_rtn);
+            rewrite_args->out_success = true;
+            rewrite_args->out_rtn = r_rtn;
+        }
+        Box* r = dictGetitemStr(static_cast<BoxedDict*>(target), static_cast<BoxedString*>(slice));
+        if (S == CXX && !r)
+            throwCAPIException();
+        return r;
+    }
+
     // The PyObject_GetItem logic is:
     // - call mp_subscript if it exists
     // - if tp_as_sequence exists, try using that (with a number of conditions)
@@ -6684,6 +6896,15 @@ void Box::delattr(BoxedString* attr, DelattrRewriteArgs* rewrite_args) {
         // TODO: we might want to free some of this memory eventually
         // attrs->attr_list = (HCAttrs::AttrList*)reallocAttrs(attrs->attr_list, num_attrs, new_size);
 
+        // ICs assume that an object whose hidden class fits into the inline slots stores its attributes there,
+        // so move them back once we drop below the limit.
+        if (cls->num_inline_attrs && num_attrs - 1 == cls->num_inline_attrs && !attrs->hasInlineAttrList()) {
+            HCAttrs::AttrList* old_attr_list = attrs->attr_list;
+            attrs->attr_list = attrs->inlineAttrList();
+            memcpy(attrs->attr_list->attrs, old_attr_list->attrs, sizeof(Box*) * (num_attrs - 1));
+            freeAttrs(old_attr_list);
+        }
+
         Py_DECREF(removed_object);
         return;
     }
@@ -7081,6 +7302,7 @@ Box* _typeNew(BoxedClass* metatype, BoxedString* name, BoxedTuple* bases, BoxedD
     }
 
     int attrs_offset = base->attrs_offset;
+    int num_inline_attrs = 0;
     int dict_offset = base->tp_dictoffset;
     int weaklist_offset = 0;
     int basic_size = 0;
@@ -7093,8 +7315,9 @@ Box* _typeNew(BoxedClass* metatype, BoxedString* name, BoxedTuple* bases, BoxedD
             attrs_offset = -(long)sizeof(HCAttrs);
         } else {
             attrs_offset = cur_offset;
+            num_inline_attrs = NUM_INLINE_HCATTRS;
         }
-        cur_offset += sizeof(HCAttrs);
+        cur_offset += sizeof(HCAttrs) + num_inline_attrs * sizeof(Box*);
     }
     if (add_weak) {
         assert(!base->tp_itemsize);
@@ -7120,6 +7343,8 @@ Box* _typeNew(BoxedClass* metatype, BoxedString* name, BoxedTuple* bases, BoxedD
     BoxedHeapClass* made = BoxedHeapClass::create(metatype, base, attrs_offset, weaklist_offset, basic_size, true, name,
                                                   bases, total_slots);
     made->tp_dictoffset = dict_offset;
+    if (add_dict)
+        made->num_inline_attrs = num_inline_attrs;
 
     // XXX Hack: the classes vector lists all classes that have untracked references to them.
     // This is pretty much any class created in C code, since the C code will tend to hold on
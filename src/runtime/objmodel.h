@@ -83,6 +83,7 @@ extern "C" BoxedInt* len(Box* obj) __attribute__((noinline));
 extern "C" i64 unboxedLen(Box* obj) __attribute__((noinline));
 extern "C" Box* binop(Box* lhs, Box* rhs, int op_type) __attribute__((noinline));
 extern "C" Box* augbinop(Box* lhs, Box* rhs, int op_type) __attribute__((noinline));
+extern "C" Box* augbinopLocal(STOLEN(Box*) lhs, Box* rhs, int op_type, Box** vregs, int vreg);
 extern "C" Box* getitem(Box* value, Box* slice) __attribute__((noinline));
 extern "C" Box* getitem_capi(Box* value, Box* slice) noexcept __attribute__((noinline));
 extern "C" void setitem(Box* target, Box* slice, Box* value) __attribute__((noinline));
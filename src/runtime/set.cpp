@@ -131,6 +131,31 @@ static bool _setRemove(BoxedSet* self, BoxAndHash val) {
     return true;
 }
 
+// Adds all the elements of 'other' to 'self'.  Sets and exact dicts already know the hashes of their
+// elements, so those get merged in bulk: the table is presized once (like CPython's set_merge) and
+// nothing gets rehashed.
+static void setUnionUpdate2(BoxedSet* self, Box* other) {
+    if (PyAnySet_Check(other)) {
+        BoxedSet* other_set = static_cast<BoxedSet*>(other);
+        if (other_set == self)
+            return;
+        self->s.reserveForMerge(other_set->s.size());
+        for (auto&& elt : other_set->s) {
+            _setAdd(self, elt);
+        }
+    } else if (PyDict_CheckExact(other)) {
+        BoxedDict* other_dict = static_cast<BoxedDict*>(other);
+        self->s.reserveForMerge(other_dict->d.size());
+        for (auto&& p : other_dict->d) {
+            _setAdd(self, p.first);
+        }
+    } else {
+        for (auto elt : other->pyElements()) {
+            _setAddStolen(self, elt);
+        }
+    }
+}
+
 // Creates a set of type 'cls' from 'container' (NULL to get an empty set).
 // Works for frozenset and normal set types.
 BoxedSet* makeNewSet(BoxedClass* cls, Box* container) {
@@ -139,19 +164,7 @@ BoxedSet* makeNewSet(BoxedClass* cls, Box* container) {
     BoxedSet* rtn = new (cls) BoxedSet();
     if (container) {
         AUTO_DECREF(rtn);
-        if (PyAnySet_Check(container)) {
-            for (auto&& elt : ((BoxedSet*)container)->s) {
-                rtn->s.insert(incref(elt));
-            }
-        } else if (PyDict_CheckExact(container)) {
-            for (auto&& elt : ((BoxedDict*)container)->d) {
-                rtn->s.insert(incref(elt.first));
-            }
-        } else {
-            for (auto elt : container->pyElements()) {
-                _setAddStolen(rtn, elt);
-            }
-        }
+        setUnionUpdate2(rtn, container);
         return incref(rtn);
     }
     return rtn;
@@ -229,21 +242,7 @@ Box* setInit(Box* _self, Box* container, BoxedDict* kwargs) {
     BoxedSet* self = static_cast<BoxedSet*>(_self);
 
     setClearInternal(self);
-
-    if (PyAnySet_Check(container)) {
-        for (auto&& elt : ((BoxedSet*)container)->s) {
-            self->s.insert(incref(elt));
-        }
-    } else if (PyDict_CheckExact(container)) {
-        for (auto&& elt : ((BoxedDict*)container)->d) {
-            self->s.insert(incref(elt.first));
-        }
-
-    } else {
-        for (auto elt : container->pyElements()) {
-            _setAddStolen(self, elt);
-        }
-    }
+    setUnionUpdate2(self, container);
 
     return incref(Py_None);
 }
@@ -305,6 +304,19 @@ static Box* set_repr(Box* self) noexcept {
 }
 
 static void _setSymmetricDifferenceUpdate(BoxedSet* self, Box* other) {
+    if (other == self) {
+        setClearInternal(self);
+        return;
+    }
+
+    if (PyDict_CheckExact(other)) {
+        for (auto&& p : static_cast<BoxedDict*>(other)->d) {
+            if (!_setRemove(self, p.first))
+                _setAdd(self, p.first);
+        }
+        return;
+    }
+
     if (!PyAnySet_Check(other)) {
         other = makeNewSet(self->cls, other);
     } else {
@@ -314,21 +326,87 @@ static void _setSymmetricDifferenceUpdate(BoxedSet* self, Box* other) {
 
     BoxedSet* other_set = static_cast<BoxedSet*>(other);
 
-    for (auto elt : other_set->s) {
-        auto&& p = self->s.insert(elt);
-        if (!p.second /* already exists */) {
+    for (auto&& elt : other_set->s) {
+        if (!_setRemove(self, elt))
+            _setAdd(self, elt);
+    }
+}
+
+static void setDifferenceUpdate2(BoxedSet* self, Box* other) {
+    if (other == self) {
+        setClearInternal(self);
+        return;
+    }
+
+    if (PyAnySet_Check(other)) {
+        for (auto&& elt : static_cast<BoxedSet*>(other)->s) {
+            _setRemove(self, elt);
+        }
+    } else if (PyDict_CheckExact(other)) {
+        for (auto&& p : static_cast<BoxedDict*>(other)->d) {
+            _setRemove(self, p.first);
+        }
+    } else {
+        for (auto elt : other->pyElements()) {
+            AUTO_DECREF(elt);
             _setRemove(self, elt);
-        } else {
-            Py_INCREF(elt.value);
         }
     }
+
+    self->s.compactAfterRemovals();
+}
+
+// Returns self - other.  If 'other' is a set or a dict, the survivors get copied into a fresh set using
+// their stored hashes, instead of copying all of self and then removing elements one by one.
+static BoxedSet* setDifference2(BoxedSet* self, Box* other) {
+    if (!PyAnySet_Check(other) && !PyDict_CheckExact(other)) {
+        BoxedSet* rtn = makeNewSet(self->cls, self);
+        AUTO_DECREF(rtn);
+        setDifferenceUpdate2(rtn, other);
+        return incref(rtn);
+    }
+
+    BoxedSet* rtn = makeNewSet(self->cls, NULL);
+    AUTO_DECREF(rtn);
+    if (PyDict_CheckExact(other)) {
+        BoxedDict* other_dict = static_cast<BoxedDict*>(other);
+        for (auto&& elt : self->s) {
+            if (!other_dict->d.count(elt))
+                _setAdd(rtn, elt);
+        }
+    } else {
+        BoxedSet* other_set = static_cast<BoxedSet*>(other);
+        for (auto&& elt : self->s) {
+            if (!other_set->s.count(elt))
+                _setAdd(rtn, elt);
+        }
+    }
+    return incref(rtn);
 }
 
 static BoxedSet* setIntersection2(BoxedSet* self, Box* container) {
     RELEASE_ASSERT(PyAnySet_Check(self), "");
 
+    if (container == self)
+        return makeNewSet(self->cls, self);
+
     BoxedSet* rtn = makeNewSet(self->cls, NULL);
     AUTO_DECREF(rtn);
+
+    if (PyAnySet_Check(container)) {
+        // Walk the smaller of the two sets and probe the larger one with the hashes we already have.
+        BoxedSet* smaller = static_cast<BoxedSet*>(container);
+        BoxedSet* larger = self;
+        if (smaller->s.size() > larger->s.size())
+            std::swap(smaller, larger);
+
+        for (auto&& elt : smaller->s) {
+            if (larger->s.count(elt))
+                _setAdd(rtn, elt);
+        }
+        return incref(rtn);
+    }
+
     for (auto elt : container->pyElements()) {
         AUTO_DECREF(elt);
         BoxAndHash elt_hashed(elt); // this can throw!
@@ -350,10 +428,7 @@ Box* setIOr(BoxedSet* lhs, BoxedSet* rhs) {
     if (!PyAnySet_Check(rhs))
         return incref(NotImplemented);
 
-    // TODO just [write and] call setUnionUpdate2
-    for (auto&& elt : rhs->s) {
-        _setAdd(lhs, elt);
-    }
+    setUnionUpdate2(lhs, rhs);
     return incref(lhs);
 }
 
@@ -364,7 +439,9 @@ Box* setOr(BoxedSet* lhs, BoxedSet* rhs) {
 
     BoxedSet* rtn = makeNewSet(lhs->cls, lhs);
     AUTO_DECREF(rtn);
-    return setIOr(rtn, rhs);
+    if (rhs != lhs)
+        setUnionUpdate2(rtn, rhs);
+    return incref(rtn);
 }
 
 Box* setIAnd(BoxedSet* lhs, BoxedSet* rhs) {
@@ -390,10 +467,7 @@ Box* setISub(BoxedSet* lhs, BoxedSet* rhs) {
     if (!PyAnySet_Check(rhs))
         return incref(NotImplemented);
 
-    // TODO: write and call setDifferenceUpdate2
-    for (auto&& elt : rhs->s) {
-        _setRemove(lhs, elt);
-    }
+    setDifferenceUpdate2(lhs, rhs);
     return incref(lhs);
 }
 
@@ -402,9 +476,7 @@ Box* setSub(BoxedSet* lhs, BoxedSet* rhs) {
     if (!PyAnySet_Check(rhs))
         return incref(NotImplemented);
 
-    BoxedSet* rtn = makeNewSet(lhs->cls, lhs);
-    AUTO_DECREF(rtn);
-    return setISub(rtn, rhs);
+    return setDifference2(lhs, rhs);
 }
 
 Box* setIXor(BoxedSet* lhs, BoxedSet* rhs) {
@@ -422,9 +494,11 @@ Box* setXor(BoxedSet* lhs, BoxedSet* rhs) {
     if (!PyAnySet_Check(rhs))
         return incref(NotImplemented);
 
-    BoxedSet* rtn = makeNewSet(lhs->cls, lhs);
+    // Like CPython, start from a copy of the right-hand side.
+    BoxedSet* rtn = makeNewSet(lhs->cls, rhs);
     AUTO_DECREF(rtn);
-    return setIXor(rtn, rhs);
+    _setSymmetricDifferenceUpdate(rtn, lhs);
+    return incref(rtn);
 }
 
 Box* setIter(BoxedSet* self) noexcept {
@@ -493,16 +567,7 @@ Box* setUpdate(BoxedSet* self, BoxedTuple* args) {
     assert(args->cls == tuple_cls);
 
     for (auto l : *args) {
-        if (l->cls == set_cls) {
-            BoxedSet* s2 = static_cast<BoxedSet*>(l);
-            for (auto&& p : s2->s) {
-                _setAdd(self, p);
-            }
-        } else {
-            for (auto e : l->pyElements()) {
-                _setAddStolen(self, e);
-            }
-        }
+        setUnionUpdate2(self, l);
     }
 
     return incref(Py_None);
@@ -515,41 +580,21 @@ Box* setUnion(BoxedSet* self, BoxedTuple* args) {
     BoxedSet* rtn = makeNewSet(self->cls, self);
     AUTO_DECREF(rtn);
 
-    for (auto container : args->pyElements()) {
-        AUTO_DECREF(container);
-        for (auto elt : container->pyElements()) {
-            _setAddStolen(rtn, elt);
-        }
+    for (auto container : *args) {
+        if (container != self)
+            setUnionUpdate2(rtn, container);
     }
     return incref(rtn);
 }
 
-static void _setDifferenceUpdate(BoxedSet* self, BoxedTuple* args) {
-    for (auto container : args->pyElements()) {
-        AUTO_DECREF(container);
-        if (PyAnySet_Check(container)) {
-            for (auto&& elt : ((BoxedSet*)container)->s) {
-                _setRemove(self, elt);
-            }
-        } else if (PyDict_CheckExact(container)) {
-            for (auto&& elt : ((BoxedDict*)container)->d) {
-                _setRemove(self, elt.first);
-            }
-        } else {
-            for (auto elt : container->pyElements()) {
-                AUTO_DECREF(elt);
-                _setRemove(self, elt);
-            }
-        }
-    }
-}
-
 Box* setDifferenceUpdate(BoxedSet* self, BoxedTuple* args) {
     if (!PySet_Check(self))
         raiseExcHelper(TypeError, "descriptor 'difference_update' requires a 'set' object but received a '%s'",
                        getTypeName(self));
 
-    _setDifferenceUpdate(self, args);
+    for (auto container : *args) {
+        setDifferenceUpdate2(self, container);
+    }
     return incref(Py_None);
 }
 
@@ -558,9 +603,14 @@ Box* setDifference(BoxedSet* self, BoxedTuple* args) {
         raiseExcHelper(TypeError, "descriptor 'difference' requires a 'set' object but received a '%s'",
                        getTypeName(self));
 
-    BoxedSet* rtn = makeNewSet(self->cls, self);
+    if (args->size() == 0)
+        return makeNewSet(self->cls, self);
+
+    BoxedSet* rtn = setDifference2(self, args->elts[0]);
     AUTO_DECREF(rtn);
-    _setDifferenceUpdate(rtn, args);
+    for (int i = 1; i < args->size(); i++) {
+        setDifferenceUpdate2(rtn, args->elts[i]);
+    }
     return incref(rtn);
 }
 
@@ -579,9 +629,9 @@ Box* setSymmetricDifference(BoxedSet* self, Box* other) {
         raiseExcHelper(TypeError, "descriptor 'symmetric_difference' requires a 'set' object but received a '%s'",
                        getTypeName(self));
 
-    BoxedSet* rtn = makeNewSet(self->cls, self);
+    BoxedSet* rtn = makeNewSet(self->cls, other);
     AUTO_DECREF(rtn);
-    _setSymmetricDifferenceUpdate(rtn, other);
+    _setSymmetricDifferenceUpdate(rtn, self);
     return incref(rtn);
 }
 
@@ -623,6 +673,19 @@ static Box* setIssuperset(BoxedSet* self, Box* container) {
 static Box* setIsdisjoint(BoxedSet* self, Box* container) {
     RELEASE_ASSERT(PyAnySet_Check(self), "");
 
+    if (PyAnySet_Check(container)) {
+        BoxedSet* smaller = static_cast<BoxedSet*>(container);
+        BoxedSet* larger = self;
+        if (smaller->s.size() > larger->s.size())
+            std::swap(smaller, larger);
+
+        for (auto&& e : smaller->s) {
+            if (larger->s.count(e))
+                Py_RETURN_FALSE;
+        }
+        Py_RETURN_TRUE;
+    }
+
     for (auto e : container->pyElements()) {
         AUTO_DECREF(e);
         if (self->s.find(e) != self->s.end())
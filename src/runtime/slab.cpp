@@ -0,0 +1,173 @@
+// Copyright (c) 2014-2016 Dropbox, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "runtime/slab.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <sys/mman.h>
+
+#include "Python.h"
+
+#include "core/common.h"
+
+namespace pyston {
+
+// Slabs get carved out of chunks of this many pages; the chunks themselves are never unmapped, only the pages of
+// empty slabs are given back.
+static const size_t SLABS_PER_CHUNK = 64;
+
+// Every page that was ever used as a slab, so that slabFor() can check that a page really is one.  These are plain
+// globals (rather than std::vectors) because PyObject_Free() asks about every large block it frees, including during
+// static destruction.
+static SlabHeader** all_slabs;
+static uint32_t num_slabs, slabs_capacity;
+
+// Slabs whose pages were returned to the OS, by index into all_slabs.
+static uint32_t* released_slabs;
+static uint32_t num_released;
+
+static char* chunk_cur, *chunk_end;
+
+static SlabHeader* newSlabPage() {
+    if (num_released) {
+        // The page got zeroed when it was released, so its index has to be written again for slabFor() to find it.
+        uint32_t index = released_slabs[--num_released];
+        SlabHeader* slab = all_slabs[index];
+        slab->index = index;
+        return slab;
+    }
+
+    if (chunk_cur == chunk_end) {
+        void* chunk = mmap(NULL, SLABS_PER_CHUNK * SLAB_SIZE, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1,
+                           0);
+        RELEASE_ASSERT(chunk != MAP_FAILED, "");
+        assert((uintptr_t)chunk % SLAB_SIZE == 0);
+        chunk_cur = (char*)chunk;
+        chunk_end = chunk_cur + SLABS_PER_CHUNK * SLAB_SIZE;
+    }
+
+    if (num_slabs == slabs_capacity) {
+        slabs_capacity = slabs_capacity ? 2 * slabs_capacity : 1024;
+        all_slabs = (SlabHeader**)realloc(all_slabs, slabs_capacity * sizeof(SlabHeader*));
+        released_slabs = (uint32_t*)realloc(released_slabs, slabs_capacity * sizeof(uint32_t));
+        RELEASE_ASSERT(all_slabs && released_slabs, "");
+    }
+
+    SlabHeader* slab = (SlabHeader*)chunk_cur;
+    chunk_cur += SLAB_SIZE;
+    slab->index = num_slabs;
+    all_slabs[num_slabs++] = slab;
+    return slab;
+}
+
+SlabHeader* slabFor(void* p) {
+    SlabHeader* slab = (SlabHeader*)((uintptr_t)p & ~(SLAB_SIZE - 1));
+    // If p isn't ours, this reads whatever happens to be at the start of its page, which is fine since that page is
+    // mapped (p points into it), and the checks below reject it.
+    uint32_t index = slab->index;
+    if (index < num_slabs && all_slabs[index] == slab && slab->allocator)
+        return slab;
+    return NULL;
+}
+
+static std::vector<SlabAllocator*>* all_allocators;
+
+const std::vector<SlabAllocator*>& SlabAllocator::all() {
+    if (!all_allocators)
+        all_allocators = new std::vector<SlabAllocator*>();
+    return *all_allocators;
+}
+
+SlabAllocator::SlabAllocator(BoxedClass* cls, size_t size)
+    : block_size((size + SLAB_BLOCK_ALIGN - 1) & ~(SLAB_BLOCK_ALIGN - 1)),
+      partial(NULL),
+      nempty(0),
+      cls(cls),
+      nslabs(0),
+      nobjects(0),
+      nallocs(0),
+      nreleased(0) {
+    RELEASE_ASSERT(blocksPerSlab() >= 8, "%ld byte objects are too big for slab allocation", size);
+    all();
+    all_allocators->push_back(this);
+}
+
+void SlabAllocator::unlink(SlabHeader* slab) {
+    assert(slab->in_list);
+    if (slab->prev)
+        slab->prev->next = slab->next;
+    else
+        partial = slab->next;
+    if (slab->next)
+        slab->next->prev = slab->prev;
+    slab->in_list = false;
+}
+
+void* SlabAllocator::allocSlow() {
+    SlabHeader* slab = newSlabPage();
+    slab->allocator = this;
+    slab->free_list = NULL;
+    slab->bump = (char*)slab + SLAB_HEADER_SIZE;
+    slab->nused = 0;
+    slab->prev = slab->next = NULL;
+    slab->in_list = true;
+    partial = slab;
+    nempty++;
+    nslabs++;
+    return alloc();
+}
+
+void SlabAllocator::freeSlow(SlabHeader* slab) {
+    if (!slab->in_list) {
+        // It was full; now it has room again.
+        slab->prev = NULL;
+        slab->next = partial;
+        if (partial)
+            partial->prev = slab;
+        partial = slab;
+        slab->in_list = true;
+    }
+
+    if (slab->nused)
+        return;
+
+    // Keep one empty slab, so that allocating and freeing a single object doesn't map and unmap a page every time.
+    if (++nempty == 1)
+        return;
+
+    unlink(slab);
+    nempty--;
+    nslabs--;
+    nreleased++;
+    uint32_t index = slab->index;
+    slab->allocator = NULL;
+    // This zeroes the page (including the header) the next time it gets touched.
+    madvise(slab, SLAB_SIZE, MADV_DONTNEED);
+    released_slabs[num_released++] = index;
+}
+
+extern "C" int _PySlab_Free(void* p) noexcept {
+    SlabHeader* slab = slabFor(p);
+    if (!slab)
+        return 0;
+    slab->allocator->free(slab, p);
+    return 1;
+}
+
+extern "C" size_t _PySlab_BlockSize(void* p) noexcept {
+    SlabHeader* slab = slabFor(p);
+    return slab ? slab->allocator->blockSize() : 0;
+}
+}
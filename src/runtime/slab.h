@@ -0,0 +1,114 @@
+// Copyright (c) 2014-2016 Dropbox, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef PYSTON_RUNTIME_SLAB_H
+#define PYSTON_RUNTIME_SLAB_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "core/common.h"
+
+namespace pyston {
+
+class BoxedClass;
+class SlabAllocator;
+
+// Typed slab allocation for small fixed-size objects that get created and destroyed at a high rate (bound methods,
+// slices, iterators, generators).  Classes opt in with DEFAULT_CLASS_SIMPLE_SLAB (or by allocating with the SLAB /
+// SLAB_GC tokens), and each such class gets its own SlabAllocator, so instances of one class are packed together
+// instead of sharing pymalloc's size classes with everything else.
+//
+// A slab is one page: a cache line of header followed by equally-sized blocks.  Blocks are freed through the usual
+// tp_free functions; PyObject_Free recognizes slab blocks by their address (see _PySlab_Free) since they aren't in
+// any pymalloc arena.  Slabs that become empty are returned to the OS with madvise(), except for one per class that
+// is kept around so that a loop that allocates and frees a single object doesn't keep faulting in a page.
+
+static const size_t SLAB_SIZE = 4096;
+static const size_t SLAB_HEADER_SIZE = 64;
+static const size_t SLAB_BLOCK_ALIGN = 16;
+
+struct alignas(SLAB_HEADER_SIZE) SlabHeader {
+    SlabAllocator* allocator; // NULL while the slab is unused
+    void* free_list;          // blocks that were freed, linked through their first word
+    char* bump;               // start of the blocks that were never handed out
+    SlabHeader* prev, *next;  // in the allocator's list of slabs that have free blocks
+    uint32_t index;           // position in the list of all slabs, used to validate slab addresses
+    uint32_t nused;
+    bool in_list;
+
+    char* end() { return (char*)this + SLAB_SIZE; }
+};
+static_assert(sizeof(SlabHeader) == SLAB_HEADER_SIZE, "");
+
+class SlabAllocator {
+private:
+    const size_t block_size;
+    // Slabs with at least one free block; slabs that are partly used come before empty ones.
+    SlabHeader* partial;
+    int nempty;
+
+    void* allocSlow();
+    void freeSlow(SlabHeader* slab);
+    void unlink(SlabHeader* slab);
+
+public:
+    BoxedClass* const cls;
+    // Stats
+    int64_t nslabs, nobjects, nallocs, nreleased;
+
+    SlabAllocator(BoxedClass* cls, size_t size);
+
+    size_t blockSize() const { return block_size; }
+    size_t blocksPerSlab() const { return (SLAB_SIZE - SLAB_HEADER_SIZE) / block_size; }
+
+    void* alloc() {
+        SlabHeader* slab = partial;
+        if (unlikely(!slab))
+            return allocSlow();
+
+        void* p = slab->free_list;
+        if (p)
+            slab->free_list = *(void**)p;
+        else {
+            p = slab->bump;
+            slab->bump += block_size;
+        }
+        if (unlikely(slab->nused++ == 0))
+            nempty--;
+        if (unlikely(!slab->free_list && slab->bump + block_size > slab->end()))
+            unlink(slab);
+        nobjects++;
+        nallocs++;
+        return p;
+    }
+
+    void free(SlabHeader* slab, void* p) {
+        *(void**)p = slab->free_list;
+        slab->free_list = p;
+        nobjects--;
+        slab->nused--;
+        if (unlikely(!slab->in_list || slab->nused == 0))
+            freeSlow(slab);
+    }
+
+    static const std::vector<SlabAllocator*>& all();
+};
+
+// Returns the slab that p was allocated from, or NULL.
+SlabHeader* slabFor(void* p);
+}
+
+#endif
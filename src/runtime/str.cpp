@@ -369,6 +369,31 @@ template <ExceptionStyle S> Box* strAdd(BoxedString* lhs, Box* _rhs) noexcept(S
     return new (lhs->size() + rhs->size()) BoxedString(lhs->s(), rhs->s());
 }
 
+// Like CPython's string_concatenate: since nothing else can see lhs, we can realloc it instead of
+// copying it into a fresh string.  When a loop keeps appending to the same string, the allocator
+// can usually extend the block in place (and large blocks get moved with mremap rather than
+// copied), so `s += piece` loops aren't quadratic anymore.
+BoxedString* strAppendInPlace(STOLEN(BoxedString*) lhs, BoxedString* rhs) {
+    assert(lhs->cls == str_cls && lhs->ob_refcnt == 1 && lhs->interned_state == SSTATE_NOT_INTERNED);
+    assert(lhs != rhs);
+
+    static StatCounter num_str_append_inplace("num_str_append_inplace");
+    num_str_append_inplace.log();
+
+    Py_ssize_t lhs_size = lhs->size();
+    Py_ssize_t rhs_size = rhs->size();
+    if (rhs_size > PY_SSIZE_T_MAX - lhs_size) {
+        Py_DECREF(lhs);
+        raiseExcHelper(OverflowError, "strings are too large to concat");
+    }
+
+    PyObject* rtn = lhs;
+    if (_PyString_Resize(&rtn, lhs_size + rhs_size))
+        throwCAPIException();
+    memcpy(PyString_AS_STRING(rtn) + lhs_size, rhs->data(), rhs_size);
+    return static_cast<BoxedString*>(rtn);
+}
+
 /* Format codes
  * F_LJUST      '-'
  * F_SIGN       '+'
@@ -2080,14 +2105,7 @@ template <ExceptionStyle S> static inline int stringContainsShared(BoxedString*
     }
 
     BoxedString* sub = static_cast<BoxedString*>(elt);
-
-    size_t found_idx;
-    if (sub->size() == 1)
-        // Call the much-faster single-character find():
-        found_idx = self->s().find(sub->s()[0]);
-    else
-        found_idx = self->s().find(sub->s());
-    return (found_idx != std::string::npos);
+    return _PyString_FindSubstring(self->data(), self->size(), sub->data(), sub->size()) >= 0;
 }
 
 // Analoguous to CPython's, used for sq_ slots.
@@ -2451,9 +2469,9 @@ extern "C" int _PyString_Resize(PyObject** pv, Py_ssize_t newsize) noexcept {
         PyErr_NoMemory();
         return -1;
     }
-    _Py_NewReference(*pv);
     sv = (PyStringObject*)*pv;
     Py_SIZE(sv) = newsize;
+    _Py_NewReference(*pv);
     sv->ob_sval[newsize] = '\0';
     sv->ob_shash = -1; /* invalidate cached hash value */
     return 0;
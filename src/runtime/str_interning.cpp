@@ -71,6 +71,7 @@ BoxedString* internStringImmortal(llvm::StringRef s) noexcept {
     interned_strings.insert((BoxedString*)entry);
 
     Py_INCREF(entry);
+    makeImmortal(entry);
     return entry;
 }
 
@@ -101,6 +102,9 @@ extern "C" void PyString_InternInPlace(PyObject** p) noexcept {
 
         // CPython returns mortal but in our current implementation they are inmortal
         s->interned_state = SSTATE_INTERNED_IMMORTAL;
+        // Unlike the identifiers and static strings that go through internStringImmortal(), these can come from
+        // program data (eg intern()), so their refcounts stay real: teardown releases them and the refcount checks
+        // still see them.
     }
 }
 
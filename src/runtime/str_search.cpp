@@ -0,0 +1,223 @@
+// Copyright (c) 2014-2016 Dropbox, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <cstring>
+
+#ifdef __x86_64__
+#include <immintrin.h>
+#endif
+
+#include "Python.h"
+
+#include "core/common.h"
+
+// Search kernels for byte strings.  These back stringlib's fastsearch() for str and bytearray
+// (see stringlib/fastsearch.h), the split helpers in stringlib/split.h, and str.__contains__.
+//
+// Substring search uses the "generic SIMD" approach: compare a block of the haystack against the
+// first and the last character of the needle at the same time, and only look at the positions
+// where both match.  That filters out nearly all candidates for real-world text, and unlike
+// pcmpestri it doesn't slow down for longer needles.  Single characters go to memchr/memrchr,
+// which glibc already vectorizes.
+//
+// SSE2 is part of x86-64, so it is always available; the AVX2 versions are picked at startup
+// if the CPU supports them.
+
+namespace pyston {
+
+namespace {
+
+Py_ssize_t findSubstringScalar(const char* s, Py_ssize_t n, const char* p, Py_ssize_t m, Py_ssize_t i) {
+    const char first = p[0], last = p[m - 1];
+    for (; i + m <= n; i++) {
+        if (s[i] == first && s[i + m - 1] == last && memcmp(s + i + 1, p + 1, m - 2) == 0)
+            return i;
+    }
+    return -1;
+}
+
+Py_ssize_t countCharScalar(const char* s, Py_ssize_t n, char c, Py_ssize_t maxcount, Py_ssize_t i,
+                           Py_ssize_t count) {
+    for (; i < n; i++) {
+        if (s[i] == c && ++count >= maxcount)
+            return maxcount;
+    }
+    return count;
+}
+
+// Py_ISSPACE is true for ' ' and '\t' through '\r'.
+inline bool isSpace(char c) {
+    return c == ' ' || (unsigned char)(c - '\t') <= '\r' - '\t';
+}
+
+#ifdef __x86_64__
+inline __m128i spaceMask(__m128i v) {
+    __m128i shifted = _mm_sub_epi8(v, _mm_set1_epi8('\t'));
+    __m128i in_range = _mm_cmpeq_epi8(_mm_min_epu8(shifted, _mm_set1_epi8('\r' - '\t')), shifted);
+    return _mm_or_si128(in_range, _mm_cmpeq_epi8(v, _mm_set1_epi8(' ')));
+}
+
+Py_ssize_t findSubstringSSE2(const char* s, Py_ssize_t n, const char* p, Py_ssize_t m) {
+    const __m128i first = _mm_set1_epi8(p[0]);
+    const __m128i last = _mm_set1_epi8(p[m - 1]);
+
+    Py_ssize_t i = 0;
+    for (; i + m - 1 + 16 <= n; i += 16) {
+        __m128i block_first = _mm_loadu_si128((const __m128i*)(s + i));
+        __m128i block_last = _mm_loadu_si128((const __m128i*)(s + i + m - 1));
+        unsigned mask = _mm_movemask_epi8(
+            _mm_and_si128(_mm_cmpeq_epi8(first, block_first), _mm_cmpeq_epi8(last, block_last)));
+        while (mask) {
+            int bit = __builtin_ctz(mask);
+            if (memcmp(s + i + bit + 1, p + 1, m - 2) == 0)
+                return i + bit;
+            mask &= mask - 1;
+        }
+    }
+    return findSubstringScalar(s, n, p, m, i);
+}
+
+Py_ssize_t countCharSSE2(const char* s, Py_ssize_t n, char c, Py_ssize_t maxcount) {
+    const __m128i needle = _mm_set1_epi8(c);
+    Py_ssize_t i = 0, count = 0;
+    for (; i + 16 <= n; i += 16) {
+        __m128i block = _mm_loadu_si128((const __m128i*)(s + i));
+        count += __builtin_popcount(_mm_movemask_epi8(_mm_cmpeq_epi8(block, needle)));
+        if (count >= maxcount)
+            return maxcount;
+    }
+    return countCharScalar(s, n, c, maxcount, i, count);
+}
+
+__attribute__((target("avx2"))) Py_ssize_t findSubstringAVX2(const char* s, Py_ssize_t n, const char* p,
+                                                              Py_ssize_t m) {
+    const __m256i first = _mm256_set1_epi8(p[0]);
+    const __m256i last = _mm256_set1_epi8(p[m - 1]);
+
+    Py_ssize_t i = 0;
+    for (; i + m - 1 + 32 <= n; i += 32) {
+        __m256i block_first = _mm256_loadu_si256((const __m256i*)(s + i));
+        __m256i block_last = _mm256_loadu_si256((const __m256i*)(s + i + m - 1));
+        unsigned mask = _mm256_movemask_epi8(
+            _mm256_and_si256(_mm256_cmpeq_epi8(first, block_first), _mm256_cmpeq_epi8(last, block_last)));
+        while (mask) {
+            int bit = __builtin_ctz(mask);
+            if (memcmp(s + i + bit + 1, p + 1, m - 2) == 0)
+                return i + bit;
+            mask &= mask - 1;
+        }
+    }
+    return findSubstringScalar(s, n, p, m, i);
+}
+
+__attribute__((target("avx2,popcnt"))) Py_ssize_t countCharAVX2(const char* s, Py_ssize_t n, char c,
+                                                                 Py_ssize_t maxcount) {
+    const __m256i needle = _mm256_set1_epi8(c);
+    Py_ssize_t i = 0, count = 0;
+    for (; i + 32 <= n; i += 32) {
+        __m256i block = _mm256_loadu_si256((const __m256i*)(s + i));
+        count += __builtin_popcount(_mm256_movemask_epi8(_mm256_cmpeq_epi8(block, needle)));
+        if (count >= maxcount)
+            return maxcount;
+    }
+    return countCharScalar(s, n, c, maxcount, i, count);
+}
+
+struct SearchKernels {
+    Py_ssize_t (*find_substring)(const char*, Py_ssize_t, const char*, Py_ssize_t);
+    Py_ssize_t (*count_char)(const char*, Py_ssize_t, char, Py_ssize_t);
+
+    SearchKernels() : find_substring(findSubstringSSE2), count_char(countCharSSE2) {
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx2")) {
+            find_substring = findSubstringAVX2;
+            count_char = countCharAVX2;
+        }
+    }
+};
+#else
+Py_ssize_t findSubstringGeneric(const char* s, Py_ssize_t n, const char* p, Py_ssize_t m) {
+    return findSubstringScalar(s, n, p, m, 0);
+}
+
+Py_ssize_t countCharGeneric(const char* s, Py_ssize_t n, char c, Py_ssize_t maxcount) {
+    return countCharScalar(s, n, c, maxcount, 0, 0);
+}
+
+struct SearchKernels {
+    Py_ssize_t (*find_substring)(const char*, Py_ssize_t, const char*, Py_ssize_t) = findSubstringGeneric;
+    Py_ssize_t (*count_char)(const char*, Py_ssize_t, char, Py_ssize_t) = countCharGeneric;
+};
+#endif
+
+SearchKernels kernels;
+}
+
+extern "C" Py_ssize_t _PyString_FindChar(const char* s, Py_ssize_t n, char c) noexcept {
+    const char* r = (const char*)memchr(s, c, n);
+    return r ? r - s : -1;
+}
+
+extern "C" Py_ssize_t _PyString_RFindChar(const char* s, Py_ssize_t n, char c) noexcept {
+    const char* r = (const char*)memrchr(s, c, n);
+    return r ? r - s : -1;
+}
+
+extern "C" Py_ssize_t _PyString_CountChar(const char* s, Py_ssize_t n, char c, Py_ssize_t maxcount) noexcept {
+    if (maxcount < 0)
+        maxcount = PY_SSIZE_T_MAX;
+    else if (maxcount == 0)
+        return 0;
+    return kernels.count_char(s, n, c, maxcount);
+}
+
+extern "C" Py_ssize_t _PyString_FindSubstring(const char* s, Py_ssize_t n, const char* p, Py_ssize_t m) noexcept {
+    if (m == 0)
+        return 0;
+    if (m > n)
+        return -1;
+    if (m == 1)
+        return _PyString_FindChar(s, n, p[0]);
+    return kernels.find_substring(s, n, p, m);
+}
+
+extern "C" Py_ssize_t _PyString_SpanNonSpace(const char* s, Py_ssize_t n) noexcept {
+    Py_ssize_t i = 0;
+#ifdef __x86_64__
+    for (; i + 16 <= n; i += 16) {
+        unsigned mask = _mm_movemask_epi8(spaceMask(_mm_loadu_si128((const __m128i*)(s + i))));
+        if (mask)
+            return i + __builtin_ctz(mask);
+    }
+#endif
+    while (i < n && !isSpace(s[i]))
+        i++;
+    return i;
+}
+
+extern "C" Py_ssize_t _PyString_SpanSpace(const char* s, Py_ssize_t n) noexcept {
+    Py_ssize_t i = 0;
+#ifdef __x86_64__
+    for (; i + 16 <= n; i += 16) {
+        unsigned mask = ~_mm_movemask_epi8(spaceMask(_mm_loadu_si128((const __m128i*)(s + i)))) & 0xffff;
+        if (mask)
+            return i + __builtin_ctz(mask);
+    }
+#endif
+    while (i < n && isSpace(s[i]))
+        i++;
+    return i;
+}
+
+} // namespace pyston
@@ -29,12 +29,12 @@ namespace pyston {
 #if PyTuple_MAXSAVESIZE > 0
 BoxedTuple* BoxedTuple::free_list[PyTuple_MAXSAVESIZE];
 int BoxedTuple::numfree[PyTuple_MAXSAVESIZE];
+StatCounter BoxedTuple::freelist_hits("tuple_freelist_hits");
+StatCounter BoxedTuple::freelist_misses("tuple_freelist_misses");
+StatCounter BoxedTuple::freelist_saves("tuple_freelist_saves");
+StatCounter BoxedTuple::freelist_full("tuple_freelist_full");
 #endif
 
-extern "C" Box* createTuple(int64_t nelts, Box** elts) {
-    return BoxedTuple::create(nelts, elts);
-}
-
 Box* _tupleSlice(BoxedTuple* self, i64 start, i64 stop, i64 step, i64 length) {
     i64 size = self->size();
     assert(step != 0);
@@ -27,7 +27,7 @@ public:
     int pos;
     BoxedTupleIterator(BoxedTuple* t);
 
-    DEFAULT_CLASS_SIMPLE(tuple_iterator_cls, true);
+    DEFAULT_CLASS_SIMPLE_SLAB(tuple_iterator_cls, true);
 
     static void dealloc(BoxedTupleIterator* o) noexcept {
         PyObject_GC_UnTrack(o);
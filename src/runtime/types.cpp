@@ -3479,7 +3479,9 @@ static int object_set_class(PyObject* self, PyObject* value, void* closure) noex
     }
     if (compatible_for_assignment(newto, oldto, "__class__")) {
         Py_INCREF(newto);
+        _Py_DEC_LIVE(self);
         Py_TYPE(self) = newto;
+        _Py_INC_LIVE(self);
         Py_DECREF(oldto);
         return 0;
     } else {
@@ -3743,7 +3745,7 @@ void HiddenClass::dump() noexcept {
         else
             printf("Normal hcls:\n");
         printf("Attrwrapper offset: %d\n", getAsSingletonOrNormal()->attrwrapper_offset);
-        for (auto p : getAsSingletonOrNormal()->attr_offsets) {
+        for (auto p : getAsSingletonOrNormal()->getStrAttrOffsets()) {
             // printf("%d: %s\n", p.second, p.first->c_str());
             printf("%d: %p\n", p.second, p.first);
         }
@@ -3759,12 +3761,15 @@ void BoxedTuple::dealloc(PyTupleObject* op) noexcept {
         while (--i >= 0)
             Py_XDECREF(op->ob_item[i]);
 #if PyTuple_MAXSAVESIZE > 0
-        if (likely(len < PyTuple_MAXSAVESIZE && BoxedTuple::numfree[len] < PyTuple_MAXFREELIST
-                   && ((BoxedTuple*)op)->cls == tuple_cls)) {
-            op->ob_item[0] = (PyObject*)free_list[len];
-            numfree[len]++;
-            free_list[len] = (BoxedTuple*)op;
-            goto done; /* return */
+        if (likely(len < PyTuple_MAXSAVESIZE && ((BoxedTuple*)op)->cls == tuple_cls)) {
+            if (likely(BoxedTuple::numfree[len] < PyTuple_MAXFREELIST)) {
+                freelist_saves.log();
+                op->ob_item[0] = (PyObject*)free_list[len];
+                numfree[len]++;
+                free_list[len] = (BoxedTuple*)op;
+                goto done; /* return */
+            }
+            freelist_full.log();
         }
 #endif
     }
@@ -4107,6 +4112,12 @@ extern "C" PyObject* PyGC_RegisterStaticConstant(Box* b) noexcept {
     return b;
 }
 
+void makeImmortal(Box* b) {
+    if (b->cls->tp_flags & Py_TPFLAGS_HEAPTYPE)
+        return;
+    _Py_SetImmortal(b);
+}
+
 extern "C" void _PyUnicode_Fini(void);
 
 static int _check_and_flush(FILE* stream) {
@@ -4173,6 +4184,8 @@ struct _inittab _PyImport_Inittab[] = { { "array", initarray },
 
 bool TRACK_ALLOCATIONS = false;
 void setupRuntime() {
+    setupGMP();
+
     root_hcls = HiddenClass::makeRoot();
     HiddenClass::dict_backed = HiddenClass::makeDictBacked();
 
@@ -4210,6 +4223,7 @@ void setupRuntime() {
     none_cls = new (0)
         BoxedClass(object_cls, 0, 0, sizeof(Box), false, "NoneType", false, NULL, NULL, /* is_gc */ false);
     Py_None = new (none_cls) Box();
+    makeImmortal(Py_None);
     constants.push_back(Py_None);
     assert(Py_None->cls);
 
@@ -4249,6 +4263,7 @@ void setupRuntime() {
     tuple_cls->tp_itemsize = sizeof(Box*);
     tuple_cls->tp_mro = BoxedTuple::create({ tuple_cls, object_cls });
     EmptyTuple = BoxedTuple::create({});
+    makeImmortal(EmptyTuple);
     late_constants.push_back(EmptyTuple);
     list_cls = new (0) BoxedClass(object_cls, 0, 0, sizeof(BoxedList), false, "list", true, BoxedList::dealloc, NULL,
                                   true, BoxedList::traverse, BoxedList::clear);
@@ -4329,6 +4344,8 @@ void setupRuntime() {
 
     pyston_True = new BoxedBool(true);
     pyston_False = new BoxedBool(false);
+    makeImmortal(pyston_True);
+    makeImmortal(pyston_False);
     constants.push_back(pyston_True);
     constants.push_back(pyston_False);
 
@@ -4955,6 +4972,12 @@ extern "C" void Py_Finalize() noexcept {
         assert_refs = false;
     }
 
+    if (froze_heap) {
+        if (VERBOSITY())
+            fprintf(stderr, "[Heap was frozen, can't free the immortal objects]\n");
+        assert_refs = false;
+    }
+
     if (imported_foreign_cextension) {
         if (VERBOSITY() && _Py_RefTotal)
             fprintf(stderr, "[Leaked references but we did load foreign C extensions']\n");
@@ -23,10 +23,12 @@
 #include "structmember.h"
 
 #include "codegen/irgen/future.h"
+#include "core/compact_map.h"
 #include "core/contiguous_map.h"
 #include "core/from_llvm/DenseMap.h"
 #include "core/threading.h"
 #include "core/types.h"
+#include "runtime/slab.h"
 
 namespace pyston {
 
@@ -69,6 +71,11 @@ void setupImport();
 void setupAST();
 void setupSysEnd();
 
+// Set by __pyston__.freeze(): everything that was alive at that point is immortal, so teardown can't free it.
+extern bool froze_heap;
+// Dumps the per-type live object counts to stderr whenever the signal arrives.
+void installTypeStatsSignalHandler(int sig);
+
 BORROWED(BoxedDict*) getSysModulesDict();
 BORROWED(BoxedList*) getSysPath();
 
@@ -201,6 +208,12 @@ public:
     // (But having nonzero attrs_offset here would map to having nonzero tp_dictoffset in CPython)
     int attrs_offset;
 
+    // The number of attribute slots that instances reserve directly after their HCAttrs.  Objects whose hidden
+    // class has at most this many slots keep their attr_list pointed at that inline storage, which saves
+    // allocating a separate attributes array and lets ICs skip the load of attr_list.
+    // Only classes that add hcattrs at a positive attrs_offset (ie most Python-defined classes) have inline slots.
+    int num_inline_attrs;
+
     bool instancesHaveHCAttrs() { return attrs_offset != 0; }
     bool instancesHaveDictAttrs() { return tp_dictoffset != 0; }
 
@@ -241,6 +254,9 @@ public:
     ExceptionSwitchableFunction<Box*, Box*, CallRewriteArgs*, ArgPassSpec, Box*, Box*, Box*, Box**,
                                 const std::vector<BoxedString*>*> tpp_call;
 
+    // Created by the first Box::newSlab() for this class.
+    SlabAllocator* slab_allocator;
+
     bool hasGenericGetattr() {
         if (tp_getattr || tp_getattro != object_cls->tp_getattro)
             return false;
@@ -317,6 +333,33 @@ template <bool is_gc> void* Box::newFast(size_t size, BoxedClass* cls) {
     /* TODO: there should be a way to not have to do this nested inlining by hand */
 }
 
+template <bool is_gc> void* Box::newSlab(size_t size, BoxedClass* cls) {
+#ifdef PYMALLOC_DEBUG
+    // The debug allocator's PyObject_Free expects its own padding around every block.
+    return newFast<is_gc>(size, cls);
+#else
+    ALLOC_STATS(cls);
+    assert(cls->tp_alloc == PyType_GenericAlloc);
+    assert(cls->tp_itemsize == 0);
+    assert(cls->tp_basicsize == size);
+    assert(cls->is_pyston_class);
+    assert(cls->attrs_offset == 0);
+    assert(is_gc == PyType_IS_GC(cls));
+    assert(!(cls->tp_flags & Py_TPFLAGS_HEAPTYPE));
+    assert(cls != type_cls);
+
+    if (unlikely(!cls->slab_allocator))
+        cls->slab_allocator = new SlabAllocator(cls, is_gc ? sizeof(PyGC_Head) + size : size);
+    void* mem = cls->slab_allocator->alloc();
+
+    Box* rtn = static_cast<Box*>(is_gc ? _PyObject_GC_Init(mem) : mem);
+    PyObject_INIT(rtn, cls);
+    if (is_gc)
+        _PyObject_GC_TRACK(rtn);
+    return rtn;
+#endif
+}
+
 // Corresponds to PyHeapTypeObject.  Very similar to BoxedClass, but allocates some extra space for
 // structures that otherwise might get allocated statically.  For instance, tp_as_number for builtin
 // types will usually point to a `static PyNumberMethods` object, but for a heap-allocated class it
@@ -331,8 +374,18 @@ public:
     BoxedString* ht_name;
     PyObject* ht_slots;
 
+    // How many attributes we expect instances to end up with, learned from instances that had to grow their
+    // attributes array.  New instances get an array of this size as soon as they need an out-of-line one.
+    // The estimate is lowered again if instances keep getting freed with substantially fewer attributes.
+    int attrs_presize;
+    int attrs_presize_overshoots;
+    int attrs_presize_window_max;
+
     size_t nslots() { return this->ob_size; }
 
+    // Called when an instance is deallocated, to check whether attrs_presize is an overestimate.
+    void noteFinalAttrCount(int nattrs);
+
     // These functions are the preferred way to construct new types:
     static BoxedHeapClass* create(BoxedClass* metatype, BoxedClass* base, int attrs_offset, int weaklist_offset,
                                   int instance_size, bool is_user_defined, BoxedString* name, BoxedTuple* bases,
@@ -673,6 +726,8 @@ static_assert(offsetof(BoxedString, interned_state) == offsetof(PyStringObject,
 static_assert(offsetof(BoxedString, s_data) == offsetof(PyStringObject, ob_sval), "");
 
 size_t strHashUnboxedStrRef(llvm::StringRef str);
+// Appends rhs to lhs, which the caller must hold the only reference to, reusing lhs's memory.
+BoxedString* strAppendInPlace(STOLEN(BoxedString*) lhs, BoxedString* rhs);
 extern "C" size_t strHashUnboxed(BoxedString* self);
 extern "C" int64_t hashUnboxed(Box* obj);
 
@@ -690,7 +745,7 @@ public:
         Py_XINCREF(im_class);
     }
 
-    DEFAULT_CLASS_SIMPLE(instancemethod_cls, true);
+    DEFAULT_CLASS_SIMPLE_SLAB(instancemethod_cls, true);
 
     static void dealloc(Box* self) noexcept;
     static int traverse(Box* self, visitproc visit, void* arg) noexcept;
@@ -763,14 +818,23 @@ static_assert(offsetof(BoxedList, elts) == offsetof(PyListObject, ob_item), "");
 static_assert(offsetof(GCdArray, elts) == 0, "");
 static_assert(offsetof(BoxedList, allocated) == offsetof(PyListObject, allocated), "");
 
-#define PyTuple_MAXSAVESIZE 20   /* Largest tuple to save on free list */
+// Both of these can be overridden at build time, eg -DPyTuple_MAXFREELIST=0 to disable the free lists.
+#ifndef PyTuple_MAXSAVESIZE
+#define PyTuple_MAXSAVESIZE 20 /* Largest tuple to save on free list */
+#endif
+#ifndef PyTuple_MAXFREELIST
 #define PyTuple_MAXFREELIST 2000 /* Maximum number of tuples of each size to save */
+#endif
 extern "C" int PyTuple_ClearFreeList() noexcept;
 class BoxedTuple : public BoxVar {
 private:
 #if PyTuple_MAXSAVESIZE > 0
     static BoxedTuple* free_list[PyTuple_MAXSAVESIZE];
     static int numfree[PyTuple_MAXSAVESIZE];
+
+    // How well the free lists work: allocations served from / missed by a free list, and
+    // deallocations that went onto a free list / found it full.
+    static StatCounter freelist_hits, freelist_misses, freelist_saves, freelist_full;
 #endif
 
 public:
@@ -923,6 +987,7 @@ public:
         BoxedTuple* op = NULL;
 #if PyTuple_MAXSAVESIZE > 0
         if (likely(nitems < PyTuple_MAXSAVESIZE && (op = free_list[nitems]) != NULL)) {
+            freelist_hits.log();
             free_list[nitems] = (BoxedTuple*)op->elts[0];
             numfree[nitems]--;
 /* Inline PyObject_InitVar */
@@ -934,6 +999,10 @@ public:
         } else
 #endif
         {
+#if PyTuple_MAXSAVESIZE > 0
+            if (nitems < PyTuple_MAXSAVESIZE)
+                freelist_misses.log();
+#endif
             Py_ssize_t nbytes = nitems * sizeof(PyObject*);
             /* Check for overflow */
             if (unlikely(nbytes / sizeof(PyObject*) != (size_t)nitems
@@ -1039,6 +1108,22 @@ struct BoxAndHash {
         static BoxAndHash getEmptyKey() { return BoxAndHash((Box*)-1, 0); }
         static BoxAndHash getTombstoneKey() { return BoxAndHash((Box*)-2, 0); }
         static size_t getHashValue(BoxAndHash val) { return val.hash; }
+
+        // Used by CompactMap for dicts whose keys are all exact strs, similar to CPython's lookdict_string:
+        // comparing two strs can't run any Python code, so we can skip PyEq.
+        static bool isFastKey(BoxAndHash val) { return val.value->cls == str_cls; }
+        static bool isEqualFast(BoxAndHash lhs, BoxAndHash rhs) {
+            if (lhs.value == rhs.value)
+                return true;
+            if (lhs.hash != rhs.hash)
+                return false;
+            BoxedString* l = static_cast<BoxedString*>(lhs.value);
+            BoxedString* r = static_cast<BoxedString*>(rhs.value);
+            // Two different interned strings can't be equal:
+            if (l->interned_state != SSTATE_NOT_INTERNED && r->interned_state != SSTATE_NOT_INTERNED)
+                return false;
+            return l->size() == r->size() && memcmp(l->data(), r->data(), l->size()) == 0;
+        }
     };
 };
 // Similar to the incref(Box*) function:
@@ -1049,8 +1134,7 @@ inline BoxAndHash& incref(BoxAndHash& b) {
 
 class BoxedDict : public Box {
 public:
-    typedef pyston::DenseMap<BoxAndHash, Box*, BoxAndHash::Comparisons, detail::DenseMapPair<BoxAndHash, Box*>,
-                             /* MinSize= */ 8> DictMap;
+    typedef pyston::CompactMap<BoxAndHash, Box*, BoxAndHash::Comparisons, /* MinSize= */ 8> DictMap;
 
     DictMap d;
 
@@ -1359,7 +1443,7 @@ public:
 
     static void dealloc(Box* b) noexcept;
 
-    DEFAULT_CLASS_SIMPLE(slice_cls, false);
+    DEFAULT_CLASS_SIMPLE_SLAB(slice_cls, false);
 };
 static_assert(sizeof(BoxedSlice) == sizeof(PySliceObject), "");
 static_assert(offsetof(BoxedSlice, start) == offsetof(PySliceObject, start), "");
@@ -1469,7 +1553,7 @@ public:
 
     BoxedGenerator(BoxedFunctionBase* function, Box* arg1, Box* arg2, Box* arg3, Box** args);
 
-    DEFAULT_CLASS_SIMPLE(generator_cls, true);
+    DEFAULT_CLASS_SIMPLE_SLAB(generator_cls, true);
 };
 
 
@@ -0,0 +1,41 @@
+# Instances get their attribute arrays presized based on how many attributes earlier instances of the
+# same class ended up with; make sure that instances which differ from that estimate still work.
+
+class C(object):
+    def __init__(self, n):
+        for i in xrange(n):
+            setattr(self, "a%d" % i, i)
+
+def check(o, n):
+    assert len(o.__dict__) == n, (len(o.__dict__), n)
+    for i in xrange(n):
+        assert getattr(o, "a%d" % i) == i
+
+# Grow the estimate, then shrink it again by freeing lots of small instances.
+for n in [20, 3, 9, 0, 17, 1, 40]:
+    l = [C(n) for i in xrange(100)]
+    for o in l:
+        check(o, n)
+    l.append(C(n + 5))
+    check(l[-1], n + 5)
+
+# Instances that start out like big ones but then lose attributes:
+l = []
+for i in xrange(200):
+    o = C(16)
+    for j in xrange(i % 16):
+        delattr(o, "a%d" % (15 - j))
+    o.extra = i
+    l.append(o)
+print sum(len(o.__dict__) for o in l), sum(o.extra for o in l)
+
+class D(C):
+    pass
+
+for i in xrange(100):
+    o = D(i % 25)
+    check(o, i % 25)
+    o.__class__ = C
+    o.z = 1
+    check(o, i % 25)
+print "done"
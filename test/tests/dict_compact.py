@@ -0,0 +1,50 @@
+# Dicts store their entries densely with a separate index table; exercise growing, shrinking,
+# lots of deletions (which leave deleted entries behind until the next resize) and the C API iteration.
+import random
+
+random.seed(42)
+d = {}
+ref = []
+for i in xrange(20000):
+    k = random.randrange(500)
+    op = random.randrange(3)
+    if op < 2:
+        d[k] = i
+    elif k in d:
+        del d[k]
+assert len(d) == len(d.keys()) == len(d.values()) == len(list(d.iteritems()))
+for k, v in d.items():
+    assert d[k] == v
+print len(d), sum(d), sum(d.values())
+
+# Delete everything and re-add it, so the table gets compacted:
+keys = d.keys()
+for k in keys:
+    del d[k]
+print len(d), d
+for k in keys:
+    d[k] = -k
+print len(d), sum(d.values()) == -sum(keys)
+
+# Keys with equal hashes but different identities:
+class K(object):
+    def __init__(self, n):
+        self.n = n
+    def __hash__(self):
+        return self.n % 7
+    def __eq__(self, other):
+        return isinstance(other, K) and self.n == other.n
+
+d = {}
+for i in xrange(100):
+    d[K(i)] = i
+for i in xrange(0, 100, 2):
+    del d[K(i)]
+print len(d), sorted(d.values())[:5], K(3) in d, K(4) in d
+
+# These go through PyDict_Next:
+d = dict((str(i), i) for i in xrange(50))
+for i in xrange(0, 50, 3):
+    del d[str(i)]
+print sorted(set(d)) == sorted(d.keys()), "{1}-{2}".format(**d)
+print dict(d) == d, cmp(d, dict(d)), cmp({1: 2}, {1: 3}), cmp({1: 2}, {2: 2})
@@ -0,0 +1,67 @@
+# iteritems() refills its result tuple when nobody else kept a reference to it; make sure that's
+# never visible from Python code.
+
+import gc
+
+d = dict((i, str(i)) for i in range(20))
+
+# Kept references must not change under us
+kept = []
+for t in d.iteritems():
+    kept.append(t)
+print sorted(kept) == sorted(d.items()), len(set(map(id, kept))) == len(kept)
+
+print sorted(d.iteritems())[:3], sorted(list(d.iteritems()))[-3:]
+print sorted(zip(d.iteritems(), d.iteritems()))[:2]
+
+# Unpacked tuples can be reused, but the values have to be right
+total = 0
+for k, v in d.iteritems():
+    assert str(k) == v
+    total += k
+print total
+
+# Only keep every other one
+it = d.iteritems()
+every_other = []
+for i, t in enumerate(it):
+    if i % 2 == 0:
+        every_other.append(t)
+print sorted(every_other)[:4], len(every_other)
+
+# The reused tuple can go from holding only atomic objects (which lets the collector stop
+# tracking it) to holding containers:
+d2 = {1: 2, 3: [4], 5: {6: 7}}
+for k, v in sorted(d2.iteritems()):
+    gc.collect()
+    print k, v
+
+# Cycles through the values of a dict being iterated
+class C(object):
+    pass
+
+d3 = {}
+for i in range(10):
+    c = C()
+    c.d = d3
+    d3[i] = c
+it = d3.iteritems()
+next(it)
+del d3, it, c
+print gc.collect() > 0
+
+# Values whose destructors run while we are in the middle of iterating
+class Del(object):
+    def __init__(self, n):
+        self.n = n
+    def __del__(self):
+        print "del", self.n
+
+d4 = {}
+for i in range(3):
+    d4[i] = Del(i)
+for k, v in d4.iteritems():
+    print k, v.n
+    d4[k] = None
+    del v
+print sorted(d4.items())
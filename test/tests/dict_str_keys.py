@@ -0,0 +1,55 @@
+# Dicts with only str keys use a specialized lookup; make sure it switches back to the general one
+# when other kinds of keys show up.
+
+d = {}
+for i in xrange(100):
+    d["k" + str(i)] = i
+
+# Equal strings that aren't the same object:
+print d["k" + "5"], d["".join(["k", "50"])], "k100" in d
+
+# unicode and str subclasses compare equal to strs, but take the general path:
+class S(str):
+    pass
+print d[u"k7"], d[S("k8")], S("k9") in d, u"k1000" in d
+
+# Inserting non-str keys:
+d[1] = "one"
+d[u"k3"] = "unicode"
+d[S("k4")] = "subclass"
+print d["k3"], d["k4"], d[1], len(d)
+
+# Keys whose __eq__ raises still raise once the dict isn't all-str anymore:
+class BadEq(object):
+    def __hash__(self):
+        return hash("k10")
+    def __eq__(self, other):
+        raise ValueError("bad eq")
+d2 = {}
+d2[BadEq()] = 2
+try:
+    d2["k10"]
+    print "didn't raise?"
+except ValueError as e:
+    print e
+
+# Deleting the non-str keys and growing the dict lets it go back to the fast lookup:
+for k in [1, u"k3", S("k4")]:
+    del d[k]
+for i in xrange(100, 1000):
+    d["k" + str(i)] = i
+print len(d), "k3" in d, d["k2"], d["k999"]
+
+def f(d, keys):
+    t = 0
+    for k in keys:
+        try:
+            t += d[k]
+        except KeyError:
+            t -= 1
+    return t
+keys = ["k" + str(i) for i in xrange(0, 2000, 7)]
+for i in xrange(3):
+    print f(d, keys)
+d[None] = 0
+print f(d, keys)
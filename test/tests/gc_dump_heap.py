@@ -0,0 +1,57 @@
+# Heap snapshots: the objects reachable from a module show up with their types, sizes and
+# references, and the module is listed as a root.
+import gc
+import os
+import struct
+import tempfile
+
+class Marker(object):
+    pass
+
+holder = [Marker() for i in xrange(10)]
+holder.append("a string that only the holder refers to " * 10)
+
+def read_snapshot(fn):
+    f = open(fn, "rb")
+    assert f.read(8) == "PYHEAP01"
+
+    def read(fmt):
+        return struct.unpack(fmt, f.read(struct.calcsize(fmt)))
+
+    type_names, roots, objects = {}, {}, {}
+    while True:
+        tag = f.read(1)
+        if tag == "T":
+            tid, n = read("=QI")
+            type_names[tid] = f.read(n)
+        elif tag == "R":
+            kind, oid, n = read("=BQI")
+            roots[f.read(n)] = oid
+        elif tag == "O":
+            oid, tid, size, nrefs = read("=QQQI")
+            objects[oid] = (tid, size, read("=%dQ" % nrefs))
+        else:
+            assert tag == "E", tag
+            n, = read("=Q")
+            assert n >= len(objects)
+            return type_names, roots, objects
+
+if hasattr(gc, "dump_heap"):
+    fd, fn = tempfile.mkstemp()
+    os.close(fd)
+    try:
+        n = gc.dump_heap(fn)
+        type_names, roots, objects = read_snapshot(fn)
+    finally:
+        os.unlink(fn)
+    assert n > 0
+
+    assert roots["__main__"] == id(__import__("__main__"))
+    tid, size, refs = objects[id(holder)]
+    assert type_names[tid] == "list"
+    assert set(refs) == set(id(x) for x in holder), refs
+    for m in holder[:10]:
+        assert type_names[objects[id(m)][0]] == "Marker"
+    tid, size, refs = objects[id(holder[-1])]
+    assert type_names[tid] == "str" and size > len(holder[-1]) and refs == ()
+print "ok"
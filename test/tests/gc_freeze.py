@@ -0,0 +1,72 @@
+# Freezing the heap before forking workers: frozen objects are skipped by collections and, except
+# for instances of heap types, become immortal, but keep behaving normally in the parent and in the
+# children.
+import gc
+import os
+import sys
+import weakref
+
+try:
+    import __pyston__
+except ImportError:
+    __pyston__ = None
+
+class Node(object):
+    def __init__(self, n):
+        self.n = n
+        self.next = None
+
+shared = {"nodes": [Node(i) for i in xrange(100)], "name": "shared " * 3, "big": 2 ** 100}
+frozen_cycle = Node(-1)
+frozen_cycle.next = frozen_cycle
+
+if __pyston__:
+    assert __pyston__.freeze() > 0
+    assert gc.get_freeze_count() > 0
+    before = sys.getrefcount(shared)
+    l = [shared] * 1000
+    del l
+    assert sys.getrefcount(shared) == before
+    # Instances of heap types stay mortal
+    node = shared["nodes"][0]
+    before = sys.getrefcount(node)
+    l = [node] * 10
+    assert sys.getrefcount(node) == before + 10
+    del l, node
+
+# Objects created after the freeze are collected as usual
+c = Node(-2)
+c.next = c
+wr = weakref.ref(c)
+del c
+gc.collect()
+print "collected", wr() is None
+
+del frozen_cycle
+gc.collect()
+
+def work():
+    total = 0
+    for node in shared["nodes"]:
+        node.n += 1
+        total += node.n
+    shared["extra"] = [total]
+    return total, len(shared["name"]), shared["big"] % 1000
+
+for i in xrange(3):
+    pid = os.fork()
+    if pid == 0:
+        r = work()
+        gc.collect()
+        os._exit(0 if r == (5050, 21, 376) else 1)
+    _, status = os.waitpid(pid, 0)
+    print "worker", i, os.WIFEXITED(status), os.WEXITSTATUS(status)
+
+print work()
+print shared["extra"], shared["nodes"][0].n
+
+if hasattr(gc, "freeze"):
+    gc.freeze()
+    assert gc.get_freeze_count() > 0
+    gc.unfreeze()
+    assert gc.get_freeze_count() == 0
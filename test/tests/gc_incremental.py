@@ -0,0 +1,101 @@
+# Incremental collection of the oldest generation: garbage cycles that made it there are found by
+# allocation-triggered slices or the occasional full collection, and live structures that span
+# many slices are left alone.
+import gc
+import weakref
+
+class Node(object):
+    def __init__(self, n):
+        self.n = n
+        self.next = None
+
+incremental = hasattr(gc, "set_incremental")
+if incremental:
+    gc.set_incremental(True, 200)
+    assert gc.get_incremental() == (True, 200)
+    gc.get_pause_histogram(True)
+
+# A long live ring, and many small garbage cycles
+ring = Node(0)
+cur = ring
+for i in xrange(1, 20000):
+    cur.next = Node(i)
+    cur = cur.next
+cur.next = ring
+
+garbage = []
+for i in xrange(2000):
+    a = Node(i)
+    b = Node(-i)
+    a.next = b
+    b.next = [a, {"x": a}]
+    garbage.append(weakref.ref(a))
+del a, b
+
+# Move everything into the oldest generation
+gc.collect(1)
+gc.collect(1)
+
+def alive():
+    return sum(1 for r in garbage if r() is not None)
+
+for i in xrange(500):
+    for j in xrange(10000):
+        [j]
+    if alive() == 0:
+        break
+
+if incremental:
+    assert alive() == 0, alive()
+    slices = gc.get_pause_histogram()[3]
+    assert sum(slices) > 0, slices
+
+# A garbage cycle too big for any slice still gets freed without calling gc.collect(), by the full
+# collections that take the place of some of the incremental passes.  Keeping some of what we
+# allocate alive makes objects get promoted, like in a long-running program, so passes keep starting.
+big = Node(0)
+cur = big
+for i in xrange(1, 50000):
+    cur.next = Node(i)
+    cur = cur.next
+cur.next = big
+big_ref = weakref.ref(big)
+del big, cur
+
+keep = []
+for i in xrange(5000):
+    keep.append([[j] for j in xrange(100)])
+    for j in xrange(2000):
+        [j]
+    if big_ref() is None:
+        break
+print big_ref() is None
+del keep
+
+gc.collect()
+print alive()
+
+total = 0
+n = 0
+cur = ring
+while True:
+    total += cur.n
+    n += 1
+    cur = cur.next
+    if cur is ring:
+        break
+print n, total
+
+# Dropping the ring makes it garbage too; it's too big for one slice, but gc.collect() finds it.
+r = weakref.ref(ring)
+del ring, cur
+gc.collect()
+print r() is None
+
+if incremental:
+    gc.set_incremental(False)
+    assert gc.get_incremental()[0] is False
+    hist = gc.get_pause_histogram()
+    print len(hist), len(hist[0])
+else:
+    print 4, 24
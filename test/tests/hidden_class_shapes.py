@@ -0,0 +1,39 @@
+# Exercise lots of different attribute orderings, so that we create deep and wide hidden class trees,
+# and make sure attribute lookup, deletion and iteration agree with each other.
+import random
+
+class C(object):
+    pass
+
+random.seed(12345)
+names = ["attr%d" % i for i in xrange(30)]
+objs = []
+for i in xrange(300):
+    o = C()
+    order = names[:]
+    random.shuffle(order)
+    for n in order[:i % 30]:
+        setattr(o, n, n)
+    objs.append((o, order[:i % 30]))
+
+for o, order in objs:
+    assert sorted(o.__dict__.keys()) == sorted(order), (o.__dict__.keys(), order)
+    for n in order:
+        assert getattr(o, n) == n
+    if order:
+        victim = order[len(order) // 2]
+        delattr(o, victim)
+        order.remove(victim)
+        assert sorted(o.__dict__.keys()) == sorted(order)
+        assert not hasattr(o, victim)
+        for n in order:
+            assert getattr(o, n) == n
+
+# Lots of lookups on a single deep shape:
+o = C()
+for n in names:
+    setattr(o, n, len(n))
+t = 0
+for i in xrange(1000):
+    t += getattr(o, names[i % 30])
+print t, len(o.__dict__), sorted(o.__dict__.items())[:3]
@@ -0,0 +1,51 @@
+# None, True/False, small ints, identifier strings and () are immortal: dropping references to them
+# must never free them, and everything else, including strings passed to intern(), has to keep its
+# normal refcounting.
+import sys
+
+def churn(n):
+    l = []
+    for i in xrange(n):
+        l.append(None)
+        l.append(True)
+        l.append(i % 200 - 5)
+        l.append("abc")
+        l.append(())
+        l.append(NotImplemented)
+        l.append(Ellipsis)
+    del l[:]
+    return l
+
+for i in xrange(50):
+    churn(1000)
+
+print None, True, False, 5, "abc", (), NotImplemented, Ellipsis
+print sum(1 for x in xrange(100000) if (x % 3 == 0) is True), [i for i in range(-5, 5)]
+
+s = intern("immortal_" + str(12345))
+t = intern("immortal_12345")
+print s is t, s
+del s, t
+print intern("immortal_12345")
+
+s = intern("mortal_" + str(12345))
+base = sys.getrefcount(s)
+refs = [s] * 10
+print sys.getrefcount(s) - base
+del refs
+print sys.getrefcount(s) - base
+
+class C(object):
+    pass
+c = C()
+base = sys.getrefcount(c)
+refs = [c] * 10
+print sys.getrefcount(c) - base
+del refs
+print sys.getrefcount(c) - base
+
+def f(x=None, y=True, z=()):
+    return x, y, z
+for i in xrange(10000):
+    r = f()
+print r, f(1, 2, 3)
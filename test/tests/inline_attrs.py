@@ -0,0 +1,62 @@
+# Instances of Python classes store their first few attributes inline; make sure objects that
+# move between the inline and out-of-line representations keep their attributes.
+
+class C(object):
+    pass
+
+class D(C):
+    pass
+
+class E(object):
+    pass
+
+def grow(o, n):
+    for i in xrange(n):
+        setattr(o, "a%d" % i, i)
+
+def total(o):
+    return sum(getattr(o, k) for k in sorted(o.__dict__))
+
+def f(o):
+    o.x = 1
+    o.y = 2
+    o.z = 3
+    o.w = 4
+    o.v = 5
+    return o.x + o.y + o.z + o.w + o.v
+
+for i in xrange(1000):
+    o = C() if i % 2 else D()
+    assert f(o) == 15
+
+    grow(o, i % 12)
+    del o.v
+    if i % 3 == 0:
+        del o.x
+    o.v = i
+    assert o.v == i
+
+    if i % 5 == 0:
+        o.__class__ = D if o.__class__ is C else C
+
+print sum(f(C()) for i in xrange(100))
+
+for n in [0, 1, 3, 4, 5, 8, 9, 20]:
+    o = C()
+    grow(o, n)
+    print n, total(o), len(o.__dict__)
+    for i in xrange(n):
+        delattr(o, "a%d" % i)
+        if i % 2:
+            setattr(o, "b%d" % i, i)
+    print sorted(o.__dict__.items())
+
+o = C()
+grow(o, 6)
+o.__dict__[1] = 2
+print sorted(o.__dict__.items())
+
+o = E()
+grow(o, 3)
+o.__dict__ = {"q": 5}
+print o.q, hasattr(o, "a0")
@@ -0,0 +1,51 @@
+# Line numbers of frames and tracebacks, in code whose blocks aren't laid out in source order
+# (loops, try/finally, comprehensions) and with large jumps between lines.
+import sys
+import traceback
+
+def f():
+    lines = []
+    for i in range(3):
+        if i == 1:
+            lines.append(sys._getframe().f_lineno)
+            continue
+        while i < 10:
+            i += 5
+        lines.append(sys._getframe().f_lineno)
+    try:
+        lines.append(sys._getframe().f_lineno)
+    finally:
+        lines.append(sys._getframe().f_lineno)
+    lines += [sys._getframe().f_lineno for _ in range(2)]
+    return lines
+
+print f()
+
+def g(n):
+    if n == 0:
+        raise ValueError(n)
+    x = [n
+         for _ in range(1)]
+    return g(n - 1)
+
+try:
+    g(3)
+except ValueError:
+    print [(e[2], e[1]) for e in traceback.extract_tb(sys.exc_info()[2])]
+
+# Big line deltas in both directions
+src = "def far(n):\n" + "\n" * 300 + "    while n:\n" + "\n" * 5000 + "        n -= 1\n" + "    return 1 + None\n"
+exec src
+try:
+    far(2)
+except TypeError:
+    print traceback.extract_tb(sys.exc_info()[2])[-1][1]
+
+def gen():
+    yield sys._getframe().f_lineno
+    for i in range(2):
+
+        yield sys._getframe().f_lineno
+    yield sys._getframe().f_lineno
+
+print list(gen())
@@ -0,0 +1,63 @@
+# Searching and summing lists of numbers, which compare and add exact ints and floats unboxed,
+# mixed with values that have to go through the generic paths.
+
+nan = float('nan')
+l = [1, 2.0, 3, 2 ** 70, True, nan, -0.0, 5L]
+
+for x in (1, 1.0, 2, 2.0, 3, 3L, 2 ** 70, True, False, nan, 0.0, 0, 5, 5.0, "1", None):
+    print repr(x), x in l, l.count(x),
+    try:
+        print l.index(x)
+    except ValueError as e:
+        print e
+
+# The same nan object is found by identity, another nan is not equal to anything
+print nan in l, float('nan') in l, [nan] == [nan], [float('nan')] == [float('nan')]
+print [1, 2.0] == [1.0, 2], [1, 2] < [1, 3], [1.5] > [1], [1, 2] == [1, 2L]
+
+class Eq(object):
+    def __init__(self, n):
+        self.n = n
+    def __eq__(self, other):
+        print "__eq__", self.n, other
+        return self.n == other
+
+print Eq(3) in [1, 2, 3, 4]
+print [1, 2, 3].count(Eq(2))
+print [1, 2, 3].index(Eq(3))
+l = [1, 2, 3]
+l.remove(Eq(2))
+print l
+
+# __eq__ that shrinks the list being searched
+class Shrink(object):
+    def __eq__(self, other):
+        del big[:]
+        return False
+big = range(10) + [Shrink()] + range(10)
+print big.count(Shrink()), len(big)
+
+print sum([]), sum([], 5), sum([], 2.5)
+print sum(range(100)), sum(range(100), 0.5)
+print sum([1.5, 2, 3.25]), sum([1, 2, 3.5]), sum([1, 2.5, 3]), sum([0.1] * 10)
+print repr(sum([2 ** 62, 2 ** 62])), repr(sum([2 ** 62, 2 ** 62, 1.0])), repr(sum([2 ** 70, 1, 2.5]))
+print repr(sum([1, True, 2])), repr(sum([True, True])), repr(sum([1.0, True]))
+print repr(sum([-(2 ** 63) + 1, -1, -1])), repr(sum([1, 2], 10L)), repr(sum([1.0, 2L, 3]))
+print repr(sum([1e308, 1e308, -1e308])), repr(sum([nan, 1]))
+print sum([[1], [2]], []), sum(((1,), (2,)), ())
+print sum(x * 0.5 for x in xrange(10)), sum(iter([1, 2, 3]))
+
+class MyInt(int):
+    def __add__(self, other):
+        return 100
+    __radd__ = __add__
+print sum([1, MyInt(2), 3]), sum([1.5, MyInt(2)])
+
+try:
+    sum([1, 2, "3"])
+except TypeError as e:
+    print e
+try:
+    sum([1.5, "3"])
+except TypeError as e:
+    print e
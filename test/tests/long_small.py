@@ -0,0 +1,49 @@
+# Arithmetic on longs around the limits of the inline (128-bit) storage and of the single-limb fast paths.
+
+vals = [0, 1, -1, 7, -7, 2 ** 31, 2 ** 62, 2 ** 63 - 1, 2 ** 63, 2 ** 64 - 1, 2 ** 64, 2 ** 65 + 3,
+        2 ** 127 - 1, 2 ** 127, 2 ** 128 - 1, 2 ** 128, 2 ** 200 + 12345, 3 ** 50]
+vals = [long(v) for v in vals] + [-long(v) for v in vals if v]
+ints = [0, 1, -1, 3, -3, 2 ** 62, -(2 ** 63), 2 ** 63 - 1]
+
+def show(label, f):
+    total = 0
+    for i, x in enumerate(vals):
+        for j, y in enumerate(vals + ints):
+            try:
+                r = f(x, y)
+            except ZeroDivisionError:
+                r = "zde"
+            for c in str(r):
+                total = (total * 31 + ord(c)) % 1000000007
+    print label, total
+
+show("add", lambda x, y: x + y)
+show("sub", lambda x, y: x - y)
+show("rsub", lambda x, y: y - x)
+show("mul", lambda x, y: x * y)
+show("div", lambda x, y: x // y)
+show("mod", lambda x, y: x % y)
+show("divmod", lambda x, y: divmod(x, y))
+show("cmp", lambda x, y: (x < y, x <= y, x == y, x != y, x > y, x >= y))
+
+for v in vals:
+    print repr(v), hash(v), hash(v) == hash(int(v)) if -2 ** 63 <= v < 2 ** 63 else "", type(v * 1), type(v // 1)
+
+print divmod(-(2 ** 63) + 1, -1L), divmod(2 ** 63 - 1, -(2 ** 63)), (-(2 ** 63 - 1)) * (2 ** 63 - 1)
+
+# Values that start small and then outgrow the inline storage
+x = 1L
+for i in xrange(300):
+    x = x * 3 + i
+print x % 1000003, len(str(x))
+for i in xrange(300):
+    x = x // 3
+print x
+
+class L(long):
+    pass
+print L(5) + 3, type(L(5) + 3), L(2 ** 64) * L(2), divmod(L(-7), 2), hash(L(-1))
+d = {}
+for v in vals:
+    d[v] = 1
+print sorted(d) == sorted(set(vals)), 2 ** 64 in d, (2 ** 64) + 0.0 in d
@@ -0,0 +1,36 @@
+# Exercises IC paths that the rewriter's redundancy elimination touches (repeated loads of the same
+# attribute around stores, repeated guards on the same object), with the optimization on and off.
+try:
+    import __pyston__
+    options = [1, 0]
+except ImportError:
+    __pyston__ = None
+    options = [1]
+
+class C(object):
+    def __init__(self, n):
+        self.a = n
+        self.b = n * 2
+
+class D(C):
+    pass
+
+def f(o):
+    t = o.a + o.a
+    o.a = o.b
+    t += o.a + o.a
+    o.b = t
+    return t + o.b
+
+for opt in options:
+    if __pyston__:
+        __pyston__.setOption("ENABLE_REWRITER_PEEPHOLE", opt)
+
+    total = 0
+    for i in xrange(2000):
+        o = C(i) if i % 3 else D(i)
+        total += f(o)
+        if i % 7 == 0:
+            o.c = i
+            total += o.c + o.c
+    print total
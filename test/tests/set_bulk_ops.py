@@ -0,0 +1,113 @@
+# Set algebra where the other operand is a set, frozenset, dict or plain iterable, including
+# aliasing (s op s) and results that need their tables resized.
+
+def sorted(s):
+    l = list(s)
+    l.sort()
+    return l
+
+class MySet(set):
+    pass
+
+class MyFrozenSet(frozenset):
+    pass
+
+small = set(range(0, 10))
+big = set(range(5, 500))
+others = [lambda: big, lambda: frozenset(big), lambda: MySet(big), lambda: dict.fromkeys(big), lambda: list(big),
+          lambda: iter(big)]
+
+for make in (set, frozenset, MySet, MyFrozenSet):
+    print make.__name__
+    for other in others:
+        s = make(small)
+        print " ", type(other()).__name__,
+        print len(s.union(other())),
+        print sorted(s.intersection(other())),
+        print sorted(s.difference(other())),
+        print sorted(s.symmetric_difference(other()))[:15],
+        print s.isdisjoint(other()),
+        print s.issubset(other())
+
+    s = make(small)
+    b = make(big)
+    for r in (s | b, s & b, s - b, s ^ b, b | s, b & s, b - s, b ^ s):
+        print type(r).__name__, len(r), sorted(r)[:12]
+
+    # Operations with itself
+    print sorted(s | s), sorted(s & s), sorted(s - s), sorted(s ^ s)
+    print sorted(s.union(s, s)), sorted(s.intersection(s)), sorted(s.difference(s)), sorted(s.symmetric_difference(s))
+
+    # Multiple arguments
+    print sorted(s.union([100], (101,), {102: 0}, frozenset([103])))
+    print sorted(s.difference([1], {2: 0}, set([3]), s))
+    print sorted(s.difference())
+
+# In-place versions
+for other in others:
+    s = set(small)
+    s.update(other())
+    print len(s),
+    s = set(small)
+    s.difference_update(other())
+    print sorted(s),
+    s = set(small)
+    s.intersection_update(other())
+    print sorted(s),
+    s = set(small)
+    s.symmetric_difference_update(other())
+    print len(s)
+
+s = set(range(1000))
+s -= set(range(0, 1000, 2))
+print len(s), sorted(s)[:5]
+s |= set(range(2000, 3000))
+print len(s), sorted(s)[-5:]
+s &= frozenset(range(500, 2500))
+print len(s), sorted(s)[:5], sorted(s)[-5:]
+s ^= set(range(0, 3000, 3))
+print len(s), sorted(s)[:5]
+s -= s
+print s
+s = set([1, 2])
+s ^= s
+print s
+
+# Elements that are equal but not identical: the result keeps the element from the set that got iterated
+class Key(object):
+    def __init__(self, n, tag):
+        self.n = n
+        self.tag = tag
+    def __hash__(self):
+        return hash(self.n)
+    def __eq__(self, rhs):
+        return self.n == rhs.n
+    def __repr__(self):
+        return "%s%d" % (self.tag, self.n)
+
+a = set([Key(i, 'a') for i in range(3)])
+b = set([Key(i, 'b') for i in range(2)])
+print sorted(map(repr, a & b)), sorted(map(repr, b & a))
+print sorted(map(repr, a | b)), sorted(map(repr, b | a))
+
+# Exceptions from __eq__ and __hash__ propagate
+class BadEq(object):
+    def __hash__(self):
+        return 0
+    def __eq__(self, rhs):
+        raise ValueError("eq")
+
+class BadHash(object):
+    def __hash__(self):
+        raise TypeError("hash")
+
+for f in (lambda: set([BadEq()]) & set([BadEq()]),
+          lambda: set([BadEq()]) - set([BadEq()]),
+          lambda: set([BadEq()]) | set([BadEq()]),
+          lambda: set([1]).difference([BadHash()]),
+          lambda: set([1]).union([BadHash()])):
+    try:
+        f()
+        print "no exception"
+    except Exception as e:
+        print type(e).__name__, e
@@ -0,0 +1,66 @@
+# Objects that come from per-class slabs (bound methods, slices, iterators, generators) behave
+# normally, and the slabs get returned once they are empty.
+try:
+    import __pyston__
+except ImportError:
+    __pyston__ = None
+
+class C(object):
+    def f(self):
+        return 1
+
+def gen(n):
+    for i in xrange(n):
+        yield i
+
+def slab_stats(name):
+    if __pyston__ is None:
+        return None
+    for t, slabs, objects, capacity, allocs, released in __pyston__.slabStats():
+        if t.__name__ == name:
+            return slabs, objects, capacity, released
+    return 0, 0, 0, 0
+
+c = C()
+l = range(10)
+held = []
+for i in xrange(20000):
+    held.append((c.f, slice(i % 10, i % 10 + 1), iter(l), reversed(l), iter(()), gen(2), iter(xrange(3))))
+
+print sum(m() for m, s, it, rit, tit, g, xit in held)
+print sum(l[s][0] for m, s, it, rit, tit, g, xit in held[:100])
+print sum(next(it) + next(rit) + next(g, 0) + next(xit) for m, s, it, rit, tit, g, xit in held[:100])
+
+if __pyston__:
+    slabs, objects, capacity, released = slab_stats("slice")
+    assert objects >= 20000 and capacity >= objects, (slabs, objects, capacity)
+    before_released = released
+
+del held
+
+if __pyston__:
+    slabs, objects, capacity, released = slab_stats("slice")
+    assert objects < 100, objects
+    assert slabs <= 2, slabs
+    assert released > before_released
+
+# Reuse after the slabs were released
+s = [slice(i) for i in xrange(5000)]
+print sum(x.stop for x in s)
+
+# Freeing the objects that live in recycled slabs, and cycling through several rounds of releasing
+# and reusing slabs
+del s
+for round in xrange(5):
+    objs = [(slice(i), c.f, iter(l)) for i in xrange(20000)]
+    assert sum(x.stop for x, m, it in objs) == 199990000
+    del objs[::2]
+    objs += [(slice(i), c.f, iter(l)) for i in xrange(10000)]
+    assert sum(m() + next(it) for x, m, it in objs) == 20000
+    del objs
+print "done"
+
+if __pyston__:
+    slabs, objects, capacity, released = slab_stats("slice")
+    assert objects < 100, objects
+    assert slabs <= 2, slabs
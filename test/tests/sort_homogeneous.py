@@ -0,0 +1,68 @@
+# Sorting lists whose keys are all ints, floats, strs or tuples of those, which take the
+# specialized comparison paths, plus lists that almost but don't quite qualify.
+
+import random
+random.seed(12345)
+
+def check(name, l, **kw):
+    s = sorted(l, **kw)
+    ok = True
+    for i in xrange(len(s) - 1):
+        a = s[i]
+        b = s[i + 1]
+        if 'key' in kw:
+            a = kw['key'](a)
+            b = kw['key'](b)
+        if kw.get('reverse'):
+            a, b = b, a
+        if b < a:
+            ok = False
+    print name, len(s), ok, s[:3]
+
+for n in (0, 1, 5, 100, 1023, 1024, 5000):
+    ints = [random.randint(-10**18, 10**18) for i in xrange(n)]
+    small_ints = [random.randint(0, 20) for i in xrange(n)]
+    floats = [random.random() - 0.5 for i in xrange(n)]
+    strs = [str(random.randint(0, 10**6)) + "\0" * (i % 2) for i in xrange(n)]
+    tuples = [(random.randint(0, 5), random.random()) for i in xrange(n)]
+    for name, l in (("ints", ints), ("small_ints", small_ints), ("floats", floats), ("strs", strs),
+                    ("tuples", tuples)):
+        check(name, l)
+        check(name + " reverse", l, reverse=True)
+        check(name + " key", l, key=lambda x: x)
+        check(name + " key reverse", l, key=lambda x: x, reverse=True)
+
+    # Mixed types fall back to the generic comparison
+    check("int+long", small_ints + [2 ** 70])
+    check("int+float", small_ints + [0.5])
+    check("empty tuple", [(i,) for i in small_ints] + [()])
+
+# Stability: equal keys keep their original order, with and without reverse
+l = [(random.randint(0, 10), i) for i in xrange(3000)]
+by_key = sorted(l, key=lambda t: t[0])
+print all(by_key[i][1] < by_key[i + 1][1] for i in xrange(len(l) - 1) if by_key[i][0] == by_key[i + 1][0])
+by_key = sorted(l, key=lambda t: t[0], reverse=True)
+print all(by_key[i][1] < by_key[i + 1][1] for i in xrange(len(l) - 1) if by_key[i][0] == by_key[i + 1][0])
+
+l = range(2000)
+random.shuffle(l)
+print sorted(l) == range(2000), sorted(l, reverse=True) == range(1999, -1, -1)
+print sorted(l, key=lambda x: -x) == range(1999, -1, -1)
+print sorted([-(2 ** 63), 2 ** 63 - 1, 0, -1] * 300)[::300]
+
+print sorted([3.0, float('inf'), -float('inf'), 0.0, -0.0, 1e-300])
+print sorted(["b", "a", "ab", "", "a\0", "\xff", "B"])
+print sorted([(1, "b"), (1, "a"), (0, "z"), (1,), (1, "a", 0)])
+print sorted([(2, 1), (1, 2), (1, 1.5), (1, 2, 3)], reverse=True)
+
+# Comparisons that raise still propagate
+class BadLt(object):
+    def __lt__(self, other):
+        raise ValueError("lt")
+    def __eq__(self, other):
+        return False
+
+try:
+    sorted([(1, BadLt()), (1, BadLt())])
+except ValueError as e:
+    print "ValueError", e
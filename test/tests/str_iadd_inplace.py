@@ -0,0 +1,109 @@
+# `s += piece` on a local str can append to the string in place when nothing else refers to it;
+# make sure that's never observable.
+
+def build(n):
+    s = ""
+    for i in xrange(n):
+        s += str(i % 10)
+    return s
+
+for n in (0, 1, 10, 1000, 100000):
+    s = build(n)
+    print n, len(s), s[:12], s[-5:], hash(s) == hash(str(s)), s == "".join(str(i % 10) for i in xrange(n))
+
+def aliases():
+    s = "x" * 3
+    copies = []
+    for i in xrange(5000):
+        s += "ab"
+        if i % 1000 == 0:
+            copies.append(s)
+            t = s
+            s += "!"
+            copies.append(t)
+        d = {s: i}
+    print len(s), [len(c) for c in copies], copies[1][-3:], copies[0][-3:], d.values()
+
+    s = "ab"
+    for i in xrange(5):
+        s += s
+    print s, len(s)
+
+    # The hash gets recomputed after the string changes
+    s = "a" * 100
+    for i in xrange(3000):
+        h = hash(s)
+        s += "b"
+        assert hash(s) != h
+    print hash(s) == hash("a" * 100 + "b" * 3000)
+
+    # Interned strings and constants are shared, so they must not be touched
+    for i in xrange(2000):
+        s = "const"
+        s += "ant"
+    print s, "const"
+    s = intern("interned_" + "value")
+    for i in xrange(3):
+        s += "!"
+    print s, intern("interned_value")
+aliases()
+
+def exceptions():
+    s = "abc"
+    for i in xrange(1000):
+        try:
+            s += 1
+        except TypeError as e:
+            pass
+        s += "d"
+    print len(s), s[:5], e
+
+    s = "x"
+    for i in xrange(1000):
+        try:
+            s += "y"
+            if i % 100 == 0:
+                raise ValueError(i)
+        except ValueError as e:
+            s += "z"
+    print len(s), s.count("z"), s[-5:]
+exceptions()
+
+def other_types():
+    l = []
+    u = u""
+    n = 0
+    b = bytearray()
+    s = "mixed"
+    for i in xrange(2000):
+        l += [i]
+        u += u"\u1234"
+        n += i
+        b += "b"
+    s += u"unicode"
+    print len(l), len(u), n, len(b), repr(s)
+other_types()
+
+class C(object):
+    pass
+
+def attrs_and_items():
+    c = C()
+    c.s = ""
+    d = {"k": ""}
+    l = [""]
+    for i in xrange(3000):
+        c.s += "a"
+        d["k"] += "b"
+        l[0] += "c"
+    print len(c.s), len(d["k"]), len(l[0])
+attrs_and_items()
+
+def closure():
+    s = ""
+    def f():
+        return s
+    for i in xrange(3000):
+        s += "q"
+    print len(f())
+closure()
@@ -0,0 +1,47 @@
+# str and bytearray searching, with the needle at every position around the block boundaries the
+# vectorized search kernels use, and all the edge cases of find/count/split/replace.
+
+for n in (0, 1, 15, 16, 17, 31, 32, 33, 63, 64, 65, 100):
+    hay = "".join(chr(ord('a') + (i * 7) % 26) for i in xrange(n))
+    results = []
+    for needle in ("z", "ab", "xyz", "abcdefghijklmnopq"):
+        for pos in range(0, n + 1, 3):
+            s = hay[:pos] + needle + hay[pos:]
+            results.append((s.find(needle), s.rfind(needle), s.index(needle), s.count(needle), needle in s,
+                            len(s.split(needle)), s.replace(needle, "!").find("!")))
+            b = bytearray(s)
+            results.append((b.find(needle), b.count(needle), len(b.split(needle))))
+    checksum = 0
+    for r in results:
+        for x in r:
+            checksum = (checksum * 31 + x) % 1000000007
+    print n, len(results), checksum
+
+s = "abcabcabc"
+for sub in ("", "a", "c", "abc", "bca", "cab", "abcabcabc", "abcabcabcd", "x", "abd"):
+    print repr(sub), s.find(sub), s.rfind(sub), s.count(sub), sub in s, s.find(sub, 2), s.find(sub, 2, 7),
+    print s.count(sub, 1, -1), s.split(sub) if sub else None, s.replace(sub, "-", 2)
+
+print "aaaa".count("aa"), "aaaaa".count("aa"), "aaaaa".replace("aa", "b"), "a\0b\0c".split("\0")
+print "\xff\x80\x00".find("\x80"), "\xff\x80\x00".count("\x00"), "\x80" in "abc\x80"
+print ("x" * 1000).count("x"), ("x" * 1000).count("xx"), ("x" * 1000 + "y").find("xy")
+print ("ab" * 50).count("b", 10, 90), ("ab" * 50).replace("b", "", 10).count("b")
+
+# Whitespace splitting: all the whitespace characters, long words and long runs of spaces
+ws = " \t\n\r\x0b\x0c"
+print "a b\tc\nd\re\x0bf\x0cg".split(), ("  word  " * 5).split(), "".split(), "   ".split()
+print ("x" * 40 + " " + "y" * 17 + "\t" * 20 + "z").split()
+print ("\x1f\x0e\x08 " * 5).split(), ("\x85\xa0 " * 3).split()
+print "a b c d e f".split(None, 2), " a b c ".split(None, 1), ("w " * 30).split(None, 20)[-1]
+print bytearray("a b  c").split(), bytearray("a,b,,c").split(",")
+
+# Single character separators
+print "a,b,,c,".split(","), ",".split(","), "abc".split(","), "a,b,c".split(",", 1), ("x," * 40).split(",")[-3:]
+line = "2016-05-04 12:34:56 INFO [worker-12] GET /api?id=1 200"
+print line.split(), line.split(" "), line.split(" ", 3), line.split("?"), line.split("200")
+
+print "abc".__contains__("bc"), "" in "", "" in "abc", "abcd" in "abc"
+try:
+    1 in "abc"
+except TypeError as e:
+    print e
@@ -0,0 +1,45 @@
+# Type attribute lookups that don't go through an IC are served from a global (type version, name) cache;
+# make sure that the cache gets invalidated whenever a type or one of its bases changes.
+import sys
+
+class A(object):
+    x = 1
+
+class B(A):
+    pass
+
+class C(B):
+    pass
+
+def lookup(cls, name):
+    # getattr with a non-constant name on a class avoids the attribute ICs
+    return getattr(cls, "".join(name))
+
+print lookup(C, "x")
+A.x = 2
+print lookup(C, "x")
+B.x = 3
+print lookup(C, "x"), lookup(A, "x")
+del B.x
+print lookup(C, "x")
+
+class D(object):
+    x = 4
+
+C.__bases__ = (D,)
+print lookup(C, "x")
+
+sys._clear_type_cache()
+print lookup(C, "x"), lookup(B, "x")
+
+names = ["attr%d" % i for i in xrange(200)]
+for i, n in enumerate(names):
+    setattr(A, n, i)
+t = 0
+for i in xrange(5):
+    for n in names:
+        t += lookup(B, n)
+    setattr(A, names[i], -1)
+print t
+
+print hasattr(C, "".join("nonexistent")), hasattr(B, "".join("attr0"))
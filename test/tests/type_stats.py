@@ -0,0 +1,66 @@
+# Per-type live object accounting: counts follow allocations and deallocations (including objects
+# that go through free lists), and __class__ assignment moves an object between types.
+try:
+    import __pyston__
+except ImportError:
+    __pyston__ = None
+
+class Small(object):
+    pass
+
+class Other(object):
+    pass
+
+class Holder(tuple):
+    pass
+
+def live(cls):
+    if __pyston__ is None:
+        return None
+    for t, count, nbytes in __pyston__.typeStats():
+        if t is cls:
+            return count, nbytes
+    return 0, 0
+
+def delta(before, after):
+    if before is None:
+        return None
+    return after[0] - before[0]
+
+before = live(Small)
+l = [Small() for i in xrange(1000)]
+after = live(Small)
+print delta(before, after) in (None, 1000)
+if __pyston__:
+    assert after[1] - before[1] == 1000 * Small.__basicsize__, (before, after)
+del l
+print live(Small) in (None, before)
+
+# Variable-sized objects count their items
+before = live(Holder)
+h = Holder(range(10))
+after = live(Holder)
+if __pyston__:
+    assert after[0] - before[0] == 1
+    assert after[1] - before[1] == Holder.__basicsize__ + 10 * Holder.__itemsize__, (before, after)
+del h
+print live(Holder) in (None, before)
+
+# floats go through a free list, but a freed float shouldn't count as live
+before = live(float)
+fl = [float(i) + 0.5 for i in xrange(500)]
+print delta(before, live(float)) in (None, 500)
+del fl
+print live(float) in (None, before)
+
+s = Small()
+before_small, before_other = live(Small), live(Other)
+s.__class__ = Other
+print delta(before_small, live(Small)) in (None, -1), delta(before_other, live(Other)) in (None, 1)
+del s
+print live(Other) in (None, before_other)
+
+if __pyston__:
+    stats = __pyston__.typeStats()
+    assert all(stats[i][2] >= stats[i + 1][2] for i in xrange(len(stats) - 1))
+    assert all(count > 0 for t, count, nbytes in stats)
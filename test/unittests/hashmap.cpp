@@ -0,0 +1,143 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <map>
+#include <random>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "core/from_llvm/DenseMap.h"
+#include "core/swiss_map.h"
+#include "unittests.h"
+
+using namespace pyston;
+
+// Checks SwissMap against std::map, and compares it with DenseMap on a few lookup/insert mixes.
+
+namespace {
+struct Key {
+    long pad[2];
+};
+
+template <typename Map> class Bench {
+public:
+    Map map;
+    double insert_ms = 0, hit_ms = 0, miss_ms = 0, mixed_ms = 0;
+
+    void run(const std::vector<Key*>& keys, const std::vector<Key*>& missing, int reps) {
+        typedef std::chrono::steady_clock clock;
+        auto ms = [](clock::time_point a, clock::time_point b) {
+            return std::chrono::duration<double, std::milli>(b - a).count();
+        };
+
+        auto t0 = clock::now();
+        for (int r = 0; r < reps; r++) {
+            map.clear();
+            for (size_t i = 0; i < keys.size(); i++)
+                map[keys[i]] = i;
+        }
+        auto t1 = clock::now();
+
+        long found = 0;
+        for (int r = 0; r < reps; r++) {
+            for (Key* k : keys)
+                found += map.count(k);
+        }
+        auto t2 = clock::now();
+        for (int r = 0; r < reps; r++) {
+            for (Key* k : missing)
+                found += map.count(k);
+        }
+        auto t3 = clock::now();
+
+        // Half hits, half misses, with some churn:
+        for (int r = 0; r < reps; r++) {
+            for (size_t i = 0; i < keys.size(); i++) {
+                if (i % 16 == 0) {
+                    map.erase(keys[i]);
+                    map[keys[i]] = i;
+                }
+                found += map.count((i & 1) ? keys[i] : missing[i]);
+            }
+        }
+        auto t4 = clock::now();
+
+        ASSERT_EQ(found, (long)reps * keys.size() * 3 / 2);
+        insert_ms = ms(t0, t1);
+        hit_ms = ms(t1, t2);
+        miss_ms = ms(t2, t3);
+        mixed_ms = ms(t3, t4);
+    }
+};
+}
+
+TEST(HashMap, swissMapMatchesStdMap) {
+    std::mt19937 rng(1);
+    for (int round = 0; round < 50; round++) {
+        SwissMap<long, long> m;
+        std::map<long, long> ref;
+        int range = 1 + rng() % 3000;
+        for (int i = 0; i < 5000; i++) {
+            long k = rng() % range;
+            int op = rng() % 10;
+            if (op < 5) {
+                m[k] = i;
+                ref[k] = i;
+            } else if (op < 8) {
+                ASSERT_EQ(m.erase(k), (bool)ref.erase(k));
+            } else if (op == 8) {
+                auto it = m.find(k);
+                ASSERT_EQ(it == m.end(), ref.count(k) == 0);
+                if (it != m.end()) {
+                    ASSERT_EQ(it->second, ref[k]);
+                    m.erase(it);
+                    ref.erase(k);
+                }
+            } else if (rng() % 100 == 0) {
+                m.clear();
+                ref.clear();
+            }
+            ASSERT_EQ(m.size(), ref.size());
+        }
+
+        std::map<long, long> contents;
+        for (auto&& p : m)
+            contents.insert(p);
+        ASSERT_EQ(contents, ref);
+
+        SwissMap<long, long> copy(m);
+        for (auto&& p : ref)
+            ASSERT_EQ(copy.lookup(p.first), p.second);
+    }
+}
+
+TEST(HashMap, compareWithDenseMap) {
+    std::mt19937 rng(2);
+    for (int n : { 8, 100, 10000, 1000000 }) {
+        std::vector<Key*> keys, missing;
+        for (int i = 0; i < n; i++) {
+            keys.push_back(new Key());
+            missing.push_back(new Key());
+        }
+        std::shuffle(keys.begin(), keys.end(), rng);
+        std::shuffle(missing.begin(), missing.end(), rng);
+
+        int reps = std::max(1, 10000000 / n);
+        Bench<DenseMap<Key*, long>> dense;
+        Bench<SwissMap<Key*, long>> swiss;
+        dense.run(keys, missing, reps);
+        swiss.run(keys, missing, reps);
+
+        printf("%8d keys (ms): %8s %8s %8s %8s\n", n, "insert", "hit", "miss", "mixed");
+        printf("    DenseMap:        %8.1f %8.1f %8.1f %8.1f\n", dense.insert_ms, dense.hit_ms, dense.miss_ms,
+               dense.mixed_ms);
+        printf("    SwissMap:        %8.1f %8.1f %8.1f %8.1f\n", swiss.insert_ms, swiss.hit_ms, swiss.miss_ms,
+               swiss.mixed_ms);
+
+        for (int i = 0; i < n; i++) {
+            delete keys[i];
+            delete missing[i];
+        }
+    }
+}
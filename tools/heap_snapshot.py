@@ -0,0 +1,248 @@
+# Analyzes a heap snapshot written by gc.dump_heap(): computes the dominator tree of the object
+# graph and prints the types and objects that retain the most memory, along with the dominator
+# path from a root to each of them (the chain of objects that, if freed, would free it).
+#
+# Usage: heap_snapshot.py snapshot.bin [-n 20] [--type NAME] [--path 0xADDR]
+#
+# The file format is described next to _PyGC_DumpHeap in from_cpython/Modules/gcmodule.c.
+
+import argparse
+import struct
+import sys
+
+ROOT_KINDS = {0: "module", 1: "frame", 2: "thread"}
+
+class Snapshot(object):
+    def __init__(self):
+        self.type_names = {}
+        self.roots = []  # (kind, id, name)
+        self.types = {}  # id -> type id
+        self.sizes = {}  # id -> shallow size
+        self.refs = {}  # id -> list of ids
+
+def read_snapshot(fn):
+    s = Snapshot()
+    f = open(fn, "rb")
+    magic = f.read(8)
+    if magic != b"PYHEAP01":
+        raise Exception("%s is not a heap snapshot" % fn)
+
+    def read(fmt):
+        return struct.unpack(fmt, f.read(struct.calcsize(fmt)))
+
+    def read_str():
+        n, = read("=I")
+        return f.read(n).decode("utf-8", "replace")
+
+    while True:
+        tag = f.read(1)
+        if tag == b"T":
+            tid, = read("=Q")
+            s.type_names[tid] = read_str()
+        elif tag == b"R":
+            kind, oid = read("=BQ")
+            s.roots.append((kind, oid, read_str()))
+        elif tag == b"O":
+            oid, tid, size, nrefs = read("=QQQI")
+            refs = list(read("=%dQ" % nrefs)) if nrefs else []
+            # Untracked objects can show up more than once
+            if oid not in s.types:
+                s.types[oid] = tid
+                s.sizes[oid] = size
+                s.refs[oid] = refs
+        elif tag == b"E":
+            break
+        else:
+            raise Exception("snapshot is truncated or corrupt (tag %r)" % tag)
+    return s
+
+class DominatorTree(object):
+    # Node 0 is a virtual root that points to every root in the snapshot, and to node 1, which
+    # stands for the objects that aren't reachable from any known root (objects only referenced
+    # from C code, or garbage that hasn't been collected yet).
+    def __init__(self, snapshot):
+        self.snapshot = snapshot
+        ids = list(snapshot.types)
+        self.ids = [None, None] + ids
+        index = dict((oid, i + 2) for i, oid in enumerate(ids))
+        n = len(self.ids)
+
+        succs = [[] for i in range(n)]
+        for oid, refs in snapshot.refs.items():
+            i = index[oid]
+            succs[i] = [index[r] for r in refs if r in index]
+        self.root_names = {}
+        for kind, oid, name in snapshot.roots:
+            if oid in index:
+                succs[0].append(index[oid])
+                self.root_names.setdefault(index[oid], "%s %s" % (ROOT_KINDS.get(kind, "?"), name))
+        succs[0].append(1)
+
+        order = self._postorder(succs, [0], [False] * n)
+        reached = set(order)
+        if len(reached) < n:
+            # Hang the unrooted objects off of node 1, preferring the ones nothing else refers to.
+            referenced = set()
+            for i in range(2, n):
+                if i not in reached:
+                    referenced.update(succs[i])
+            visited = [i in reached for i in range(n)]
+            starts = [i for i in range(2, n) if not visited[i] and i not in referenced]
+            starts += [i for i in range(2, n) if not visited[i] and i in referenced]
+            succs[1] = starts
+            visited[1] = False
+            unrooted = self._postorder(succs, [1], visited)
+            order = [i for i in order if i > 1] + unrooted + [0]
+
+        self.size = [0, 0] + [snapshot.sizes[oid] for oid in ids]
+        self.idom = self._dominators(succs, order)
+
+        self.retained = list(self.size)
+        for i in order:
+            if i != 0:
+                self.retained[self.idom[i]] += self.retained[i]
+
+    @staticmethod
+    def _postorder(succs, starts, visited):
+        order = []
+        for start in starts:
+            if visited[start]:
+                continue
+            visited[start] = True
+            stack = [(start, iter(succs[start]))]
+            while stack:
+                node, it = stack[-1]
+                for s in it:
+                    if not visited[s]:
+                        visited[s] = True
+                        stack.append((s, iter(succs[s])))
+                        break
+                else:
+                    stack.pop()
+                    order.append(node)
+        return order
+
+    @staticmethod
+    def _dominators(succs, postorder):
+        # Cooper, Harvey and Kennedy, "A Simple, Fast Dominance Algorithm"
+        n = len(succs)
+        po_num = [-1] * n
+        for i, node in enumerate(postorder):
+            po_num[node] = i
+        preds = [[] for i in range(n)]
+        for node in postorder:
+            for s in succs[node]:
+                preds[s].append(node)
+
+        idom = [None] * n
+        idom[0] = 0
+        rpo = postorder[::-1]
+        changed = True
+        while changed:
+            changed = False
+            for node in rpo[1:]:
+                new_idom = None
+                for p in preds[node]:
+                    if idom[p] is None:
+                        continue
+                    if new_idom is None:
+                        new_idom = p
+                        continue
+                    a, b = p, new_idom
+                    while a != b:
+                        while po_num[a] < po_num[b]:
+                            a = idom[a]
+                        while po_num[b] < po_num[a]:
+                            b = idom[b]
+                    new_idom = a
+                if idom[node] != new_idom:
+                    idom[node] = new_idom
+                    changed = True
+        return idom
+
+    def describe(self, i):
+        if i == 0:
+            return "<roots>"
+        if i == 1:
+            return "<not reachable from known roots>"
+        oid = self.ids[i]
+        name = self.snapshot.type_names.get(self.snapshot.types[oid], "?")
+        desc = "%s at %#x (%s retained)" % (name, oid, fmt_size(self.retained[i]))
+        if i in self.root_names:
+            desc += " [%s]" % self.root_names[i]
+        return desc
+
+    def path(self, i):
+        path = []
+        while i != 0:
+            path.append(i)
+            i = self.idom[i]
+        return path[::-1]
+
+def fmt_size(n):
+    if n < 1024:
+        return "%dB" % n
+    for unit in ("kB", "MB"):
+        n /= 1024.0
+        if n < 1024:
+            return "%.1f%s" % (n, unit)
+    return "%.1fGB" % (n / 1024.0)
+
+def print_path(tree, i):
+    if i == 0:
+        print("    %s" % tree.describe(0))
+    for depth, node in enumerate(tree.path(i)):
+        print("    %s%s" % ("  " * depth, tree.describe(node)))
+
+def main():
+    parser = argparse.ArgumentParser()
+    parser.add_argument("snapshot")
+    parser.add_argument("-n", type=int, default=20, help="number of types and objects to show")
+    parser.add_argument("--type", help="only show objects of this type")
+    parser.add_argument("--path", help="show the dominator path to the object at this address")
+    args = parser.parse_args()
+
+    snapshot = read_snapshot(args.snapshot)
+    tree = DominatorTree(snapshot)
+    nodes = range(2, len(tree.ids))
+
+    if args.path:
+        oid = int(args.path, 16)
+        if oid not in snapshot.types:
+            print("%#x is not in the snapshot" % oid)
+            sys.exit(1)
+        print_path(tree, tree.ids.index(oid))
+        return
+
+    total = sum(tree.size)
+    print("%d objects, %s; %s not reachable from known roots" % (len(nodes), fmt_size(total),
+                                                                  fmt_size(tree.retained[1])))
+
+    by_type = {}
+    for i in nodes:
+        name = snapshot.type_names.get(snapshot.types[tree.ids[i]], "?")
+        count, shallow, retained = by_type.get(name, (0, 0, 0))
+        # Only count what isn't already retained by another object of the same type
+        d = tree.idom[i]
+        if d < 2 or snapshot.type_names.get(snapshot.types[tree.ids[d]], "?") != name:
+            retained += tree.retained[i]
+        by_type[name] = (count + 1, shallow + tree.size[i], retained)
+
+    print("")
+    print("%10s %10s %10s  %s" % ("count", "shallow", "retained", "type"))
+    for name, (count, shallow, retained) in sorted(by_type.items(), key=lambda x: -x[1][2])[:args.n]:
+        print("%10d %10s %10s  %s" % (count, fmt_size(shallow), fmt_size(retained), name))
+
+    candidates = list(nodes)
+    if args.type:
+        candidates = [i for i in candidates
+                      if snapshot.type_names.get(snapshot.types[tree.ids[i]]) == args.type]
+    candidates.sort(key=lambda i: -tree.retained[i])
+    print("")
+    print("Largest objects by retained size, with their dominator paths:")
+    for i in candidates[:args.n]:
+        print("  %s" % tree.describe(i))
+        print_path(tree, tree.idom[i])
+
+if __name__ == "__main__":
+    main()